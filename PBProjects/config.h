@@ -46,6 +46,9 @@
 /* Define to 1 if you have the <memory.h> header file. */
 #define HAVE_MEMORY_H 1
 
+/* Define to 1 if you have the `mmap' function. */
+#define HAVE_MMAP 1
+
 /* ${desc_miniupnpc} enabled */
 #define HAVE_MINIUPNPC 1
 
@@ -106,6 +109,9 @@
 /* Define to 1 if you have the `sysctlbyname' function. */
 #define HAVE_SYSCTLBYNAME 1
 
+/* Define to 1 if you have the <sys/mman.h> header file. */
+#define HAVE_SYS_MMAN_H 1
+
 /* Define to 1 if you have the <sys/stat.h> header file. */
 #define HAVE_SYS_STAT_H 1
 
@@ -26,6 +26,8 @@
 #define MACHINE_TICKS_PER_SECOND 1000
 
 extern uint32 machine_tick_count(void);
+// finer grained clock for profiling; same epoch as machine_tick_count()
+extern uint64_t machine_microsecond_count(void);
 extern void sleep_for_machine_ticks(uint32 ticks);
 extern void sleep_until_machine_tick_count(uint32 ticks);
 extern void yield(void);
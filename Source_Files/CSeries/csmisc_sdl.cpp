@@ -55,6 +55,16 @@ uint32 machine_tick_count(void)
     (now - epoch).count()/TIME_SKEW;
 }
 
+/*
+ *  Return microsecond counter (not skewed; only used to measure how long things take)
+ */
+
+uint64_t machine_microsecond_count(void)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>
+    (std::chrono::high_resolution_clock::now() - epoch).count();
+}
+
 /*
  *  Delay a certain number of ticks
  */
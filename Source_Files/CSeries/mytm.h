@@ -52,6 +52,9 @@ extern void myTMCleanup(bool waitForFinishers);
 extern bool take_mytm_mutex();
 extern bool release_mytm_mutex();
 
+// Takes the mutex only if nobody holds it; returns whether it was taken (never blocks)
+extern bool try_take_mytm_mutex();
+
 // ghs: exception-safe version of above
 class MyTMMutexTaker
 {
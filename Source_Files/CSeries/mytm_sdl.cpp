@@ -28,6 +28,9 @@
  *
  *  14 January 2003 (Woody Zenfell): TMTasks lock each other out while running (better models
  *      Time Manager behavior, so makes code safer).  Also removed missedDeadline stuff.
+ *
+ *  Oct 16, 2026: try_take_mytm_mutex(), so the packet listening thread can hand off packets
+ *      without waiting on a running TMTask.
  */
 
 // The implementation is built on SDL_thread, and approximates the Time Manager behavior.
@@ -114,6 +117,14 @@ take_mytm_mutex() {
 
 
 
+// Doesn't complain when the mutex is busy; the caller is expected to try again later.
+bool
+try_take_mytm_mutex() {
+    return (SDL_TryLockMutex(sTMTaskMutex) == 0);
+}
+
+
+
 bool
 release_mytm_mutex() {
     bool success = (SDL_UnlockMutex(sTMTaskMutex) != -1);
@@ -56,6 +56,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 #ifdef HAVE_ZZIP
 #include <zzip/lib.h>
 #include "SDL_rwops_zzip.h"
@@ -258,6 +262,67 @@ std::streampos opened_file_device::seek(io::stream_offset off, std::ios_base::se
 	return pos - static_cast<std::streampos>(f.fork_offset);
 }
 
+/*
+ *  Mapped file
+ */
+
+MappedFile::MappedFile() : base(NULL), base_length(0), data(NULL), length(0) {}
+
+bool MappedFile::Map(FileSpecifier& File)
+{
+	Unmap();
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+	// Let Open() find the data fork of AppleSingle and MacBinary files
+	int32 fork_offset, fork_length;
+	{
+		OpenedFile OFile;
+		if (!File.Open(OFile) || !OFile.GetLength(fork_length))
+			return false;
+		fork_offset = OFile.fork_offset;
+	}
+
+	// Fails for files inside archives, which have no descriptor of their own
+	int fd = open(File.GetPath(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || fork_length <= 0 ||
+		static_cast<off_t>(fork_offset) + fork_length > st.st_size)
+	{
+		close(fd);
+		return false;
+	}
+
+	void *mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	base = mapping;
+	base_length = st.st_size;
+	data = static_cast<const uint8 *>(mapping) + fork_offset;
+	length = fork_length;
+	return true;
+#else
+	(void) File;
+	return false;
+#endif
+}
+
+void MappedFile::Unmap()
+{
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+	if (base)
+		munmap(base, base_length);
+#endif
+	base = NULL;
+	base_length = 0;
+	data = NULL;
+	length = 0;
+}
+
 /*
  *  Loaded resource
  */
@@ -531,6 +596,14 @@ TimeType FileSpecifier::GetDate()
 	return err == 0 ? mtime : 0;
 }
 
+int64_t FileSpecifier::GetSize()
+{
+	sys::error_code ec;
+	const auto size = fs::file_size(utf8_to_path(name), ec);
+	err = to_posix_code_or_unknown(ec);
+	return err == 0 ? static_cast<int64_t>(size) : -1;
+}
+
 static const char * alephone_extensions[] = {
 	".sceA",
 	".sgaA",
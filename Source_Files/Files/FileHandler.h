@@ -45,6 +45,10 @@ Jan 25, 2002 (Br'fin (Jeremy Parsons)):
 
 March 18, 2002 (Br'fin (Jeremy Parsons)):
 	Added FileSpecifier::SetParentToResources for Carbon
+
+Oct 16, 2026:
+	Added MappedFile, for reading a file's data fork in place,
+	and FileSpecifier::GetSize()
 */
 
 // For the filetypes
@@ -68,6 +72,8 @@ using std::vector;
 // Returned by .GetError() for unknown errors
 constexpr int unknown_filesystem_error = -1;
 
+class FileSpecifier;
+
 /*
 	Abstraction for opened files; it does reading, writing, and closing of such files,
 	without doing anything to the files' specifications
@@ -77,6 +83,7 @@ class OpenedFile
 	// This class will need to set the refnum and error value appropriately 
 	friend class FileSpecifier;
 	friend class opened_file_device;
+	friend class MappedFile;
 	
 public:
 	bool IsOpen();
@@ -119,6 +126,37 @@ private:
 	OpenedFile& f;
 };
 
+/*
+	Read-only view of a file's data fork as one block of memory,
+	mapped where the platform has mmap(); Map() fails on other platforms
+	and for files inside archives, so callers keep a reading fallback.
+	The file must not be truncated while it is mapped.
+*/
+class MappedFile
+{
+public:
+	bool Map(FileSpecifier& File);
+	void Unmap();
+	
+	bool IsMapped() const {return data != NULL;}
+	
+	// With any AppleSingle or MacBinary wrapping skipped, like OpenedFile
+	const uint8 *GetData() const {return data;}
+	int32 GetLength() const {return length;}
+	
+	MappedFile();
+	~MappedFile() {Unmap();}
+	
+private:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	
+	void *base;		// Whole-file mapping
+	size_t base_length;
+	const uint8 *data;
+	int32 length;
+};
+
 /*
 	Abstraction for loaded resources;
 	this object will release that resource when it finishes.
@@ -287,6 +325,9 @@ public:
 	// Gets the modification date
 	TimeType GetDate();
 	
+	// Gets the size in bytes, or -1 if that fails
+	int64_t GetSize();
+	
 	// Returns _typecode_unknown if the type could not be identified;
 	// the types returned are the _typecode_stuff in tags.h
 	Typecode GetType();
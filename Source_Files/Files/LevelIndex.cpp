@@ -0,0 +1,244 @@
+/*
+ *  LevelIndex.cpp - a persistent index of the levels in map files
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ */
+
+#include "LevelIndex.h"
+
+#include "editor.h"
+#include "InfoTree.h"
+#include "Logging.h"
+#include "tags.h"
+#include "wad.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+// bump this whenever the entries, or how they are read from maps, change
+static const int16 LEVEL_INDEX_VERSION = 1;
+
+LevelIndex* LevelIndex::instance() {
+	static LevelIndex *m_instance = nullptr;
+	if (!m_instance) {
+		m_instance = new LevelIndex;
+	}
+
+	return m_instance;
+}
+
+const std::vector<level_index_entry> *LevelIndex::levels(FileSpecifier& map_file)
+{
+	// cheap, since wad headers are cached
+	uint32 checksum = read_wad_file_checksum(map_file);
+	std::string path = checksum ? std::string() : map_file.GetPath();
+	TimeType date = checksum ? 0 : map_file.GetDate();
+
+	if (m_valid && checksum == m_checksum && path == m_path && date == m_date)
+		return &m_levels;
+
+	m_valid = false;
+	m_checksum = checksum;
+	m_path = path;
+	m_date = date;
+
+	// without a checksum, there's nothing to tell versions of the map apart
+	if (checksum && load(checksum, m_levels))
+	{
+		m_valid = true;
+		return &m_levels;
+	}
+
+	if (!build(map_file, m_levels))
+		return NULL;
+
+	if (checksum)
+		save(checksum, m_levels);
+
+	m_valid = true;
+	return &m_levels;
+}
+
+FileSpecifier LevelIndex::file_for_checksum(uint32 checksum)
+{
+	char name[16];
+	snprintf(name, sizeof(name), "%08x.xml", checksum);
+
+	FileSpecifier file;
+	file.SetToLocalDataDir();
+	file.AddPart("Level Index");
+	file.AddPart(name);
+	return file;
+}
+
+bool LevelIndex::build(FileSpecifier& map_file, std::vector<level_index_entry>& levels)
+{
+	wad_header header;
+	if (!read_wad_header(map_file, &header))
+		return false;
+
+	// new style wads have names and flags in the directory
+	void *total_directory_data = NULL;
+	if (header.application_specific_directory_data_size == SIZEOF_directory_data)
+	{
+		total_directory_data = read_directory_data(map_file, &header);
+		if (!total_directory_data)
+			return false;
+	}
+
+	levels.clear();
+	for (int16 index = 0; index < header.wad_count; ++index)
+	{
+		level_index_entry level;
+		obj_clear(level);
+		level.level_number = index;
+
+		if (total_directory_data)
+		{
+			directory_data directory;
+			unpack_directory_data((uint8 *)get_indexed_directory_data(&header, index, total_directory_data), &directory, 1);
+
+			level.entry_point_flags = directory.entry_point_flags;
+			level.mission_flags = directory.mission_flags;
+			level.environment_flags = directory.environment_flags;
+			memcpy(level.level_name, directory.level_name, LEVEL_NAME_LENGTH);
+		}
+		else if (wad_data *wad = read_indexed_wad_from_file(map_file, &header, index))
+		{
+			// Pfhorte writes this two bytes short
+			size_t length;
+			uint8 *p = (uint8 *)extract_type_from_wad(wad, MAP_INFO_TAG, &length);
+			uint8 buffer[SIZEOF_static_data];
+			memset(buffer, 0, sizeof(buffer));
+			if (p)
+				memcpy(buffer, p, std::min<size_t>(length, SIZEOF_static_data));
+
+			static_data map_info;
+			unpack_static_data(buffer, &map_info, 1);
+
+			// single-player Marathon 1 levels aren't always marked
+			if (header.data_version == MARATHON_ONE_DATA_VERSION &&
+			    map_info.entry_point_flags == 0)
+				map_info.entry_point_flags = _single_player_entry_point;
+
+			// Marathon 1 handled (then-unused) coop flag differently
+			if (header.data_version == MARATHON_ONE_DATA_VERSION)
+			{
+				if (map_info.entry_point_flags & _single_player_entry_point)
+					map_info.entry_point_flags |= _multiplayer_cooperative_entry_point;
+				if (map_info.entry_point_flags & _multiplayer_carnage_entry_point)
+					map_info.entry_point_flags &= ~_multiplayer_cooperative_entry_point;
+			}
+
+			level.entry_point_flags = map_info.entry_point_flags;
+			level.mission_flags = map_info.mission_flags;
+			level.environment_flags = map_info.environment_flags;
+			memcpy(level.level_name, map_info.level_name, LEVEL_NAME_LENGTH);
+
+			free_wad(wad);
+		}
+		level.level_name[LEVEL_NAME_LENGTH - 1] = '\0';
+
+		// unreadable levels keep their place, with no entry points
+		levels.push_back(level);
+	}
+
+	free(total_directory_data);
+	return true;
+}
+
+bool LevelIndex::load(uint32 checksum, std::vector<level_index_entry>& levels)
+{
+	FileSpecifier file = file_for_checksum(checksum);
+	if (!file.Exists())
+		return false;
+
+	InfoTree root;
+	try {
+		root = InfoTree::load_xml(file).get_child("level_index");
+	} catch (const InfoTree::parse_error& e) {
+		logWarning("Could not read level index %s (%s)", file.GetPath(), e.what());
+		return false;
+	} catch (const InfoTree::unexpected_error& e) {
+		logWarning("Could not read level index %s (%s)", file.GetPath(), e.what());
+		return false;
+	}
+
+	int16 version = 0;
+	uint32 stored_checksum = 0;
+	if (!root.read_attr("version", version) || version != LEVEL_INDEX_VERSION ||
+		!root.read_attr("checksum", stored_checksum) || stored_checksum != checksum)
+		return false;
+
+	levels.clear();
+	for (const InfoTree &child : root.children_named("level"))
+	{
+		level_index_entry level;
+		obj_clear(level);
+
+		if (!child.read_attr("index", level.level_number) ||
+			level.level_number != static_cast<int16>(levels.size()))
+			return false;
+
+		child.read_cstr("name", level.level_name, LEVEL_NAME_LENGTH - 1);
+		child.read_attr("entry_point_flags", level.entry_point_flags);
+		child.read_attr("mission_flags", level.mission_flags);
+		child.read_attr("environment_flags", level.environment_flags);
+
+		levels.push_back(level);
+	}
+
+	return !levels.empty();
+}
+
+void LevelIndex::save(uint32 checksum, const std::vector<level_index_entry>& levels)
+{
+	FileSpecifier dir;
+	dir.SetToLocalDataDir();
+	dir.AddPart("Level Index");
+	dir.CreateDirectory();
+	if (!dir.IsDir())
+		return;
+
+	InfoTree root;
+	root.put_attr("version", LEVEL_INDEX_VERSION);
+	root.put_attr("checksum", checksum);
+
+	for (const level_index_entry& level : levels)
+	{
+		InfoTree child;
+		child.put_attr("index", level.level_number);
+		child.put_attr_cstr("name", level.level_name);
+		child.put_attr("entry_point_flags", level.entry_point_flags);
+		child.put_attr("mission_flags", level.mission_flags);
+		child.put_attr("environment_flags", level.environment_flags);
+		root.add_child("level", child);
+	}
+
+	InfoTree fileroot;
+	fileroot.put_child("level_index", root);
+
+	FileSpecifier file = file_for_checksum(checksum);
+	try {
+		fileroot.save_xml(file);
+	} catch (const InfoTree::parse_error& e) {
+		logWarning("Could not save level index %s (%s)", file.GetPath(), e.what());
+	} catch (const InfoTree::unexpected_error& e) {
+		logWarning("Could not save level index %s (%s)", file.GetPath(), e.what());
+	}
+}
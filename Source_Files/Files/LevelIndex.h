@@ -0,0 +1,69 @@
+/*
+ *  LevelIndex.h - a persistent index of the levels in map files
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ */
+
+#ifndef LEVEL_INDEX_H
+#define LEVEL_INDEX_H
+
+#include "cseries.h"
+#include "FileHandler.h"
+#include "map.h"
+
+#include <string>
+#include <vector>
+
+struct level_index_entry {
+	int16 level_number;
+	char level_name[LEVEL_NAME_LENGTH];
+	int32 entry_point_flags;	// with the Marathon 1 fixups applied
+	int16 mission_flags;		// as stored in the map
+	int16 environment_flags;	// as stored in the map
+};
+
+// What the level lists need to know about every level of a map file; built
+// once per version of the map (by its checksum) and kept in the local data
+// directory, so big map packs aren't read level by level each time a level
+// list is shown
+class LevelIndex {
+public:
+	static LevelIndex* instance();
+
+	// The map file's levels in order, loading or building the index as
+	// needed; NULL if the map can't be read
+	const std::vector<level_index_entry> *levels(FileSpecifier& map_file);
+
+private:
+	LevelIndex() : m_checksum(0), m_date(0), m_valid(false) { }
+
+	static FileSpecifier file_for_checksum(uint32 checksum);
+	static bool build(FileSpecifier& map_file, std::vector<level_index_entry>& levels);
+	static bool load(uint32 checksum, std::vector<level_index_entry>& levels);
+	static void save(uint32 checksum, const std::vector<level_index_entry>& levels);
+
+	// The index of the most recently asked for map; one without a checksum
+	// isn't saved, and is known by its path and modification date instead
+	uint32 m_checksum;
+	std::string m_path;
+	TimeType m_date;
+	bool m_valid;
+	std::vector<level_index_entry> m_levels;
+};
+
+#endif
@@ -77,6 +77,11 @@ Nov 26, 2000 (Loren Petrich):
 Feb 15, 2002 (Br'fin (Jeremy Parsons)):
 	Additional save data is now applied to the Temporary file instead of the original
 	(Old level preview info is now saved under Macintosh again)
+
+Oct 16, 2026:
+	Level loading and entry-point listing use the cached wad header and directory,
+	and read levels in place from a mapping of the map file where possible
+	Entry points now come from the level index
 */
 
 // This needs to do the right thing on save game, which is storing the precalculated crap.
@@ -101,6 +106,7 @@ Feb 15, 2002 (Br'fin (Jeremy Parsons)):
 #include "shell.h"
 #include "preferences.h"
 #include "FileHandler.h"
+#include "LevelIndex.h"
 
 #include "editor.h"
 #include "tags.h"
@@ -184,7 +190,6 @@ static void complete_loading_level(short *_map_indexes, size_t map_index_count,
 	uint8 *_platform_data, size_t platform_data_count,
 	uint8 *actual_platform_data, size_t actual_platform_data_count, short version);
 
-static uint8 *unpack_directory_data(uint8 *Stream, directory_data *Objects, size_t Count);
 //static uint8 *pack_directory_data(uint8 *Stream, directory_data *Objects, int Count);
 
 /* ------------------------ Net functions */
@@ -272,23 +277,17 @@ bool use_map_file(
 
 dynamic_data get_dynamic_data_from_save(FileSpecifier& File)
 {
-	OpenedFile MapFile;
 	dynamic_data dynamic_data_return;
 
-	if (open_wad_file_for_reading(File, MapFile))
+	wad_header header;
+	if (read_wad_header(File, &header))
 	{
-		wad_header header;
-		if (read_wad_header(MapFile, &header))
+		auto wad = read_indexed_wad_from_file(File, &header, 0);
+		if (wad)
 		{
-			auto wad = read_indexed_wad_from_file(MapFile, &header, 0, true);
-			if (wad)
-			{
-				get_dynamic_data_from_wad(wad, &dynamic_data_return);
-				free_wad(wad);
-			}
+			get_dynamic_data_from_wad(wad, &dynamic_data_return);
+			free_wad(wad);
 		}
-
-		close_wad_file(MapFile);
 	}
 
 	return dynamic_data_return;
@@ -297,7 +296,6 @@ dynamic_data get_dynamic_data_from_save(FileSpecifier& File)
 bool load_level_from_map(
 	short level_index)
 {
-	OpenedFile OFile;
 	struct wad_header header;
 	struct wad_data *wad;
 	short index_to_load;
@@ -314,37 +312,27 @@ bool load_level_from_map(
 			index_to_load= level_index;
 		}
 		
-		OpenedFile MapFile;
-		if (open_wad_file_for_reading(MapFileSpec,MapFile))
+		/* Read the file (the header is cached, and the level mapped in place if possible) */
+		if(read_wad_header(MapFileSpec, &header))
 		{
-			/* Read the file */
-			if(read_wad_header(MapFile, &header))
+			if(index_to_load>=0 && index_to_load<header.wad_count)
 			{
-				if(index_to_load>=0 && index_to_load<header.wad_count)
+				wad= read_indexed_wad_from_file(MapFileSpec, &header, index_to_load);
+				if (wad)
 				{
-                        
-					wad= read_indexed_wad_from_file(MapFile, &header, index_to_load, true);
-					if (wad)
-					{
-						/* Process everything... */
-						process_map_wad(wad, restoring_game, header.data_version);
-		
-						/* Nuke our memory... */
-						free_wad(wad);
-					} else {
-						// error code has been set...
-					}
+					/* Process everything... */
+					process_map_wad(wad, restoring_game, header.data_version);
+	
+					/* Nuke our memory... */
+					free_wad(wad);
 				} else {
-					set_game_error(gameError, errWadIndexOutOfRange);
+					// error code has been set...
 				}
 			} else {
-				// error code has been set...
+				set_game_error(gameError, errWadIndexOutOfRange);
 			}
-		
-			/* Close the file.. */
-			close_wad_file(MapFile);
 		} else {
-			// error code has been set..
+			// error code has been set...
 		}
 	} else {
 		set_game_error(gameError, errMapFileNotSet);
@@ -408,6 +396,12 @@ void complete_loading_level(
 			}
 		}
 	}
+
+	/* pathfinding and activation floods walk this instead of the polygon and line lists */
+	build_polygon_adjacency_graph();
+	
+	/* and range queries walk this instead of every monster */
+	build_polygon_grid();
 }
 
 /* Call with location of NULL to get the number of start locations for a */
@@ -458,15 +452,10 @@ uint32 get_current_map_checksum(
 	struct wad_header header;
 
 	assert(file_is_set);
-	OpenedFile MapFile;
-	open_wad_file_for_reading(MapFileSpec, MapFile);
-	assert(MapFile.IsOpen());
 
 	/* Read the file */
-	read_wad_header(MapFile, &header);
-	
-	/* Close the file.. */
-	close_wad_file(MapFile);	
+	if(!read_wad_header(MapFileSpec, &header))
+		return 0;
 	
 	return header.checksum;
 }
@@ -568,92 +557,27 @@ bool get_indexed_entry_point(
 {
 	short actual_index;
 	
-	// Open map file
+	// The level index keeps names and flags, so this doesn't read the map
 	assert(file_is_set);
-	OpenedFile MapFile;
-	if (!open_wad_file_for_reading(MapFileSpec,MapFile))
+	const std::vector<level_index_entry> *levels= LevelIndex::instance()->levels(MapFileSpec);
+	if (!levels)
 		return false;
 
-	// Read header
-	wad_header header;
-	if (!read_wad_header(MapFile, &header)) {
-		close_wad_file(MapFile);
-		return false;
-	}
-    
 	bool success = false;
-	if (header.application_specific_directory_data_size == SIZEOF_directory_data)
+	for(actual_index= *index; actual_index<static_cast<short>(levels->size()); ++actual_index)
 	{
+		const level_index_entry& level= (*levels)[actual_index];
 
-		// New style wad
-		void *total_directory_data= read_directory_data(MapFile, &header);
-
-		assert(total_directory_data);
-		for(actual_index= *index; actual_index<header.wad_count; ++actual_index)
+		/* Find the flags that match.. */
+		if(level.entry_point_flags & type)
 		{
-			uint8 *p = (uint8 *)get_indexed_directory_data(&header, actual_index, total_directory_data);
-			directory_data directory;
-			unpack_directory_data(p, &directory, 1);
-
-			/* Find the flags that match.. */
-			if(directory.entry_point_flags & type)
-			{
-				/* This one is valid! */
-				entry_point->level_number= actual_index;
-				strncpy(entry_point->level_name, directory.level_name, 66);
-			
-				*index= actual_index+1;
-				success= true;
-				break; /* Out of the for loop */
-			}
-		}
-		free(total_directory_data);
-
-	} else {
-
-		// Old style wad, find the index
-		for(actual_index= *index; !success && actual_index<header.wad_count; ++actual_index)
-		{
-			struct wad_data *wad;
-
-			/* Read the file */
-			wad= read_indexed_wad_from_file(MapFile, &header, actual_index, true);
-			if (wad)
-			{
-				/* IF this has the proper type.. */
-				size_t length;
-				uint8 *p = (uint8 *)extract_type_from_wad(wad, MAP_INFO_TAG, &length);
-				assert(length == SIZEOF_static_data);
-				static_data map_info;
-				unpack_static_data(p, &map_info, 1);
-
-				// single-player Marathon 1 levels aren't always marked
-				if (header.data_version == MARATHON_ONE_DATA_VERSION &&
-				    map_info.entry_point_flags == 0)
-					map_info.entry_point_flags = _single_player_entry_point;
-
-				// Marathon 1 handled (then-unused) coop flag differently
-				if (header.data_version == MARATHON_ONE_DATA_VERSION)
-				{
-					if (map_info.entry_point_flags & _single_player_entry_point)
-						map_info.entry_point_flags |= _multiplayer_cooperative_entry_point;
-					if (map_info.entry_point_flags & _multiplayer_carnage_entry_point)
-						map_info.entry_point_flags &= ~_multiplayer_cooperative_entry_point;
-				}
-
-				if(map_info.entry_point_flags & type)
-				{
-					/* This one is valid! */
-					entry_point->level_number= actual_index;
-					assert(strlen(map_info.level_name)<LEVEL_NAME_LENGTH);
-					strncpy(entry_point->level_name, map_info.level_name, 66);
+			/* This one is valid! */
+			entry_point->level_number= actual_index;
+			strncpy(entry_point->level_name, level.level_name, 66);
 		
-					*index= actual_index+1;
-					success= true;
-				}
-				
-				free_wad(wad);
-			}
+			*index= actual_index+1;
+			success= true;
+			break; /* Out of the for loop */
 		}
 	}
 
@@ -665,86 +589,23 @@ bool get_entry_points(vector<entry_point> &vec, int32 type)
 {
 	vec.clear();
 
-	// Open map file
+	// The level index keeps names and flags, so this doesn't read the map
 	assert(file_is_set);
-	OpenedFile MapFile;
-	if (!open_wad_file_for_reading(MapFileSpec,MapFile))
+	const std::vector<level_index_entry> *levels = LevelIndex::instance()->levels(MapFileSpec);
+	if (!levels)
 		return false;
 
-	// Read header
-	wad_header header;
-	if (!read_wad_header(MapFile, &header)) {
-		close_wad_file(MapFile);
-		return false;
-	}
-
+	// Push matching levels into vector
 	bool success = false;
-	if (header.application_specific_directory_data_size == SIZEOF_directory_data) {
-
-		// New style wad, read directory data
-		void *total_directory_data = read_directory_data(MapFile, &header);
-		assert(total_directory_data);
-
-		// Push matching directory entries into vector
-		for (int i=0; i<header.wad_count; i++) {
-			uint8 *p = (uint8 *)get_indexed_directory_data(&header, i, total_directory_data);
-			directory_data directory;
-			unpack_directory_data(p, &directory, 1);
-
-			if (directory.entry_point_flags & type) {
-
-				// This one is valid
-				entry_point point;
-				point.level_number = i;
-				strncpy(point.level_name, directory.level_name, 66);
-				vec.push_back(point);
-				success = true;
-			}
-		}
-		free(total_directory_data);
-
-	} else {
-
-		// Old style wad
-		for (int i=0; i<header.wad_count; i++) {
-
-			wad_data *wad = read_indexed_wad_from_file(MapFile, &header, i, true);
-			if (!wad)
-				continue;
-
-			// Read map_info data
-			size_t length;
-			uint8 *p = (uint8 *)extract_type_from_wad(wad, MAP_INFO_TAG, &length);
-			assert(length == SIZEOF_static_data);
-			static_data map_info;
-			unpack_static_data(p, &map_info, 1);
-
-			// single-player Marathon 1 levels aren't always marked
-			if (header.data_version == MARATHON_ONE_DATA_VERSION &&
-			    map_info.entry_point_flags == 0)
-				map_info.entry_point_flags = _single_player_entry_point;
-
-			// Marathon 1 handled (then-unused) coop flag differently
-			if (header.data_version == MARATHON_ONE_DATA_VERSION)
-			{
-				if (map_info.entry_point_flags & _single_player_entry_point)
-					map_info.entry_point_flags |= _multiplayer_cooperative_entry_point;
-				if (map_info.entry_point_flags & _multiplayer_carnage_entry_point)
-					map_info.entry_point_flags &= ~_multiplayer_cooperative_entry_point;
-			}
-
-			if (map_info.entry_point_flags & type) {
-
-				// This one is valid
-				entry_point point;
-				point.level_number = i;
-				assert(strlen(map_info.level_name) < LEVEL_NAME_LENGTH);
-				strncpy(point.level_name, map_info.level_name, 66);
-				vec.push_back(point);
-				success = true;
-			}
-				
-			free_wad(wad);
+	for (const level_index_entry& level : *levels) {
+		if (level.entry_point_flags & type) {
+
+			// This one is valid
+			entry_point point;
+			point.level_number = level.level_number;
+			strncpy(point.level_name, level.level_name, 66);
+			vec.push_back(point);
+			success = true;
 		}
 	}
 
@@ -2678,24 +2539,19 @@ void level_has_embedded_physics_lua(int Level, bool& HasPhysics, bool& HasLua)
 	// load the wad file and look for chunks !!??
 	wad_header header;
 	wad_data* wad;
-	OpenedFile MapFile;
-	if (open_wad_file_for_reading(get_map_file(), MapFile))
+	if (read_wad_header(get_map_file(), &header))
 	{
-		if (read_wad_header(MapFile, &header))
+		wad = read_indexed_wad_from_file(get_map_file(), &header, Level);
+		if (wad)
 		{
-			wad = read_indexed_wad_from_file(MapFile, &header, Level, true);
-			if (wad)
-			{
-				size_t data_length;
-				extract_type_from_wad(wad, PHYSICS_PHYSICS_TAG, &data_length);
-				HasPhysics = data_length > 0;
+			size_t data_length;
+			extract_type_from_wad(wad, PHYSICS_PHYSICS_TAG, &data_length);
+			HasPhysics = data_length > 0;
 
-				extract_type_from_wad(wad, LUAS_TAG, &data_length);
-				HasLua = data_length > 0;
-				free_wad(wad);
-			}
+			extract_type_from_wad(wad, LUAS_TAG, &data_length);
+			HasLua = data_length > 0;
+			free_wad(wad);
 		}
-		close_wad_file(MapFile);
 	}
 }
 
@@ -2704,7 +2560,7 @@ void level_has_embedded_physics_lua(int Level, bool& HasPhysics, bool& HasLua)
  *  Unpacking/packing functions
  */
 
-static uint8 *unpack_directory_data(uint8 *Stream, directory_data *Objects, size_t Count)
+uint8 *unpack_directory_data(uint8 *Stream, directory_data *Objects, size_t Count)
 {
 	uint8* S = Stream;
 	directory_data* ObjPtr = Objects;
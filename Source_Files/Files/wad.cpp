@@ -72,6 +72,11 @@ Sep 30, 2001 (Loren Petrich):
 
 Jan 25, 2002 (Br'fin (Jeremy Parsons)):
 	Adjusted Carbon flow to avoid a p2cstr
+
+Oct 16, 2026:
+	Added a cache of parsed wad headers and directories, read in one go,
+	for the functions that take a FileSpecifier; read-only wads from those
+	point into a mapping of the file where the platform has one
 */
 
 // Note that level_transition_malloc is specific to marathon...
@@ -81,6 +86,11 @@ Jan 25, 2002 (Br'fin (Jeremy Parsons)):
 #include <string.h>
 #include <stdlib.h>
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "wad.h"
 #include "tags.h"
 #include "crc.h"
@@ -101,9 +111,25 @@ inline short memory_error() {return 0;}
 // "between-levels" loading, such as 3D models.
 bool BetweenLevels = true;
 
+// The header and directory of a wad file, as of the file's date and size
+struct cached_wad_directory {
+	TimeType date;
+	int64_t size;
+	struct wad_header header;
+	std::vector<uint8> directory_data;				/* Raw, as read_directory_data() returns it */
+	std::vector<struct directory_entry> entries;	/* By wad index; index is NONE if it's missing */
+};
+
+// Scanning for a checksum visits every file in the search path, so this is
+// plenty for any one session without growing without bound
+const size_t MAXIMUM_CACHED_WAD_DIRECTORIES = 256;
+
 /* ---------------- private global data */
 struct wad_internal_data *internal_data[MAXIMUM_OPEN_WADFILES]= {NULL, NULL, NULL};
 
+// By path; entries are shared so that a caller's copy survives a reload
+static std::map<std::string, std::shared_ptr<const cached_wad_directory> > cached_wad_directories;
+
 /* ---------------- private prototypes */
 static int32 calculate_directory_offset(struct wad_header *header, short index);
 static short get_directory_base_length(struct wad_header *header);
@@ -120,6 +146,9 @@ static struct wad_data *convert_wad_from_raw_modifiable(struct wad_header *heade
 //static void patch_wad_from_raw(struct wad_header *header, uint8 *raw_wad, struct wad_data *read_wad);
 static bool size_of_indexed_wad(OpenedFile& OFile, struct wad_header *header, short index, 
 	int32 *length);
+static std::shared_ptr<const cached_wad_directory> get_cached_wad_directory(FileSpecifier& File);
+static const struct directory_entry *get_cached_directory_entry(const cached_wad_directory *directory,
+	short index);
 
 static bool write_to_file(OpenedFile& OFile, int32 offset, void *data, int32 length);
 static bool read_from_file(OpenedFile& OFile, int32 offset, void *data, int32 length);
@@ -279,15 +308,9 @@ uint32 read_wad_file_checksum(FileSpecifier& File)
 	struct wad_header header;
 	uint32 checksum= 0;
 	
-	OpenedFile OFile;
-	if (open_wad_file_for_reading(File,OFile))
+	if(read_wad_header(File, &header))
 	{
-		if(read_wad_header(OFile, &header))
-		{
-			checksum= header.checksum;
-		}
-		
-		close_wad_file(OFile);
+		checksum= header.checksum;
 	}
 	
 	return checksum;
@@ -295,19 +318,12 @@ uint32 read_wad_file_checksum(FileSpecifier& File)
 
 uint32 read_wad_file_parent_checksum(FileSpecifier& File)
 {
-	// fileref file_id;
 	struct wad_header header;
 	uint32 checksum= 0;
 
-	OpenedFile OFile;
-	if (open_wad_file_for_reading(File,OFile))
+	if(read_wad_header(File, &header))
 	{
-		if(read_wad_header(OFile, &header))
-		{
-			checksum= header.parent_checksum;
-		}
-		
-		close_wad_file(OFile);
+		checksum= header.parent_checksum;
 	}
 	
 	return checksum;
@@ -317,30 +333,100 @@ bool wad_file_has_parent_checksum(
 	FileSpecifier& File, 
 	uint32 parent_checksum)
 {
-	// fileref file_id;
 	bool has_checksum= false;
 	struct wad_header header;
 
-	OpenedFile OFile;
-	if (open_wad_file_for_reading(File,OFile))
-	// file_id= open_wad_file_for_reading(file);
-	// if(file_id>=0)
+	if(read_wad_header(File, &header))
 	{
-		if(read_wad_header(OFile, &header))
-		// if(read_wad_header(file_id, &header))
+		if(header.parent_checksum==parent_checksum)
 		{
-			if(header.parent_checksum==parent_checksum)
+			/* Found a match!  */
+			has_checksum= true;
+		}
+	}
+	
+	return has_checksum;
+}
+
+/* ------------ Cached read functions */
+bool read_wad_header(
+	FileSpecifier& File, 
+	struct wad_header *header)
+{
+	std::shared_ptr<const cached_wad_directory> directory= get_cached_wad_directory(File);
+	
+	if(!directory) return false;
+	
+	*header= directory->header;
+	return true;
+}
+
+void *read_directory_data(
+	FileSpecifier& File,
+	struct wad_header *header)
+{
+	std::shared_ptr<const cached_wad_directory> directory= get_cached_wad_directory(File);
+	int32 size;
+	uint8 *data= NULL;
+	
+	assert(header->version>=WADFILE_HAS_DIRECTORY_ENTRY);
+	
+	size= get_size_of_directory_data(header);
+	if(directory && directory->directory_data.size()==static_cast<size_t>(size))
+	{
+		data= (uint8 *)malloc(size);
+		if(data)
+		{
+			memcpy(data, directory->directory_data.data(), size);
+		}
+	}
+
+	return data;
+}
+
+struct wad_data *read_indexed_wad_from_file(
+	FileSpecifier& File, 
+	struct wad_header *header, 
+	short index)
+{
+	std::shared_ptr<const cached_wad_directory> directory= get_cached_wad_directory(File);
+	const struct directory_entry *entry;
+	
+	if(!directory) return NULL;
+	
+	entry= get_cached_directory_entry(directory.get(), index);
+	
+	/* Marathon 1's short entry headers are read with the long ones' unpacker, */
+	/*  which could run off the end of a mapping, so those always get read */
+	if(entry && entry->length>0 && get_entry_header_length(header)==SIZEOF_entry_header)
+	{
+		MappedFile *mapped_file= new MappedFile;
+		
+		if(mapped_file->Map(File) && entry->offset_to_start>=0 &&
+			entry->length<=mapped_file->GetLength()-entry->offset_to_start)
+		{
+			/* Read only all the way, so the constness can go */
+			uint8 *raw_wad= const_cast<uint8 *>(mapped_file->GetData())+entry->offset_to_start;
+			struct wad_data *read_wad;
+			
+			/* Veracity Check */
+			assert(entry->length==calculate_raw_wad_length(header, raw_wad));
+			
+			read_wad= convert_wad_from_raw(header, raw_wad, 0, entry->length);
+			if(read_wad)
 			{
-				/* Found a match!  */
-				has_checksum= true;
+				read_wad->mapped_file= mapped_file;
+				return read_wad;
 			}
 		}
 		
-		close_wad_file(OFile);
-		// close_wad_file(file_id);
+		delete mapped_file;
 	}
 	
-	return has_checksum;
+	OpenedFile OFile;
+	if(!open_wad_file_for_reading(File, OFile)) return NULL;
+	
+	return read_indexed_wad_from_file(OFile, header, index, true);
 }
 
 /* ------------ Writing functions */
@@ -723,18 +809,11 @@ bool write_wad(
 short number_of_wads_in_file(FileSpecifier& File)
 {
 	short count= NONE;
+	struct wad_header header;
 	
-	OpenedFile OFile;
-	if (open_wad_file_for_reading(File,OFile))
+	if (read_wad_header(File, &header))
 	{
-		struct wad_header header;
-		
-		/* read the header */
-		read_wad_header(OFile, &header);
-		
 		count= header.wad_count;
-		
-		close_wad_file(OFile);
 	}
 	
 	return count;
@@ -748,7 +827,13 @@ void free_wad(
 	assert(wad);
 	
 	/* Free all of the tags */
-	if(wad->read_only_data)
+	if(wad->mapped_file)
+	{
+		/* Read only wad, in a mapped file */
+		delete wad->mapped_file;
+		free(wad->tag_data);
+	}
+	else if(wad->read_only_data)
 	{
 		/* Read only wad.. */
 		free(wad->read_only_data);
@@ -807,55 +892,60 @@ void *get_flat_data(
 	
 	assert(!use_union);
 	
-	OpenedFile OFile;
-	if (open_wad_file_for_reading(File,OFile))
+	/* The header and directory entry come from the cache, so this is one read */
+	std::shared_ptr<const cached_wad_directory> directory= get_cached_wad_directory(File);
+	if (directory)
 	{
-		/* Read the file */
-		success= read_wad_header(OFile, &header);
-
-		if (success)
-		{
-			int32 length;
-			int error = 0;
+		const struct directory_entry *entry= get_cached_directory_entry(directory.get(), wad_index);
+		int error = 0;
 		
-			/* Allocate the conglomerate data.. */
-			if (size_of_indexed_wad(OFile, &header, wad_index, &length))
+		header= directory->header;
+		
+		/* Allocate the conglomerate data.. */
+		if (entry && entry->length > 0)
+		{
+			int32 length= entry->length;
+			
+			data= (uint8 *)malloc(length+SIZEOF_encapsulated_wad_data);
+			if(data)
 			{
-				data= (uint8 *)malloc(length+SIZEOF_encapsulated_wad_data);
-				if(data)
+				uint8 *buffer= data + SIZEOF_encapsulated_wad_data;
+				
+				// Pack the encapsulated header
+				uint8 *S = data;
+				ValueToStream(S,uint32(CURRENT_FLAT_MAGIC_COOKIE));
+				ValueToStream(S,int32(length + SIZEOF_encapsulated_wad_data));
+				S = pack_wad_header(S,&header,1);
+				assert((S - data) == SIZEOF_encapsulated_wad_data);
+				
+				/* Read into our buffer... */
+				OpenedFile OFile;
+				if (open_wad_file_for_reading(File,OFile))
 				{
-					uint8 *buffer= data + SIZEOF_encapsulated_wad_data;
-					
-					// Pack the encapsulated header
-					uint8 *S = data;
-					ValueToStream(S,uint32(CURRENT_FLAT_MAGIC_COOKIE));
-					ValueToStream(S,int32(length + SIZEOF_encapsulated_wad_data));
-					S = pack_wad_header(S,&header,1);
-					assert((S - data) == SIZEOF_encapsulated_wad_data);
-					
-					/* Read into our buffer... */
-					success = read_indexed_wad_from_file_into_buffer(OFile, &header, wad_index, 
-						buffer, &length);
-					
-					if (!success)
-					{
-						/* Error-> didn't get it.. */
-						free(data);
-						data= NULL;
-						error = OFile.GetError();
-					}
-				} 
-				else 
+					success = read_from_file(OFile, entry->offset_to_start, buffer, length);
+					error = OFile.GetError();
+					close_wad_file(OFile);
+				}
+				
+				if (success)
 				{
-					error= memory_error();
+					/* Veracity Check */
+					assert(length==calculate_raw_wad_length(&header, buffer));
 				}
+				else
+				{
+					/* Error-> didn't get it.. */
+					free(data);
+					data= NULL;
+				}
+			} 
+			else 
+			{
+				error= memory_error();
 			}
-
-			set_game_error(systemError, error);
 		}
-		
-		/* Close the file.. */
-		close_wad_file(OFile);
+
+		set_game_error(systemError, error);
 	}
 
 	return data;
@@ -946,6 +1036,10 @@ bool open_wad_file_for_reading(FileSpecifier& File, OpenedFile& OFile)
 
 bool open_wad_file_for_writing(FileSpecifier& File, OpenedFile& OFile)
 {
+	// Saves are written aside and renamed over the original, perhaps within the
+	// date's resolution and at the same size, so don't trust anything cached
+	cached_wad_directories.clear();
+	
 	return open_wad_file_or_set_error(File, OFile, true);
 }
 
@@ -955,6 +1049,121 @@ void close_wad_file(OpenedFile& File)
 }
 
 /* ------------------------------ Private Code --------------- */
+static std::shared_ptr<const cached_wad_directory> get_cached_wad_directory(
+	FileSpecifier& File)
+{
+	TimeType date= File.GetDate();
+	int64_t size= File.GetSize();
+	
+	auto it= cached_wad_directories.find(File.GetPath());
+	if(it!=cached_wad_directories.end())
+	{
+		if(date && it->second->date==date && it->second->size==size)
+		{
+			return it->second;
+		}
+		cached_wad_directories.erase(it);
+	}
+	
+	std::shared_ptr<cached_wad_directory> directory= std::make_shared<cached_wad_directory>();
+	directory->date= date;
+	directory->size= size;
+	
+	OpenedFile OFile;
+	if(!open_wad_file_for_reading(File, OFile)) return nullptr;
+	if(!read_wad_header(OFile, &directory->header)) return nullptr;
+	
+	struct wad_header *header= &directory->header;
+	directory_entry missing_entry;
+	obj_clear(missing_entry);
+	missing_entry.index= NONE;
+	directory->entries.assign(header->wad_count, missing_entry);
+	
+	/* The whole directory in one read, instead of an entry at a time */
+	int32 directory_size= get_size_of_directory_data(header);
+	directory->directory_data.resize(directory_size);
+	if(!read_from_file(OFile, header->directory_offset, directory->directory_data.data(), directory_size))
+	{
+		/* Keep the header; nothing will be found in the directory */
+		directory->directory_data.clear();
+	}
+	else
+	{
+		short base_entry_size= get_directory_base_length(header);
+		std::vector<struct directory_entry> entries(header->wad_count);
+		
+		/* Pin it, so we can try to read future file formats */
+		if(header->version>WADFILE_HAS_DIRECTORY_ENTRY && base_entry_size>SIZEOF_directory_entry) 
+		{
+			base_entry_size= SIZEOF_directory_entry;
+		}
+		
+		for(short position= 0; position<header->wad_count; ++position)
+		{
+			uint8 *buffer= directory->directory_data.data()+
+				(calculate_directory_offset(header, position)-header->directory_offset);
+			
+			switch (base_entry_size)
+			{
+			case SIZEOF_old_directory_entry:
+				unpack_old_directory_entry(buffer,(old_directory_entry *)&entries[position],1);
+				entries[position].index= position;
+				break;
+			case SIZEOF_directory_entry:
+				unpack_directory_entry(buffer,&entries[position],1);
+				break;
+			default:
+				vassert(false,csprintf(temporary,"Unrecognized base-entry length: %d",base_entry_size));
+			}
+		}
+		
+		for(short index= 0; index<header->wad_count; ++index)
+		{
+			/* For old files, the index==the actual index */
+			if(header->version<=WADFILE_HAS_DIRECTORY_ENTRY) 
+			{
+				directory->entries[index]= entries[index];
+				directory->entries[index].index= index;
+				continue;
+			}
+			
+			/* Same search as read_indexed_directory_data(), so that */
+			/*  duplicated indices resolve the same way */
+			for(short directory_index= 0; directory_index<header->wad_count; ++directory_index)
+			{
+				short test_index= (index+directory_index)%header->wad_count;
+				if(entries[test_index].index==index)
+				{
+					directory->entries[index]= entries[test_index];
+					break;
+				}
+			}
+		}
+	}
+	
+	/* Files without a date, like those inside archives, get reread every time */
+	if(date)
+	{
+		if(cached_wad_directories.size()>=MAXIMUM_CACHED_WAD_DIRECTORIES)
+		{
+			cached_wad_directories.clear();
+		}
+		cached_wad_directories[File.GetPath()]= directory;
+	}
+	
+	return directory;
+}
+
+static const struct directory_entry *get_cached_directory_entry(
+	const cached_wad_directory *directory,
+	short index)
+{
+	if(index<0 || index>=static_cast<short>(directory->entries.size())) return NULL;
+	if(directory->entries[index].index!=index) return NULL;
+	
+	return &directory->entries[index];
+}
+
 static bool size_of_indexed_wad(
 	OpenedFile& OFile, 
 	struct wad_header *header, 
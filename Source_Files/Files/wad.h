@@ -37,6 +37,11 @@ Feb 3, 2000 (Loren Petrich):
 
 Aug 12, 2000 (Loren Petrich):
 	Using object-oriented file handler
+
+Oct 16, 2026:
+	Added reading functions that take a FileSpecifier and work from a cached copy
+	of the file's header and directory; read-only wads read that way can point
+	straight into a mapping of the file
 */
 
 #include "tags.h"
@@ -54,6 +59,7 @@ Aug 12, 2000 (Loren Petrich):
 
 class FileSpecifier;
 class OpenedFile;
+class MappedFile;
 
 /* ------------- typedefs */
 typedef uint32 WadDataType;
@@ -124,6 +130,7 @@ struct wad_data {
 	short padding;
 	byte *read_only_data;		/* If this is non NULL, we are read only.... */
 	struct tag_data *tag_data;	/* Tag data array */
+	MappedFile *mapped_file;	/* If non NULL, read_only_data points into this, and it goes with the wad */
 };
 
 /* ----- miscellaneous functions */
@@ -174,6 +181,20 @@ void *read_directory_data(OpenedFile& OFile, struct wad_header *header);
 uint32 read_wad_file_checksum(FileSpecifier& File);
 uint32 read_wad_file_parent_checksum(FileSpecifier& File);
 
+/* ----- Cached read functions */
+/* These work from a parsed copy of the file's header and directory, kept until */
+/*  the file's date or size changes, so they don't reopen the file every time */
+
+bool read_wad_header(FileSpecifier& File, struct wad_header *header);
+
+/* Same as the OpenedFile version: a malloc'ed copy of the raw directory data */
+void *read_directory_data(FileSpecifier& File, struct wad_header *header);
+
+/* Always read only; where the platform can map the file, the tags point */
+/*  straight into the mapping instead of into a copy */
+struct wad_data *read_indexed_wad_from_file(FileSpecifier& File, 
+	struct wad_header *header, short index);
+
 // Now intended to use the _typecode_stuff in tags.h (abstract filetypes)
 
 bool find_wad_file_that_has_checksum(FileSpecifier& File,
@@ -32,6 +32,15 @@ Jan 30, 2000 (Loren Petrich):
 
 Feb. 4, 2000 (Loren Petrich):
 	Changed halt() to assert(false) for better debugging
+
+Oct 16, 2026:
+	_best_first now pops its next node from a binary heap ordered by (cost, node index) instead
+	of scanning every node; ties still go to the lowest node index, so paths are unchanged.
+	Only the polygons touched by the previous flood are cleared from visited_polygons.
+	Added the polygon adjacency graph: every polygon's neighbors, with the shared line's flags,
+	length, clearance and endpoints, packed into one contiguous array built at level load and
+	patched when line heights change.  flood_map() and its cost procs walk this instead of
+	chasing polygon_data/line_data pointers.
 */
 
 /*
@@ -47,6 +56,8 @@ on very small maps, choose_random_flood_node() may not terminate
 #include <stdlib.h>
 #include <limits.h>
 
+#include <vector>
+
 /* ---------- constants */
 
 #define MAXIMUM_FLOOD_NODES 255
@@ -69,6 +80,8 @@ struct node_data /* 16 bytes */
 	int16 depth;
 
 	int32 user_flags;
+
+	int16 frontier_index; /* position in the best-first frontier heap, or NONE */
 };
 
 /* ---------- globals */
@@ -77,10 +90,32 @@ static short node_count= 0, last_node_index_expanded= NONE;
 static struct node_data *nodes = NULL;
 static short *visited_polygons = NULL;
 
+/* binary min-heap of unexpanded node indexes, only maintained for _best_first floods */
+static short frontier_count= 0;
+static short *frontier = NULL;
+static short current_flood_mode= _breadth_first;
+
+/* polygon adjacency graph: polygon i's edges are polygon_edges[first_polygon_edge[i]] through
+	polygon_edges[first_polygon_edge[i+1]-1]; line_edges[2*l] and [2*l+1] are the edges crossing
+	line l (or NONE) */
+static std::vector<int32> first_polygon_edge;
+static std::vector<struct polygon_edge_data> polygon_edges;
+static std::vector<int32> line_edges;
+static struct polygon_edge_data *flood_map_edge= NULL;
+
 /* ---------- private prototypes */
 
 static void add_node(short parent_node_index, short polygon_index, short depth, int32 cost, int32 user_flags);
 
+static void update_polygon_edge(struct polygon_edge_data *edge);
+
+static bool frontier_node_precedes(short a, short b);
+static void frontier_set(short frontier_index, short node_index);
+static void frontier_sift_up(short frontier_index);
+static void frontier_sift_down(short frontier_index);
+static void frontier_push(short node_index);
+static short frontier_pop(void);
+
 /* ---------- code */
 
 void allocate_flood_map_memory(
@@ -91,6 +126,12 @@ void allocate_flood_map_memory(
 	nodes= new node_data[MAXIMUM_FLOOD_NODES];
 	if (visited_polygons) delete []visited_polygons;
 	visited_polygons= new short[MAXIMUM_POLYGONS_PER_MAP];
+	objlist_set(visited_polygons, NONE, MAXIMUM_POLYGONS_PER_MAP);
+	if (frontier) delete []frontier;
+	frontier= new short[MAXIMUM_FLOOD_NODES];
+
+	node_count= 0, frontier_count= 0;
+	last_node_index_expanded= NONE;
 }
 
 /* returns next polygon index or NONE if there are no more polygons left cheaper than maximum_cost */
@@ -109,26 +150,28 @@ short flood_map(
 	/* initialize ourselves if first_polygon_index!=NONE */
 	if (first_polygon_index!=NONE)
 	{
-		/* clear the visited polygon array */
-		objlist_set(visited_polygons, NONE, MAXIMUM_POLYGONS_PER_MAP);
+		/* clear the visited polygon array; only polygons in the last flood's node list can be set */
+		for (node_index= 0; node_index<node_count; ++node_index)
+		{
+			visited_polygons[nodes[node_index].polygon_index]= UNVISITED;
+		}
 		
-		node_count= 0;
+		node_count= 0, frontier_count= 0;
 		last_node_index_expanded= NONE;
+		current_flood_mode= flood_mode;
 		add_node(NONE, first_polygon_index, 0, 0, (flood_mode==_flagged_breadth_first) ? *((int32*)caller_data) : 0);
 	}
 	
 	switch (flood_mode)
 	{
 		case _best_first:
-			/* find the unexpanded node with the lowest cost */
+			/* the unexpanded node with the lowest cost (lowest index on ties) is at the top of the frontier */
+			assert(current_flood_mode==_best_first);
 			lowest_cost= maximum_cost, lowest_cost_node_index= NONE;
-			for (node= nodes, node_index= 0; node_index<node_count; ++node_index, ++node)
+			if (frontier_count>0 && nodes[frontier[0]].cost<maximum_cost)
 			{
-				if (NODE_IS_UNEXPANDED(node)&&node->cost<lowest_cost)
-				{
-					lowest_cost_node_index= node_index;
-					lowest_cost= node->cost;
-				}
+				lowest_cost_node_index= frontier_pop();
+				lowest_cost= nodes[lowest_cost_node_index].cost;
 			}
 			break;
 		
@@ -166,7 +209,8 @@ short flood_map(
 	if (lowest_cost_node_index!=NONE)
 	{
 		struct polygon_data *polygon;
-		short i;
+		struct polygon_edge_data *edge;
+		short i, edge_count;
 		
 		/* for flood_depth() and reverse_flood_map(), remember which node we successfully expanded last */
 		last_node_index_expanded= lowest_cost_node_index;
@@ -181,15 +225,19 @@ short flood_map(
 		/* mark node as expanded */
 		MARK_NODE_AS_EXPANDED(node);
 
-		for (i= 0; i<polygon->vertex_count; ++i)		
+		edge= get_polygon_edges(node->polygon_index, &edge_count);
+		for (i= 0; i<edge_count; ++i, ++edge)
 		{
-			short destination_polygon_index= polygon->adjacent_polygon_indexes[i];
+			short destination_polygon_index= edge->destination_polygon_index;
 			
-			if (destination_polygon_index!=NONE &&
-				(maximum_cost!=INT32_MAX || visited_polygons[destination_polygon_index]==UNVISITED))
+			if (maximum_cost!=INT32_MAX || visited_polygons[destination_polygon_index]==UNVISITED)
 			{
 				int32 new_user_flags= node->user_flags;
-				int32 cost= cost_proc ? cost_proc(node->polygon_index, polygon->line_indexes[i], destination_polygon_index, (flood_mode==_flagged_breadth_first) ? &new_user_flags : caller_data) : polygon->area;
+				int32 cost;
+				
+				flood_map_edge= edge;
+				cost= cost_proc ? cost_proc(node->polygon_index, edge->line_index, destination_polygon_index, (flood_mode==_flagged_breadth_first) ? &new_user_flags : caller_data) : polygon->area;
+				flood_map_edge= NULL;
 				
 				/* polygons with zero or negative costs are not added to the node list */
 				if (cost>0) add_node(lowest_cost_node_index, destination_polygon_index, node->depth+1, lowest_cost+cost, new_user_flags);
@@ -281,8 +329,118 @@ void choose_random_flood_node(
 	}
 }
 
+void build_polygon_adjacency_graph(
+	void)
+{
+	short polygon_index;
+	
+	first_polygon_edge.resize(dynamic_world->polygon_count+1);
+	polygon_edges.clear();
+	line_edges.assign(2*dynamic_world->line_count, NONE);
+	
+	for (polygon_index= 0; polygon_index<dynamic_world->polygon_count; ++polygon_index)
+	{
+		struct polygon_data *polygon= get_polygon_data(polygon_index);
+		short i;
+		
+		first_polygon_edge[polygon_index]= static_cast<int32>(polygon_edges.size());
+		for (i= 0; i<polygon->vertex_count; ++i)
+		{
+			if (polygon->adjacent_polygon_indexes[i]!=NONE)
+			{
+				struct polygon_edge_data edge;
+				short line_index= polygon->line_indexes[i];
+				int32 *line_edge= &line_edges[2*line_index];
+				
+				obj_clear(edge);
+				edge.destination_polygon_index= polygon->adjacent_polygon_indexes[i];
+				edge.line_index= line_index;
+				update_polygon_edge(&edge);
+				
+				if (line_edge[0]!=NONE) line_edge+= 1;
+				*line_edge= static_cast<int32>(polygon_edges.size());
+				polygon_edges.push_back(edge);
+			}
+		}
+	}
+	first_polygon_edge[dynamic_world->polygon_count]= static_cast<int32>(polygon_edges.size());
+}
+
+/* call after changing the heights or solidity of the given line */
+void update_polygon_adjacency_graph_line(
+	short line_index)
+{
+	if (2*line_index<static_cast<int32>(line_edges.size()))
+	{
+		short i;
+		
+		for (i= 0; i<2; ++i)
+		{
+			int32 edge_index= line_edges[2*line_index+i];
+			
+			/* edges left over from the previous level are rebuilt by build_polygon_adjacency_graph() */
+			if (edge_index!=NONE && polygon_edges[edge_index].line_index==line_index)
+			{
+				update_polygon_edge(&polygon_edges[edge_index]);
+			}
+		}
+	}
+}
+
+struct polygon_edge_data *get_polygon_edges(
+	short polygon_index,
+	short *edge_count)
+{
+	assert(polygon_index>=0&&polygon_index+1<static_cast<int32>(first_polygon_edge.size()));
+	*edge_count= static_cast<short>(first_polygon_edge[polygon_index+1]-first_polygon_edge[polygon_index]);
+	
+	return polygon_edges.data()+first_polygon_edge[polygon_index];
+}
+
+/* returns the first edge from source_polygon_index into destination_polygon_index, or NULL */
+struct polygon_edge_data *find_polygon_edge(
+	short source_polygon_index,
+	short destination_polygon_index)
+{
+	struct polygon_edge_data *edge;
+	short i, edge_count;
+	
+	edge= get_polygon_edges(source_polygon_index, &edge_count);
+	for (i= 0; i<edge_count; ++i, ++edge)
+	{
+		if (edge->destination_polygon_index==destination_polygon_index) return edge;
+	}
+	
+	return (struct polygon_edge_data *) NULL;
+}
+
+struct polygon_edge_data *get_flood_map_edge(
+	void)
+{
+	assert(flood_map_edge);
+	
+	return flood_map_edge;
+}
+
 /* ---------- private code */
 
+/* refreshes everything the edge caches about its shared line */
+static void update_polygon_edge(
+	struct polygon_edge_data *edge)
+{
+	struct line_data *line= get_line_data(edge->line_index);
+	short i;
+	
+	edge->flags= line->flags;
+	edge->length= line->length;
+	edge->clearance= line->lowest_adjacent_ceiling-line->highest_adjacent_floor;
+	for (i= 0; i<2; ++i)
+	{
+		edge->endpoint_indexes[i]= line->endpoint_indexes[i];
+		edge->vertexes[i]= get_endpoint_data(line->endpoint_indexes[i])->vertex;
+	}
+}
+
 /* checks to see if the given node is already in the node list */
 static void add_node(
 	short parent_node_index,
@@ -317,9 +475,12 @@ static void add_node(
 		
 		if (node)
 		{
-			if (node_index==node_count)
+			bool new_node= (node_index==node_count);
+			
+			if (new_node)
 			{
 				node_count+= 1;
+				node->frontier_index= NONE;
 			}
 			
 			node->flags= 0;
@@ -332,7 +493,102 @@ static void add_node(
 			assert(polygon_index>=0&&polygon_index<dynamic_world->polygon_count);
 			visited_polygons[polygon_index]= node_index;
 			
+			if (current_flood_mode==_best_first)
+			{
+				/* a replaced node only ever gets cheaper, so it can only move up the heap */
+				if (new_node)
+				{
+					frontier_push(node_index);
+				}
+				else
+				{
+					frontier_sift_up(node->frontier_index);
+				}
+			}
+			
 //			dprintf("added polygon #%d to node #%d (nodes=%p,visited=%p)", polygon_index, node_index, nodes, visited_polygons);
 		}
 	}
 }
+
+/* the frontier is ordered by cost, then by node index; this is exactly the order in which the
+	old linear scan over the node list picked nodes, so floods expand polygons identically */
+static bool frontier_node_precedes(
+	short a,
+	short b)
+{
+	int32 cost_a= nodes[a].cost, cost_b= nodes[b].cost;
+	
+	return cost_a<cost_b || (cost_a==cost_b && a<b);
+}
+
+static void frontier_set(
+	short frontier_index,
+	short node_index)
+{
+	frontier[frontier_index]= node_index;
+	nodes[node_index].frontier_index= frontier_index;
+}
+
+static void frontier_sift_up(
+	short frontier_index)
+{
+	short node_index= frontier[frontier_index];
+	
+	assert(frontier_index>=0&&frontier_index<frontier_count);
+	while (frontier_index>0)
+	{
+		short parent_index= (frontier_index-1)/2;
+		
+		if (!frontier_node_precedes(node_index, frontier[parent_index])) break;
+		frontier_set(frontier_index, frontier[parent_index]);
+		frontier_index= parent_index;
+	}
+	frontier_set(frontier_index, node_index);
+}
+
+static void frontier_sift_down(
+	short frontier_index)
+{
+	short node_index= frontier[frontier_index];
+	
+	for (;;)
+	{
+		short child_index= 2*frontier_index+1;
+		
+		if (child_index>=frontier_count) break;
+		if (child_index+1<frontier_count && frontier_node_precedes(frontier[child_index+1], frontier[child_index])) child_index+= 1;
+		if (!frontier_node_precedes(frontier[child_index], node_index)) break;
+		frontier_set(frontier_index, frontier[child_index]);
+		frontier_index= child_index;
+	}
+	frontier_set(frontier_index, node_index);
+}
+
+static void frontier_push(
+	short node_index)
+{
+	assert(frontier_count<MAXIMUM_FLOOD_NODES);
+	frontier_set(frontier_count, node_index);
+	frontier_count+= 1;
+	frontier_sift_up(frontier_count-1);
+}
+
+static short frontier_pop(
+	void)
+{
+	short node_index;
+	
+	assert(frontier_count>0);
+	node_index= frontier[0];
+	nodes[node_index].frontier_index= NONE;
+	
+	frontier_count-= 1;
+	if (frontier_count>0)
+	{
+		frontier_set(0, frontier[frontier_count]);
+		frontier_sift_down(0);
+	}
+	
+	return node_index;
+}
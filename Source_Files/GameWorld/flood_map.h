@@ -40,14 +40,53 @@ enum /* flood modes */
 
 typedef int32 (*cost_proc_ptr)(short source_polygon_index, short line_index, short destination_polygon_index, void *caller_data);
 
+/* one directed edge of the polygon adjacency graph; a polygon's edges are stored contiguously in
+	the same order as its adjacent_polygon_indexes[] (with NONE entries skipped) */
+struct polygon_edge_data /* 24 bytes */
+{
+	int16 destination_polygon_index;
+	int16 line_index;
+
+	uint16 flags; /* copy of the shared line's flags, so the LINE_IS_*() macros work on edges */
+	world_distance length; /* of the shared line */
+	int16 endpoint_indexes[2]; /* of the shared line */
+
+	int32 clearance; /* lowest_adjacent_ceiling-highest_adjacent_floor of the shared line */
+	world_point2d vertexes[2];
+};
+
+/* returns the current value of something a cost_proc's answer depended on; see
+	note_path_cost_dependency() */
+typedef int32 (*path_dependency_proc_ptr)(short kind, short index);
+
+/* identifies everything a cost_proc's results depend on besides the map itself; paths flooded
+	with equal classes between the same two polygons are interchangeable */
+struct path_cost_class
+{
+	cost_proc_ptr cost;
+	path_dependency_proc_ptr dependency_proc;
+	int32 parameters[4];
+};
+
 /* ---------- prototypes/PATHFINDING.C */
 
 void allocate_pathfinding_memory(void);
 void reset_paths(void);
 
+/* if cost_class is given, the polygons traversed are cached and reused by later paths of the
+	same class between the same polygons; the resulting path is identical either way */
 short new_path(world_point2d *source_point, short source_polygon_index,
 	world_point2d *destination_point, short destination_polygon_index,
-	world_distance minimum_separation, cost_proc_ptr cost, void *data);
+	world_distance minimum_separation, cost_proc_ptr cost, void *data,
+	const struct path_cost_class *cost_class= NULL);
+
+/* cost_procs of cached paths call this for every piece of changeable state (platforms, monster
+	positions, ...) an answer depended on; the cached path is discarded once
+	dependency_proc(kind, index) no longer returns value */
+void note_path_cost_dependency(short kind, short index, int32 value);
+
+/* call when map state not covered by dependencies (polygon types, heights) changes */
+void invalidate_path_cache(void);
 bool move_along_path(short path_index, world_point2d *p);
 void delete_path(short path_index);
 
@@ -63,5 +102,16 @@ short flood_depth(void);
 
 void choose_random_flood_node(world_vector2d *bias);
 
+/* the adjacency graph is built once the level's redundant data and platforms are in place, and
+	must be patched whenever a line's heights or solidity change */
+void build_polygon_adjacency_graph(void);
+void update_polygon_adjacency_graph_line(short line_index);
+
+struct polygon_edge_data *get_polygon_edges(short polygon_index, short *edge_count);
+struct polygon_edge_data *find_polygon_edge(short source_polygon_index, short destination_polygon_index);
+
+/* the edge flood_map() is currently asking its cost_proc about; only valid inside a cost_proc */
+struct polygon_edge_data *get_flood_map_edge(void);
+
 #endif
 
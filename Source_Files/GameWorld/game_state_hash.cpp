@@ -0,0 +1,474 @@
+/*
+GAME_STATE_HASH.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+ 
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Hashes of the simulation state for catching games that go out of sync
+*/
+
+#include "game_state_hash.h"
+
+#include "cseries.h"
+#include "map.h"
+#include "effects.h"
+#include "lightsource.h"
+#include "media.h"
+#include "monsters.h"
+#include "platforms.h"
+#include "player.h"
+#include "projectiles.h"
+#include "Logging.h"
+#include "FileHandler.h"
+#include "AStream.h"
+#include "shell.h"
+
+#if !defined(DISABLE_NETWORKING)
+#include "network.h"
+#include "network_distribution_types.h"
+#include "mytm.h"
+#endif
+
+#include <deque>
+
+static const uint32 GAME_STATE_HASH_FILM_TAG = FOUR_CHARS_TO_INT('h', 's', 'h', '1');
+static const int SIZEOF_game_state_hash = 2 + 4 + 8 * NUMBER_OF_GAME_STATE_HASH_SECTIONS;
+
+static const char *game_state_hash_section_names[NUMBER_OF_GAME_STATE_HASH_SECTIONS] =
+{
+	"world",
+	"players",
+	"monsters",
+	"objects",
+	"projectiles",
+	"effects",
+	"platforms",
+	"lights",
+	"medias"
+};
+
+static inline void hash_value(uint64_t& hash, int64_t value)
+{
+	hash ^= static_cast<uint64_t>(value) + UINT64_C(0x9e3779b97f4a7c15) + (hash << 6) + (hash >> 2);
+}
+
+static void hash_point(uint64_t& hash, const world_point3d& point)
+{
+	hash_value(hash, point.x);
+	hash_value(hash, point.y);
+	hash_value(hash, point.z);
+}
+
+uint64_t game_state_hash::combined() const
+{
+	uint64_t hash = 0;
+	for (short i = 0; i < NUMBER_OF_GAME_STATE_HASH_SECTIONS; ++i)
+	{
+		hash_value(hash, static_cast<int64_t>(sections[i]));
+	}
+
+	return hash;
+}
+
+void compute_game_state_hash(game_state_hash& hash)
+{
+	hash.level = dynamic_world->current_level_number;
+	hash.tick = dynamic_world->tick_count;
+	objlist_clear(hash.sections, NUMBER_OF_GAME_STATE_HASH_SECTIONS);
+
+	uint64_t& world = hash.sections[_hash_world];
+	hash_value(world, dynamic_world->tick_count);
+	hash_value(world, get_random_seed());
+	hash_value(world, dynamic_world->object_count);
+	hash_value(world, dynamic_world->monster_count);
+	hash_value(world, dynamic_world->projectile_count);
+	hash_value(world, dynamic_world->effect_count);
+
+	uint64_t& players_hash = hash.sections[_hash_players];
+	for (short i = 0; i < dynamic_world->player_count; ++i)
+	{
+		player_data *player = get_player_data(i);
+		hash_point(players_hash, player->location);
+		hash_value(players_hash, player->facing);
+		hash_value(players_hash, player->elevation);
+		hash_value(players_hash, player->supporting_polygon_index);
+		hash_value(players_hash, player->suit_energy);
+		hash_value(players_hash, player->suit_oxygen);
+		hash_value(players_hash, player->monster_index);
+		hash_value(players_hash, player->reincarnation_delay);
+		for (short item = 0; item < NUMBER_OF_ITEMS; ++item)
+		{
+			hash_value(players_hash, player->items[item]);
+		}
+	}
+
+	uint64_t& monsters_hash = hash.sections[_hash_monsters];
+	for (size_t i = 0; i < MonsterList.size(); ++i)
+	{
+		monster_data *monster = &MonsterList[i];
+		if (SLOT_IS_FREE(monster)) continue;
+
+		hash_value(monsters_hash, i);
+		hash_value(monsters_hash, monster->type);
+		hash_value(monsters_hash, monster->vitality);
+		hash_value(monsters_hash, monster->flags);
+		hash_value(monsters_hash, monster->mode);
+		hash_value(monsters_hash, monster->action);
+		hash_value(monsters_hash, monster->target_index);
+		hash_value(monsters_hash, monster->object_index);
+	}
+
+	uint64_t& objects_hash = hash.sections[_hash_objects];
+	for (size_t i = 0; i < ObjectList.size(); ++i)
+	{
+		object_data *object = &ObjectList[i];
+		if (SLOT_IS_FREE(object)) continue;
+
+		hash_value(objects_hash, i);
+		hash_point(objects_hash, object->location);
+		hash_value(objects_hash, object->polygon);
+		hash_value(objects_hash, object->facing);
+		hash_value(objects_hash, object->shape);
+		hash_value(objects_hash, object->flags & ~_object_was_rendered); // the renderer sets this one
+		hash_value(objects_hash, object->permutation);
+	}
+
+	uint64_t& projectiles_hash = hash.sections[_hash_projectiles];
+	for (size_t i = 0; i < ProjectileList.size(); ++i)
+	{
+		projectile_data *projectile = &ProjectileList[i];
+		if (SLOT_IS_FREE(projectile)) continue;
+
+		hash_value(projectiles_hash, i);
+		hash_value(projectiles_hash, projectile->type);
+		hash_value(projectiles_hash, projectile->object_index);
+		hash_value(projectiles_hash, projectile->target_index);
+		hash_value(projectiles_hash, projectile->owner_index);
+		hash_value(projectiles_hash, projectile->distance_travelled);
+	}
+
+	uint64_t& effects_hash = hash.sections[_hash_effects];
+	for (size_t i = 0; i < EffectList.size(); ++i)
+	{
+		effect_data *effect = &EffectList[i];
+		if (SLOT_IS_FREE(effect)) continue;
+
+		hash_value(effects_hash, i);
+		hash_value(effects_hash, effect->type);
+		hash_value(effects_hash, effect->object_index);
+		hash_value(effects_hash, effect->delay);
+	}
+
+	uint64_t& platforms_hash = hash.sections[_hash_platforms];
+	for (auto& platform : PlatformList)
+	{
+		hash_value(platforms_hash, platform.dynamic_flags);
+		hash_value(platforms_hash, platform.floor_height);
+		hash_value(platforms_hash, platform.ceiling_height);
+		hash_value(platforms_hash, platform.ticks_until_restart);
+	}
+
+	uint64_t& lights_hash = hash.sections[_hash_lights];
+	for (auto& light : LightList)
+	{
+		hash_value(lights_hash, light.state);
+		hash_value(lights_hash, light.intensity);
+		hash_value(lights_hash, light.phase);
+	}
+
+	uint64_t& medias_hash = hash.sections[_hash_medias];
+	for (auto& media : MediaList)
+	{
+		hash_value(medias_hash, media.height);
+		hash_value(medias_hash, media.origin.x);
+		hash_value(medias_hash, media.origin.y);
+	}
+}
+
+const char *get_game_state_hash_section_name(short section)
+{
+	assert(section >= 0 && section < NUMBER_OF_GAME_STATE_HASH_SECTIONS);
+	return game_state_hash_section_names[section];
+}
+
+short compare_game_state_hashes(const game_state_hash& a, const game_state_hash& b)
+{
+	if (a.level != b.level || a.tick != b.tick) return _hash_world;
+
+	for (short i = 0; i < NUMBER_OF_GAME_STATE_HASH_SECTIONS; ++i)
+	{
+		if (a.sections[i] != b.sections[i]) return i;
+	}
+
+	return NONE;
+}
+
+static void pack_game_state_hash(AOStreamBE& stream, const game_state_hash& hash)
+{
+	stream << hash.level << hash.tick;
+	for (short i = 0; i < NUMBER_OF_GAME_STATE_HASH_SECTIONS; ++i)
+	{
+		stream << static_cast<uint32>(hash.sections[i] >> 32) << static_cast<uint32>(hash.sections[i]);
+	}
+}
+
+static void unpack_game_state_hash(AIStreamBE& stream, game_state_hash& hash)
+{
+	stream >> hash.level >> hash.tick;
+	for (short i = 0; i < NUMBER_OF_GAME_STATE_HASH_SECTIONS; ++i)
+	{
+		uint32 high, low;
+		stream >> high >> low;
+		hash.sections[i] = (static_cast<uint64_t>(high) << 32) | low;
+	}
+}
+
+/* ---------- films */
+
+static bool recording_hashes = false;
+static std::vector<game_state_hash> recorded_hashes;
+
+static std::vector<game_state_hash> replay_hashes;
+static size_t next_replay_hash = 0;
+static bool replay_diverged = false;
+static game_state_hash replay_expected_hash, replay_actual_hash;
+
+void reset_recorded_game_state_hashes()
+{
+	recorded_hashes.clear();
+
+	// only replays aren't recorded
+	replay_hashes.clear();
+	next_replay_hash = 0;
+	replay_diverged = false;
+}
+
+void start_recording_game_state_hashes()
+{
+	reset_recorded_game_state_hashes();
+	recording_hashes = true;
+}
+
+void stop_recording_game_state_hashes()
+{
+	recording_hashes = false;
+	recorded_hashes.clear();
+}
+
+// after the film's action flags, where older versions don't look
+bool write_recorded_game_state_hashes(OpenedFile& file)
+{
+	std::vector<uint8> buffer(4 + 2 + 2 + 4 + recorded_hashes.size() * SIZEOF_game_state_hash);
+	AOStreamBE stream(buffer.data(), buffer.size());
+
+	try
+	{
+		stream << GAME_STATE_HASH_FILM_TAG
+			   << static_cast<int16>(NUMBER_OF_GAME_STATE_HASH_SECTIONS)
+			   << static_cast<int16>(GAME_STATE_HASH_INTERVAL)
+			   << static_cast<uint32>(recorded_hashes.size());
+
+		for (auto& hash : recorded_hashes)
+		{
+			pack_game_state_hash(stream, hash);
+		}
+	}
+	catch (const AStream::failure&)
+	{
+		return false;
+	}
+
+	return file.Write(static_cast<int32>(buffer.size()), buffer.data());
+}
+
+void start_replay_game_state_hashes(OpenedFile& file, int32 offset)
+{
+	stop_recording_game_state_hashes();
+	reset_recorded_game_state_hashes();
+
+	int32 length, position;
+	if (!file.GetLength(length) || !file.GetPosition(position) || length - offset < 12) return;
+
+	std::vector<uint8> buffer(length - offset);
+	bool read = file.SetPosition(offset) && file.Read(static_cast<int32>(buffer.size()), buffer.data());
+	file.SetPosition(position);
+	if (!read) return;
+
+	AIStreamBE stream(buffer.data(), buffer.size());
+
+	try
+	{
+		uint32 tag, count;
+		int16 section_count, interval;
+		stream >> tag >> section_count >> interval >> count;
+		if (tag != GAME_STATE_HASH_FILM_TAG || section_count != NUMBER_OF_GAME_STATE_HASH_SECTIONS || interval != GAME_STATE_HASH_INTERVAL) return;
+
+		// a garbage count would have us allocate far more than the trailer holds
+		if (count > (buffer.size() - 12) / SIZEOF_game_state_hash)
+		{
+			logWarning("film has a damaged game state hash trailer; not checking it");
+			return;
+		}
+
+		replay_hashes.resize(count);
+		for (auto& hash : replay_hashes)
+		{
+			unpack_game_state_hash(stream, hash);
+		}
+	}
+	catch (const AStream::failure&)
+	{
+		logWarning("film has a damaged game state hash trailer; not checking it");
+		replay_hashes.clear();
+	}
+}
+
+bool get_replay_game_state_divergence(game_state_hash& expected, game_state_hash& actual)
+{
+	if (!replay_diverged) return false;
+
+	expected = replay_expected_hash;
+	actual = replay_actual_hash;
+	return true;
+}
+
+static void check_replay_game_state_hash(const game_state_hash& hash)
+{
+	if (replay_diverged || next_replay_hash >= replay_hashes.size()) return;
+
+	const game_state_hash& expected = replay_hashes[next_replay_hash++];
+	short section = compare_game_state_hashes(expected, hash);
+	if (section != NONE)
+	{
+		replay_diverged = true;
+		replay_expected_hash = expected;
+		replay_actual_hash = hash;
+		logError("film went out of sync by level %d tick %d: %s differ", hash.level, hash.tick, get_game_state_hash_section_name(section));
+	}
+}
+
+/* ---------- network games */
+
+#if !defined(DISABLE_NETWORKING)
+
+// how many of our own hashes to keep for players who are behind us
+static const size_t MAXIMUM_LOCAL_NETWORK_HASHES = 16;
+static const size_t MAXIMUM_PENDING_NETWORK_HASHES = 4 * MAXIMUM_NUMBER_OF_PLAYERS;
+
+static std::deque<game_state_hash> local_network_hashes;
+static std::vector<std::pair<short, game_state_hash> > pending_network_hashes;
+static bool reported_out_of_sync[MAXIMUM_NUMBER_OF_PLAYERS];
+static int16 network_hash_level = NONE;
+
+// filled in on the network thread, under the mytm mutex
+static std::vector<std::pair<short, game_state_hash> > received_network_hashes;
+
+static void received_game_state_hash(void *buffer, short buffer_size, short player_index)
+{
+	if (buffer_size != SIZEOF_game_state_hash || received_network_hashes.size() >= MAXIMUM_PENDING_NETWORK_HASHES) return;
+
+	AIStreamBE stream(static_cast<uint8 *>(buffer), buffer_size);
+	game_state_hash hash;
+	unpack_game_state_hash(stream, hash);
+	received_network_hashes.push_back(std::make_pair(player_index, hash));
+}
+
+static void check_network_game_state_hashes(const game_state_hash& hash)
+{
+	static bool distribution_function_added = false;
+	if (!distribution_function_added)
+	{
+		NetAddDistributionFunction(kGameStateHashDistributionTypeID, received_game_state_hash, true);
+		distribution_function_added = true;
+	}
+
+	if (hash.level != network_hash_level)
+	{
+		network_hash_level = hash.level;
+		local_network_hashes.clear();
+		pending_network_hashes.clear();
+		objlist_clear(reported_out_of_sync, MAXIMUM_NUMBER_OF_PLAYERS);
+	}
+
+	uint8 buffer[SIZEOF_game_state_hash];
+	AOStreamBE stream(buffer, sizeof(buffer));
+	pack_game_state_hash(stream, hash);
+	NetDistributeInformation(kGameStateHashDistributionTypeID, buffer, sizeof(buffer), false);
+
+	local_network_hashes.push_back(hash);
+	if (local_network_hashes.size() > MAXIMUM_LOCAL_NETWORK_HASHES)
+	{
+		local_network_hashes.pop_front();
+	}
+
+	{
+		MyTMMutexTaker mutex;
+		pending_network_hashes.insert(pending_network_hashes.end(), received_network_hashes.begin(), received_network_hashes.end());
+		received_network_hashes.clear();
+	}
+
+	// anything from a player ahead of us waits until we get there
+	std::vector<std::pair<short, game_state_hash> > still_pending;
+	for (auto& remote : pending_network_hashes)
+	{
+		short player_index = remote.first;
+		const game_state_hash& remote_hash = remote.second;
+		if (remote_hash.level != hash.level || player_index < 0 || player_index >= dynamic_world->player_count) continue;
+
+		if (remote_hash.tick > hash.tick)
+		{
+			if (still_pending.size() < MAXIMUM_PENDING_NETWORK_HASHES)
+				still_pending.push_back(remote);
+			continue;
+		}
+
+		for (auto& local_hash : local_network_hashes)
+		{
+			if (local_hash.tick != remote_hash.tick) continue;
+
+			short section = compare_game_state_hashes(local_hash, remote_hash);
+			if (section != NONE && !reported_out_of_sync[player_index])
+			{
+				reported_out_of_sync[player_index] = true;
+				logError("out of sync with player %d at tick %d: %s differ", player_index, remote_hash.tick, get_game_state_hash_section_name(section));
+				screen_printf("Out of sync with %s (%s)", get_player_data(player_index)->name, get_game_state_hash_section_name(section));
+			}
+			break;
+		}
+	}
+	pending_network_hashes.swap(still_pending);
+}
+
+#endif // !defined(DISABLE_NETWORKING)
+
+void update_game_state_hash()
+{
+	if (dynamic_world->tick_count % GAME_STATE_HASH_INTERVAL) return;
+
+	game_state_hash hash;
+	compute_game_state_hash(hash);
+
+	if (recording_hashes)
+		recorded_hashes.push_back(hash);
+	check_replay_game_state_hash(hash);
+
+#if !defined(DISABLE_NETWORKING)
+	if (game_is_networked)
+	{
+		check_network_game_state_hashes(hash);
+	}
+#endif
+}
@@ -0,0 +1,83 @@
+#ifndef GAME_STATE_HASH_H
+#define GAME_STATE_HASH_H
+
+/*
+GAME_STATE_HASH.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+ 
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Hashes of the simulation state, taken every GAME_STATE_HASH_INTERVAL ticks, for
+	catching games that go out of sync: they are written after the action flags in
+	films and checked on replay, and exchanged between players in network games.
+
+	Each section hashes the fields of the used slots that every machine computes the
+	same way (not render flags, interface state or padding), as values rather than
+	bytes, so hashes agree across platforms.
+*/
+
+#include "cstypes.h"
+
+#include <vector>
+
+class OpenedFile;
+
+enum /* game state hash sections */
+{
+	_hash_world, // tick count, random seed and slot counts
+	_hash_players,
+	_hash_monsters,
+	_hash_objects,
+	_hash_projectiles,
+	_hash_effects,
+	_hash_platforms,
+	_hash_lights,
+	_hash_medias,
+	NUMBER_OF_GAME_STATE_HASH_SECTIONS
+};
+
+// ticks between hashes
+const int GAME_STATE_HASH_INTERVAL = 30;
+
+struct game_state_hash
+{
+	int16 level;
+	int32 tick;
+	uint64_t sections[NUMBER_OF_GAME_STATE_HASH_SECTIONS];
+
+	uint64_t combined() const;
+};
+
+void compute_game_state_hash(game_state_hash& hash);
+const char *get_game_state_hash_section_name(short section);
+
+// the first section that differs, or NONE
+short compare_game_state_hashes(const game_state_hash& a, const game_state_hash& b);
+
+// called after every tick of the simulation
+void update_game_state_hash();
+
+/* films: the hashes of the game being recorded, and those of the film being replayed */
+void reset_recorded_game_state_hashes();
+void start_recording_game_state_hashes();	// hashes are only kept while a film is recorded
+void stop_recording_game_state_hashes();
+bool write_recorded_game_state_hashes(OpenedFile& file);
+void start_replay_game_state_hashes(OpenedFile& file, int32 offset);
+
+// true, with the film's hash and ours, if the replay went out of sync
+bool get_replay_game_state_divergence(game_state_hash& expected, game_state_hash& actual);
+
+#endif
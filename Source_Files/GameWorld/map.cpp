@@ -91,6 +91,10 @@ Feb 3, 2003 (Loren Petrich):
 
  June 14, 2003 (Woody Zenfell):
 	New functions for manipulating polygons' object lists (in support of prediction).
+
+Oct 16, 2026:
+	Added the polygon grid and find_monsters_in_range(), so range queries only walk the
+	object lists of polygons near the point instead of every monster on the map.
  */
 
 /*
@@ -123,6 +127,7 @@ find_line_crossed leaving polygon could be sped up considerable by reversing the
 #include <stdlib.h>
 #include <limits.h>
 
+#include <algorithm>
 #include <list>
 
 /* ---------- structures */
@@ -947,6 +952,180 @@ perform_deferred_polygon_object_list_manipulations()
 
 
 
+/* ---------- polygon grid */
+
+/* each cell lists the polygons whose bounding boxes overlap it.  an object is always inside its
+	polygon, and translate_map_object() keeps it in that polygon’s object list, so finding the
+	objects near a point only needs the (unchanging) map geometry stored here */
+#define POLYGON_GRID_CELL_SIZE (2*WORLD_ONE)
+
+static world_point2d polygon_grid_origin;
+static short polygon_grid_width= 0, polygon_grid_height= 0;
+static std::vector<int32> polygon_grid_first_polygon; /* per cell, plus one past the end */
+static std::vector<short> polygon_grid_polygons;
+static std::vector<uint32> polygon_grid_stamps; /* per polygon; == polygon_grid_stamp once visited */
+static uint32 polygon_grid_stamp= 0;
+
+static void get_polygon_bounds(
+	short polygon_index,
+	world_point2d *minimum,
+	world_point2d *maximum)
+{
+	struct polygon_data *polygon= get_polygon_data(polygon_index);
+	short i;
+	
+	*minimum= *maximum= get_endpoint_data(polygon->endpoint_indexes[0])->vertex;
+	for (i= 1; i<polygon->vertex_count; ++i)
+	{
+		world_point2d *vertex= &get_endpoint_data(polygon->endpoint_indexes[i])->vertex;
+		
+		minimum->x= MIN(minimum->x, vertex->x), maximum->x= MAX(maximum->x, vertex->x);
+		minimum->y= MIN(minimum->y, vertex->y), maximum->y= MAX(maximum->y, vertex->y);
+	}
+}
+
+/* the cell containing the given offset from the grid origin, clipped to the grid */
+static short polygon_grid_cell(
+	int32 offset,
+	short cell_count)
+{
+	return offset<0 ? 0 : static_cast<short>(MIN(offset/POLYGON_GRID_CELL_SIZE, cell_count-1));
+}
+
+void build_polygon_grid(
+	void)
+{
+	world_point2d minimum, maximum;
+	std::vector<int32> cell_counts;
+	short polygon_index;
+	int32 cell_count;
+	
+	polygon_grid_width= polygon_grid_height= 0;
+	polygon_grid_first_polygon.assign(1, 0);
+	polygon_grid_polygons.clear();
+	polygon_grid_stamps.assign(dynamic_world->polygon_count, 0);
+	polygon_grid_stamp= 0;
+	if (!dynamic_world->polygon_count) return;
+	
+	get_polygon_bounds(0, &minimum, &maximum);
+	for (polygon_index= 1; polygon_index<dynamic_world->polygon_count; ++polygon_index)
+	{
+		world_point2d polygon_minimum, polygon_maximum;
+		
+		get_polygon_bounds(polygon_index, &polygon_minimum, &polygon_maximum);
+		minimum.x= MIN(minimum.x, polygon_minimum.x), maximum.x= MAX(maximum.x, polygon_maximum.x);
+		minimum.y= MIN(minimum.y, polygon_minimum.y), maximum.y= MAX(maximum.y, polygon_maximum.y);
+	}
+	
+	polygon_grid_origin= minimum;
+	polygon_grid_width= static_cast<short>((int32(maximum.x)-minimum.x)/POLYGON_GRID_CELL_SIZE + 1);
+	polygon_grid_height= static_cast<short>((int32(maximum.y)-minimum.y)/POLYGON_GRID_CELL_SIZE + 1);
+	cell_count= int32(polygon_grid_width)*polygon_grid_height;
+	
+	/* count each cell’s polygons, turn the counts into offsets, then fill the cells in polygon
+		index order (so queries see polygons in the same order every time) */
+	cell_counts.assign(cell_count, 0);
+	for (int pass= 0; pass<2; ++pass)
+	{
+		for (polygon_index= 0; polygon_index<dynamic_world->polygon_count; ++polygon_index)
+		{
+			world_point2d polygon_minimum, polygon_maximum;
+			short left, right, top, bottom, x, y;
+			
+			get_polygon_bounds(polygon_index, &polygon_minimum, &polygon_maximum);
+			left= polygon_grid_cell(int32(polygon_minimum.x)-polygon_grid_origin.x, polygon_grid_width);
+			right= polygon_grid_cell(int32(polygon_maximum.x)-polygon_grid_origin.x, polygon_grid_width);
+			top= polygon_grid_cell(int32(polygon_minimum.y)-polygon_grid_origin.y, polygon_grid_height);
+			bottom= polygon_grid_cell(int32(polygon_maximum.y)-polygon_grid_origin.y, polygon_grid_height);
+			
+			for (y= top; y<=bottom; ++y)
+			{
+				for (x= left; x<=right; ++x)
+				{
+					int32 cell_index= int32(y)*polygon_grid_width + x;
+					
+					if (pass) polygon_grid_polygons[polygon_grid_first_polygon[cell_index] + cell_counts[cell_index]]= polygon_index;
+					cell_counts[cell_index]+= 1;
+				}
+			}
+		}
+		
+		if (!pass)
+		{
+			int32 cell_index;
+			
+			polygon_grid_first_polygon.resize(cell_count+1);
+			for (cell_index= 0; cell_index<cell_count; ++cell_index)
+			{
+				polygon_grid_first_polygon[cell_index+1]= polygon_grid_first_polygon[cell_index] + cell_counts[cell_index];
+			}
+			polygon_grid_polygons.resize(polygon_grid_first_polygon[cell_count]);
+			cell_counts.assign(cell_count, 0);
+		}
+	}
+}
+
+void find_monsters_in_range(
+	world_point2d *location,
+	world_distance range,
+	std::vector<short>& monster_indexes)
+{
+	int32 left= int32(location->x)-range-polygon_grid_origin.x;
+	int32 right= int32(location->x)+range-polygon_grid_origin.x;
+	int32 top= int32(location->y)-range-polygon_grid_origin.y;
+	int32 bottom= int32(location->y)+range-polygon_grid_origin.y;
+	short x, y;
+	
+	monster_indexes.clear();
+	if (!polygon_grid_width || right<0 || bottom<0 ||
+		left>=int32(polygon_grid_width)*POLYGON_GRID_CELL_SIZE || top>=int32(polygon_grid_height)*POLYGON_GRID_CELL_SIZE)
+	{
+		return;
+	}
+	
+	if (!++polygon_grid_stamp)
+	{
+		std::fill(polygon_grid_stamps.begin(), polygon_grid_stamps.end(), 0);
+		polygon_grid_stamp= 1;
+	}
+	
+	for (y= polygon_grid_cell(top, polygon_grid_height); y<=polygon_grid_cell(bottom, polygon_grid_height); ++y)
+	{
+		for (x= polygon_grid_cell(left, polygon_grid_width); x<=polygon_grid_cell(right, polygon_grid_width); ++x)
+		{
+			int32 cell_index= int32(y)*polygon_grid_width + x;
+			int32 i;
+			
+			for (i= polygon_grid_first_polygon[cell_index]; i<polygon_grid_first_polygon[cell_index+1]; ++i)
+			{
+				short polygon_index= polygon_grid_polygons[i];
+				short object_index;
+				
+				if (polygon_grid_stamps[polygon_index]==polygon_grid_stamp) continue;
+				polygon_grid_stamps[polygon_index]= polygon_grid_stamp;
+				
+				for (object_index= get_polygon_data(polygon_index)->first_object; object_index!=NONE; )
+				{
+					struct object_data *object= get_object_data(object_index);
+					
+					if (GET_OBJECT_OWNER(object)==_object_is_monster &&
+						std::abs(int32(object->location.x)-location->x)<=range &&
+						std::abs(int32(object->location.y)-location->y)<=range)
+					{
+						monster_indexes.push_back(object->permutation);
+					}
+					object_index= object->next_object;
+				}
+			}
+		}
+	}
+	
+	/* every object is in exactly one polygon list, so there are no duplicates to remove */
+	std::sort(monster_indexes.begin(), monster_indexes.end());
+}
+
+
+
 /* if a new polygon index is supplied, it will be used, otherwise we’ll try to find the new
 	polygon index ourselves */
 bool translate_map_object(
@@ -317,9 +317,11 @@ const int SIZEOF_random_sound_image_data = 32;
 #define MARK_SLOT_AS_FREE(o) ((o)->flags&=(uint16)~0xC000)
 #define MARK_SLOT_AS_USED(o) ((o)->flags=((o)->flags|(uint16)0x8000)&(uint16)~0x4000)
 
-#define OBJECT_WAS_RENDERED(o) ((o)->flags&(uint16)0x4000)
-#define SET_OBJECT_RENDERED_FLAG(o) ((o)->flags|=(uint16)0x4000)
-#define CLEAR_OBJECT_RENDERED_FLAG(o) ((o)->flags&=(uint16)~0x4000)
+enum { _object_was_rendered = 0x4000 };
+
+#define OBJECT_WAS_RENDERED(o) ((o)->flags&(uint16)_object_was_rendered)
+#define SET_OBJECT_RENDERED_FLAG(o) ((o)->flags|=(uint16)_object_was_rendered)
+#define CLEAR_OBJECT_RENDERED_FLAG(o) ((o)->flags&=(uint16)~_object_was_rendered)
 
 /* this field is only valid after transmogrify_object_shape is called; in terms of our pipeline, that
 	means that it’s only valid if OBJECT_WAS_RENDERED returns true *and* was cleared before
@@ -1108,6 +1110,10 @@ std::pair<bool, int16> update_world(void);
 void reset_intermediate_action_queues();
 void set_prediction_wanted(bool inPrediction);
 
+/* headless film playback: runs one tick from the film being replayed with no speed limiter,
+	interface or rendering; returns false once the film has run out */
+bool update_world_from_replay(void);
+
 /* Called to activate lights, platforms, etc. (original polygon may be NONE) */
 void changed_polygon(short original_polygon_index, short new_polygon_index, short player_index);
 
@@ -1155,6 +1161,15 @@ extern void deferred_add_object_to_polygon_object_list(short object_index, short
 // deferred_add_object_to_polygon_object_list() was called!
 extern void perform_deferred_polygon_object_list_manipulations();
 
+// buckets the level's polygons by location for find_monsters_in_range(); call once the level's
+// geometry is loaded
+extern void build_polygon_grid(void);
+
+// clears monster_indexes, then fills it in monster index order with every monster (players
+// included) whose object is within range of location along both axes; callers do their own
+// distance and activity tests
+extern void find_monsters_in_range(world_point2d *location, world_distance range, std::vector<short>& monster_indexes);
+
 
 
 struct shape_and_transfer_mode
@@ -1320,6 +1335,7 @@ uint8 *pack_map_object(uint8 *Stream, map_object* Objects, size_t Count);
 uint8 *unpack_object_frequency_definition(uint8 *Stream, object_frequency_definition* Objects, size_t Count);
 uint8 *pack_object_frequency_definition(uint8 *Stream, object_frequency_definition* Objects, size_t Count);
 uint8 *unpack_static_data(uint8 *Stream, static_data* Objects, size_t Count);
+uint8 *unpack_directory_data(uint8 *Stream, directory_data* Objects, size_t Count);
 uint8 *pack_static_data(uint8 *Stream, static_data* Objects, size_t Count);
 
 uint8 *unpack_ambient_sound_image_data(uint8 *Stream, ambient_sound_image_data* Objects, size_t Count);
@@ -368,6 +368,9 @@ void recalculate_redundant_line_data(
 	SET_LINE_VARIABLE_ELEVATION(line, variable_elevation && !LINE_IS_SOLID(line));
 	SET_LINE_LANDSCAPE_STATUS(line, landscaped);
 	SET_LINE_HAS_TRANSPARENT_SIDE(line, transparent_texture);
+
+	update_polygon_adjacency_graph_line(line_index);
+	invalidate_path_cache();
 }
 
 void recalculate_redundant_side_data(
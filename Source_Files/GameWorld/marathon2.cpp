@@ -72,6 +72,14 @@ Feb 8, 2003 (Woody Zenfell):
 	Player movement prediction support:
 	+ Support for retaining a partial game-state (this could be moved out to another file)
 	+ Changes to update_world() to take advantage of partial game-state saving/restoring.
+
+Oct 16, 2026:
+	Per-subsystem profiling of update_world_elements_one_tick(), and
+	update_world_from_replay() for running films without the interface.
+	Prediction now rolls back the whole dynamic world with a WorldSnapshot,
+	rather than the local players' records alone.
+	Game state hashes every GAME_STATE_HASH_INTERVAL ticks, for catching
+	films and network games that go out of sync.
 */
 
 #include "cseries.h"
@@ -120,12 +128,15 @@ Feb 8, 2003 (Woody Zenfell):
 #include "Statistics.h"
 
 #include "motion_sensor.h"
+#include "TickProfiler.h"
 
 #include <limits.h>
 #include <thread>
 
 #include "ephemera.h"
 #include "interpolated_world.h"
+#include "world_snapshot.h"
+#include "game_state_hash.h"
 
 /* ---------- constants */
 
@@ -198,42 +209,17 @@ set_prediction_wanted(bool inPrediction)
 	sPredictionWanted= inPrediction;
 }
 
-static player_data sSavedPlayerData[MAXIMUM_NUMBER_OF_PLAYERS];
-static monster_data sSavedPlayerMonsterData[MAXIMUM_NUMBER_OF_PLAYERS];
-static object_data sSavedPlayerObjectData[MAXIMUM_NUMBER_OF_PLAYERS];
-static object_data sSavedPlayerParasiticObjectData[MAXIMUM_NUMBER_OF_PLAYERS];
-static short sSavedPlayerObjectNextObject[MAXIMUM_NUMBER_OF_PLAYERS];
-
-// For sanity-checking...
-static int32 sSavedTickCount;
-static uint16 sSavedRandomSeed;
+// the whole dynamic world as it was before the first predicted tick
+static WorldSnapshot sPredictionSnapshot;
 
 
-// ZZZ: If not already in predictive mode, save off partial game-state for later restoration.
+// ZZZ: If not already in predictive mode, save off the game-state for later restoration.
 static void
 enter_predictive_mode()
 {
 	if(sPredictedTicks == 0)
 	{
-		for(short i = 0; i < dynamic_world->player_count; i++)
-		{
-			sSavedPlayerData[i] = *get_player_data(i);
-			if(sSavedPlayerData[i].monster_index != NONE)
-			{
-				sSavedPlayerMonsterData[i] = *get_monster_data(sSavedPlayerData[i].monster_index);
-				if(sSavedPlayerMonsterData[i].object_index != NONE)
-				{
-					sSavedPlayerObjectData[i] = *get_object_data(sSavedPlayerMonsterData[i].object_index);
-					sSavedPlayerObjectNextObject[i] = sSavedPlayerObjectData[i].next_object;
-					if(sSavedPlayerObjectData[i].parasitic_object != NONE)
-						sSavedPlayerParasiticObjectData[i] = *get_object_data(sSavedPlayerObjectData[i].parasitic_object);
-				}
-			}
-		}
-		
-		// Sanity checking
-		sSavedTickCount = dynamic_world->tick_count;
-		sSavedRandomSeed = get_random_seed();
+		sPredictionSnapshot.Take();
 	}
 }
 
@@ -283,62 +269,29 @@ exit_predictive_mode()
 {
 	if(sPredictedTicks > 0)
 	{
+		// We *don't* restore this tiny part of the game-state back because
+		// otherwise the player can't use [] to scroll the inventory panel.
+		// [] scrolling happens outside the normal input/update system, so that's
+		// enough to persuade me that not restoring this won't OOS any more often
+		// than []-scrolling did before prediction.  :)
+		int16 saved_interface_flags[MAXIMUM_NUMBER_OF_PLAYERS];
+		int16 saved_interface_decay[MAXIMUM_NUMBER_OF_PLAYERS];
 		for(short i = 0; i < dynamic_world->player_count; i++)
 		{
-			player_data* player = get_player_data(i);
-			
-			assert(player->monster_index == sSavedPlayerData[i].monster_index);
+			saved_interface_flags[i] = get_player_data(i)->interface_flags;
+			saved_interface_decay[i] = get_player_data(i)->interface_decay;
+		}
 
-			{
-				// We *don't* restore this tiny part of the game-state back because
-				// otherwise the player can't use [] to scroll the inventory panel.
-				// [] scrolling happens outside the normal input/update system, so that's
-				// enough to persuade me that not restoring this won't OOS any more often
-				// than []-scrolling did before prediction.  :)
-				int16 saved_interface_flags = player->interface_flags;
-				int16 saved_interface_decay = player->interface_decay;
-				
-				*player = sSavedPlayerData[i];
-
-				player->interface_flags = saved_interface_flags;
-				player->interface_decay = saved_interface_decay;
-			}
+		if(!sPredictionSnapshot.Restore())
+			logWarning("couldn't roll back %d predicted ticks", static_cast<int>(sPredictedTicks));
 
-			if(sSavedPlayerData[i].monster_index != NONE)
-			{
-				assert(get_monster_data(sSavedPlayerData[i].monster_index)->object_index == sSavedPlayerMonsterData[i].object_index);
-
-				*get_monster_data(sSavedPlayerData[i].monster_index) = sSavedPlayerMonsterData[i];
-				
-				if(sSavedPlayerMonsterData[i].object_index != NONE)
-				{
-					assert(get_object_data(sSavedPlayerMonsterData[i].object_index)->parasitic_object == sSavedPlayerObjectData[i].parasitic_object);
-
-					remove_object_from_polygon_object_list(sSavedPlayerMonsterData[i].object_index);
-					
-					*get_object_data(sSavedPlayerMonsterData[i].object_index) = sSavedPlayerObjectData[i];
-
-					// We have to defer this insertion since the object lists could still have other players
-					// in their predictive locations etc. - we need to reconstruct everything exactly as it
-					// was when we entered predictive mode.
-					deferred_add_object_to_polygon_object_list(sSavedPlayerMonsterData[i].object_index, sSavedPlayerObjectNextObject[i]);
-					
-					if(sSavedPlayerObjectData[i].parasitic_object != NONE)
-						*get_object_data(sSavedPlayerObjectData[i].parasitic_object) = sSavedPlayerParasiticObjectData[i];
-				}
-			}
+		for(short i = 0; i < dynamic_world->player_count; i++)
+		{
+			get_player_data(i)->interface_flags = saved_interface_flags[i];
+			get_player_data(i)->interface_decay = saved_interface_decay[i];
 		}
 
-		perform_deferred_polygon_object_list_manipulations();
-		
 		sPredictedTicks = 0;
-
-		// Sanity checking
-		if(sSavedTickCount != dynamic_world->tick_count)
-			logWarning("saved tick count %d != dynamic_world->tick_count %d", sSavedTickCount, dynamic_world->tick_count);
-
-		if(sSavedRandomSeed != get_random_seed())
-			logWarning("saved random seed %d != get_random_seed() %d", sSavedRandomSeed, get_random_seed());
 	}
 }
 
@@ -402,38 +355,38 @@ update_world_elements_one_tick(bool& call_postidle)
 	else
 	{
 		decode_hotkeys(*GameQueue);
-		L_Call_Idle();
+		PROFILE_CALL(_profile_lua, L_Call_Idle());
 		call_postidle = true;
 		
-		update_lights();
-		update_medias();
-		update_platforms();
+		PROFILE_CALL(_profile_lights, update_lights());
+		PROFILE_CALL(_profile_medias, update_medias());
+		PROFILE_CALL(_profile_platforms, update_platforms());
 		
-		update_control_panels(); // don't put after update_players
-		update_players(GameQueue, false);
-		move_projectiles();
-		move_monsters();
-		update_effects();
-		recreate_objects();
+		PROFILE_CALL(_profile_control_panels, update_control_panels()); // don't put after update_players
+		PROFILE_CALL(_profile_players, update_players(GameQueue, false));
+		PROFILE_CALL(_profile_projectiles, move_projectiles());
+		PROFILE_CALL(_profile_monsters, move_monsters());
+		PROFILE_CALL(_profile_effects, update_effects());
+		PROFILE_CALL(_profile_objects, recreate_objects());
 		
-		handle_random_sound_image();
-		animate_scenery();
+		PROFILE_CALL(_profile_ambient_sounds, handle_random_sound_image());
+		PROFILE_CALL(_profile_scenery, animate_scenery());
 
-		update_ephemera();
+		PROFILE_CALL(_profile_ephemera, update_ephemera());
 		
 		// LP additions:
 		if (film_profile.animate_items)
 		{
-			animate_items();
+			PROFILE_CALL(_profile_items, animate_items());
 		}
 		
-		AnimTxtr_Update();
-		ChaseCam_Update();
-		motion_sensor_scan();
-		check_m1_exploration();
+		PROFILE_CALL(_profile_textures, AnimTxtr_Update());
+		PROFILE_CALL(_profile_chase_cam, ChaseCam_Update());
+		PROFILE_CALL(_profile_motion_sensor, motion_sensor_scan());
+		PROFILE_CALL(_profile_exploration, check_m1_exploration());
 		
 #if !defined(DISABLE_NETWORKING)
-		update_net_game();
+		PROFILE_CALL(_profile_network, update_net_game());
 #endif // !defined(DISABLE_NETWORKING)
 	}
 
@@ -453,6 +406,8 @@ update_world_elements_one_tick(bool& call_postidle)
         dynamic_world->tick_count+= 1;
         dynamic_world->game_information.game_time_remaining-= 1;
 
+        update_game_state_hash();
+
         return kUpdateNormalCompletion;
 }
 
@@ -524,7 +479,7 @@ update_world()
 		theElapsedTime++;
 		
 		if (call_postidle)
-			L_Call_PostIdle();
+			PROFILE_CALL(_profile_lua, L_Call_PostIdle());
 		if(theUpdateResult != kUpdateNormalCompletion || Movie::instance()->IsRecording())
 		{
 			canUpdate = false;
@@ -600,6 +555,29 @@ update_world()
 	return std::pair<bool, int16>(didPredict || theElapsedTime != 0, theElapsedTime);
 }
 
+/* the simulation half of update_world(), driven straight from the film: no heartbeat speed
+	limiter, prediction, interpolation, interface updates or rendering */
+bool update_world_from_replay()
+{
+	if (GameQueue->countActionFlags(0) == 0)
+	{
+		if (!pull_replay_flags_for_one_tick())
+		{
+			return false;
+		}
+
+		overlay_queue_with_queue_into_queue(GetRealActionQueues(), GetLuaActionQueues(), GameQueue);
+	}
+
+	bool call_postidle = true;
+	int theUpdateResult = update_world_elements_one_tick(call_postidle);
+
+	if (call_postidle)
+		PROFILE_CALL(_profile_lua, L_Call_PostIdle());
+
+	return theUpdateResult != kUpdateGameOver;
+}
+
 /* call this function before leaving the old level, but DO NOT call it when saving the player.
 	it should be called when you're leaving the game (i.e., quitting or reverting, etc.) */
 void leaving_map(
@@ -89,6 +89,10 @@ Oct 26, 2000 (Mark Levin)
 
 Jan 12, 2003 (Loren Petrich)
 	Added controllable damage kicks
+
+Oct 16, 2026:
+	possible_intersecting_monsters() rejects duplicates with a bitset instead of searching
+	the list, and stops walking neighbors once nothing more can be added
 */
 
 #include <string.h>
@@ -166,6 +170,13 @@ enum /* monster attitudes, extracted from enemies and friends bitfields by get_m
 	_hostile
 };
 
+enum /* pathfinding cost dependencies, for the path cache */
+{
+	_depends_on_platform, /* index is a platform; value is a signature of its state */
+	_depends_on_monster_presence, /* index is a polygon; value is whether it holds any monsters */
+	_depends_on_flooding /* index is a polygon; value is whether find_flooding_polygon() succeeds */
+};
+
 enum /* returned by find_obstructing_terrain_feature() */
 {
 	_standing_on_sniper_ledge,
@@ -237,6 +248,10 @@ struct damage_kick_definition damage_kick_definitions[NUMBER_OF_DAMAGE_TYPES] =
 /* import monster definition constants, structures and globals */
 #include "monster_definitions.h"
 
+/* one bit per object slot, set while that object is in the list possible_intersecting_monsters()
+	is filling; always cleared again before it returns */
+static vector<uint32> intersecting_object_bits;
+
 /* ---------- private prototypes */
 
 static monster_definition *get_monster_definition(
@@ -276,6 +291,9 @@ static void update_monster_physics_model(short monster_index);
 static int32 monster_activation_flood_proc(short source_polygon_index, short line_index,
 	short destination_polygon_index, void *data);
 
+static int32 monster_pathfinding_dependency(short kind, short index);
+static int32 polygon_holds_monsters(short polygon_index);
+
 static bool attempt_evasive_manouvers(short monster_index);
 
 static short nearest_goal_polygon_index(short polygon_index);
@@ -760,7 +778,7 @@ void initialize_monsters_for_new_level(
 
 static void load_sound(short sound_index)
 {
-	SoundManager::instance()->LoadSound(sound_index);
+	SoundManager::instance()->PrefetchSound(sound_index);
 }
 
 void load_monster_sounds(
@@ -775,7 +793,7 @@ void load_monster_sounds(
 		load_projectile_sounds(definition->ranged_attack.type);
 		load_projectile_sounds(definition->melee_attack.type);
 		
-		SoundManager::instance()->LoadSounds(&definition->activation_sound, 8);
+		SoundManager::instance()->PrefetchSounds(&definition->activation_sound, 8);
 	}
 }
 
@@ -925,7 +943,7 @@ static int32 monster_activation_flood_proc(
 	int32 *flags=(int32 *)data;
 	struct polygon_data *destination_polygon= get_polygon_data(destination_polygon_index);
 	struct polygon_data *source_polygon= get_polygon_data(source_polygon_index);
-	struct line_data *line= get_line_data(line_index);
+	struct polygon_edge_data *edge= get_flood_map_edge();
 	bool obey_glue= (static_world->environment_flags&_environment_glue_m1);
 	bool limit_activation= (static_world->environment_flags&_environment_activation_ranges);
 	int32 cost= limit_activation ? source_polygon->area : 1;
@@ -969,7 +987,7 @@ static int32 monster_activation_flood_proc(
 		cost= -1;
 	}
 
-	if (!((*flags)&_pass_solid_lines) && LINE_IS_SOLID(line)) cost= -1;
+	if (!((*flags)&_pass_solid_lines) && LINE_IS_SOLID(edge)) cost= -1;
 
 	if (cost>0 && limit_activation)
 	{
@@ -1153,6 +1171,19 @@ bool possible_intersecting_monsters(
 	// Skip this step if neighbor indexes were not found
 	if (!neighbor_indexes) return found_solid_object;
 
+	/* objects already in the list (callers may accumulate over several polygons) are marked
+		so that duplicates can be rejected without searching the list */
+	if (IntersectedObjectsPtr)
+	{
+		size_t word_count= (ObjectList.size()+31)/32;
+		if (intersecting_object_bits.size()<word_count) intersecting_object_bits.resize(word_count, 0);
+
+		for (short object_index : *IntersectedObjectsPtr)
+		{
+			intersecting_object_bits[object_index>>5]|= 1u<<(object_index&31);
+		}
+	}
+
 	for (short i=0;i<polygon->neighbor_count;++i)
 	{
 		struct polygon_data *neighboring_polygon= get_polygon_data(*neighbor_indexes++);
@@ -1191,23 +1222,38 @@ bool possible_intersecting_monsters(
 					{
 						found_solid_object= true;
 						
-						// LP change:
-						if (IntersectedObjectsPtr && IntersectedObjectsPtr->size()<maximum_object_count) /* do we have enough space to add it? */
+						/* once the list is full (or there is none) nothing else we find matters */
+						if (!IntersectedObjectsPtr || IntersectedObjectsPtr->size()>=maximum_object_count)
 						{
-							unsigned j;
-							
-							/* only add this object_index if it's not already in the list */
-							vector<short>& IntersectedObjects = *IntersectedObjectsPtr;
-							for (j=0; j<IntersectedObjects.size() && IntersectedObjects[j]!=object_index; ++j)
-								;
-							if (j==IntersectedObjects.size())
-								IntersectedObjects.push_back(object_index);
+							break;
+						}
+						
+						/* only add this object_index if it's not already in the list */
+						uint32& bits= intersecting_object_bits[object_index>>5];
+						uint32 bit= 1u<<(object_index&31);
+						if (!(bits&bit))
+						{
+							bits|= bit;
+							IntersectedObjectsPtr->push_back(object_index);
 						}
 					}
 				}
 				
 				object_index= object->next_object;
 			}
+
+			if (found_solid_object && (!IntersectedObjectsPtr || IntersectedObjectsPtr->size()>=maximum_object_count))
+			{
+				break;
+			}
+		}
+	}
+
+	if (IntersectedObjectsPtr)
+	{
+		for (short object_index : *IntersectedObjectsPtr)
+		{
+			intersecting_object_bits[object_index>>5]&= ~(1u<<(object_index&31));
 		}
 	}
 
@@ -2077,6 +2123,7 @@ static void generate_new_path_for_monster(
 	struct object_data *object= get_object_data(monster->object_index);
 	struct monster_definition *definition= get_monster_definition(monster->type);
 	struct monster_pathfinding_data data;
+	struct path_cost_class cost_class;
 	short destination_polygon_index;
 	world_point2d *destination;
 	world_vector2d bias;
@@ -2146,8 +2193,17 @@ static void generate_new_path_for_monster(
 	data.monster= monster;
 	data.cross_zone_boundaries= destination_polygon_index==NONE ? false : true;
 
+	/* monsters of the same size and abilities find the same paths */
+	obj_clear(cost_class);
+	cost_class.cost= monster_pathfinding_cost_function;
+	cost_class.dependency_proc= monster_pathfinding_dependency;
+	cost_class.parameters[0]= definition->height;
+	cost_class.parameters[1]= definition->radius;
+	cost_class.parameters[2]= (definition->minimum_ledge_delta<<16) | (uint16)definition->maximum_ledge_delta;
+	cost_class.parameters[3]= (definition->flags&(_monster_flys|_monster_floats)) | (data.cross_zone_boundaries ? 1 : 0);
+
 	monster->path= new_path((world_point2d *)&object->location, object->polygon, destination,
-		destination_polygon_index, 3*definition->radius, monster_pathfinding_cost_function, &data);
+		destination_polygon_index, 3*definition->radius, monster_pathfinding_cost_function, &data, &cost_class);
 	if (monster->path==NONE)
 	{
 		if (monster->action!=_monster_is_being_hit || MONSTER_IS_DYING(monster)) set_monster_action(monster_index, _monster_is_stationary);
@@ -3190,7 +3246,7 @@ int32 monster_pathfinding_cost_function(
 	struct monster_definition *definition= data->definition;
 	struct polygon_data *destination_polygon= get_polygon_data(destination_polygon_index);
 	struct polygon_data *source_polygon= get_polygon_data(source_polygon_index);
-	struct line_data *line= get_line_data(line_index);
+	struct polygon_edge_data *edge= get_flood_map_edge();
 	bool respect_polygon_heights= true;
 	struct object_data *object;
 	short object_index;
@@ -3199,8 +3255,26 @@ int32 monster_pathfinding_cost_function(
 	/* base cost is the area of the polygon we’re leaving */
 	cost= source_polygon->area;
 
+	assert(edge->line_index==line_index);
+	
+	/* platform heights and states decide most of what follows */
+	if (source_polygon->type==_polygon_is_platform)
+	{
+		note_path_cost_dependency(_depends_on_platform, source_polygon->permutation, monster_pathfinding_dependency(_depends_on_platform, source_polygon->permutation));
+	}
+	if (destination_polygon->type==_polygon_is_platform)
+	{
+		note_path_cost_dependency(_depends_on_platform, destination_polygon->permutation, monster_pathfinding_dependency(_depends_on_platform, destination_polygon->permutation));
+	}
+	
 	/* no solid lines (baby) */
-	if (LINE_IS_SOLID(line) && !LINE_IS_VARIABLE_ELEVATION(line)) cost= -1;
+	if (LINE_IS_SOLID(edge) && !LINE_IS_VARIABLE_ELEVATION(edge))
+	{
+		cost= -1;
+		
+		/* the obstruction cost below can make this positive again */
+		note_path_cost_dependency(_depends_on_monster_presence, destination_polygon_index, polygon_holds_monsters(destination_polygon_index));
+	}
 
 	/* count up the monsters in destination_polygon and add a constant cost, MONSTER_PATHFINDING_OBSTRUCTION_PENALTY,
 		for each of them to discourage overcrowding */
@@ -3227,9 +3301,13 @@ int32 monster_pathfinding_cost_function(
             // don't move into flooded platforms
             if ((static_world->environment_flags&_environment_ouch_m1) &&
                 !(definition->flags&(_monster_flys|_monster_floats)) &&
-                PLATFORM_IS_FLOODED(get_platform_data(destination_polygon->permutation)) &&
-                (find_flooding_polygon(destination_polygon_index) != NONE))
-                cost= -1;
+                PLATFORM_IS_FLOODED(get_platform_data(destination_polygon->permutation)))
+            {
+                int32 flooding= monster_pathfinding_dependency(_depends_on_flooding, destination_polygon_index);
+                
+                note_path_cost_dependency(_depends_on_flooding, destination_polygon_index, flooding);
+                if (flooding) cost= -1;
+            }
 		}
 		if (source_polygon->type==_polygon_is_platform)
 		{
@@ -3249,13 +3327,13 @@ int32 monster_pathfinding_cost_function(
 		world_distance delta_height= destination_polygon->floor_height-source_polygon->floor_height;
 		
 		if (delta_height<definition->minimum_ledge_delta||delta_height>definition->maximum_ledge_delta) cost= -1;
-		if (line->lowest_adjacent_ceiling-line->highest_adjacent_floor<definition->height) cost= -1;
+		if (edge->clearance<definition->height) cost= -1;
 		
 		if (cost>0) cost+= delta_height*delta_height; /* prefer not to change heights */
 	}
 	
 	/* if this line not wide enough, disallow the move */
-	if (line->length<2*definition->radius) cost= -1;
+	if (edge->length<2*definition->radius) cost= -1;
 
 	if (cost>0)
 	{
@@ -3301,6 +3379,63 @@ int32 monster_pathfinding_cost_function(
 	return cost;
 }
 
+/* the current value of something monster_pathfinding_cost_function() depended on */
+static int32 monster_pathfinding_dependency(
+	short kind,
+	short index)
+{
+	int32 value= 0;
+	
+	switch (kind)
+	{
+		case _depends_on_platform:
+		{
+			struct platform_data *platform= get_platform_data(index);
+			uint32 signature;
+			
+			/* everything monster_can_enter_platform() and monster_can_leave_platform() look at */
+			signature= platform->static_flags;
+			signature= signature*31 + platform->dynamic_flags;
+			signature= signature*31 + (uint16)platform->delay;
+			signature= signature*31 + (uint16)platform->floor_height;
+			signature= signature*31 + (uint16)platform->ceiling_height;
+			signature= signature*31 + (uint16)platform->minimum_floor_height;
+			signature= signature*31 + (uint16)platform->maximum_floor_height;
+			signature= signature*31 + (uint16)platform->minimum_ceiling_height;
+			signature= signature*31 + (uint16)platform->maximum_ceiling_height;
+			value= (int32)signature;
+			break;
+		}
+		
+		case _depends_on_monster_presence:
+			value= polygon_holds_monsters(index);
+			break;
+		
+		case _depends_on_flooding:
+			value= find_flooding_polygon(index)!=NONE;
+			break;
+		
+		default:
+			assert(false);
+			break;
+	}
+	
+	return value;
+}
+
+static int32 polygon_holds_monsters(
+	short polygon_index)
+{
+	short object_index;
+	
+	for (object_index= get_polygon_data(polygon_index)->first_object; object_index!=NONE; object_index= get_object_data(object_index)->next_object)
+	{
+		if (GET_OBJECT_OWNER(get_object_data(object_index))==_object_is_monster) return true;
+	}
+	
+	return false;
+}
+
 /* returns the type and index of any interesting terrain feature (platform or door) in front
 	of the given monster in his current direction; this lets us open doors and wait for
 	platforms.  relevant_polygon_index is the polygon_index we have to pass to platform_is_accessable */
@@ -34,12 +34,20 @@ Wednesday, June 14, 1995 8:35:28 AM  (Jason)
 
 Feb 10, 2000 (Loren Petrich):
 	Added dynamic-limits setting of MAXIMUM_PATHS
+
+Oct 16, 2026:
+	Added the path cache: the polygons a flood traversed are remembered per (source, destination,
+	cost class) along with the state the cost_proc’s answers depended on, so monsters chasing the
+	same target don’t each reflood the map.  Points are still generated (and random numbers
+	consumed) for every path, so cached and flooded paths are identical.
 */
 
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
 
+#include <vector>
+
 #include "cseries.h"
 #include "map.h"
 #include "flood_map.h"
@@ -68,6 +76,9 @@ we should cut corners instead of blindly following map geometry (i.e., separate
 
 #define PATH_VALIDATION_AREA_SIZE 64*1024
 
+#define MAXIMUM_CACHED_PATHS 64
+#define MAXIMUM_PATH_COST_DEPENDENCIES 64
+
 /* ---------- structures */
 
 struct path_definition /* 256 bytes */
@@ -79,10 +90,42 @@ struct path_definition /* 256 bytes */
 	world_point2d points[MAXIMUM_POINTS_PER_PATH];
 };
 
+struct path_cost_dependency
+{
+	int16 kind;
+	int16 index;
+	int32 value;
+};
+
+struct cached_path
+{
+	short source_polygon_index;
+	short destination_polygon_index;
+	struct path_cost_class cost_class;
+
+	uint32 version; /* path_cache_version when this was flooded */
+	uint32 last_used;
+	bool reached_destination;
+
+	/* the polygons reverse_flood_map() returned, starting from the last one expanded */
+	std::vector<short> polygon_indexes;
+	std::vector<struct path_cost_dependency> dependencies;
+};
+
 /* ---------- globals */
 
 static struct path_definition *paths = NULL;
 
+static std::vector<struct cached_path> cached_paths;
+static uint32 path_cache_version= 0, path_cache_use_count= 0;
+
+/* dependencies noted by the cost_proc during the flood in progress */
+static std::vector<struct path_cost_dependency> flood_dependencies;
+static bool recording_dependencies= false, flood_dependencies_overflowed= false;
+
+/* the polygons of the path being built */
+static std::vector<short> path_polygon_indexes;
+
 #ifdef VERIFY_PATH_SYNC
 static byte *path_validation_area = NULL;
 static int32 path_validation_area_index;
@@ -94,6 +137,13 @@ static short path_run_count;
 static void calculate_midpoint_of_shared_line(short polygon1, short polygon2,
 	world_distance minimum_separation, world_point2d *midpoint);
 
+static bool flood_path(short source_polygon_index, short destination_polygon_index, cost_proc_ptr cost, void *data);
+static struct cached_path *find_cached_path(short source_polygon_index, short destination_polygon_index,
+	const struct path_cost_class *cost_class);
+static void cache_path(short source_polygon_index, short destination_polygon_index,
+	const struct path_cost_class *cost_class, bool reached_destination);
+static bool path_cost_classes_match(const struct path_cost_class *a, const struct path_cost_class *b);
+
 /* ---------- code */
 
 void allocate_pathfinding_memory(
@@ -118,6 +168,10 @@ void reset_paths(
 
 	for (path_index=0;path_index<MAXIMUM_PATHS;++path_index) paths[path_index].step_count= NONE;
 
+	/* a new level invalidates everything we remember */
+	cached_paths.clear();
+	path_cache_version+= 1;
+
 #ifdef VERIFY_PATH_SYNC
 	path_run_count+= 1;
 	path_validation_area_index= 0;
@@ -131,7 +185,8 @@ short new_path(
 	short destination_polygon_index,
 	world_distance minimum_separation,
 	cost_proc_ptr cost,
-	void *data)
+	void *data,
+	const struct path_cost_class *cost_class)
 {
 	short path_index;
 
@@ -173,18 +228,27 @@ short new_path(
 
 		if (destination_polygon_index!=NONE)
 		{
-			/* NON-RANDOM PATH: we have a valid destination point: flood out from the source_polygon_index
-				until we reach destination_polygon_index or we run out of stack space */
+			struct cached_path *cached= cost_class ? find_cached_path(source_polygon_index, destination_polygon_index, cost_class) : NULL;
 			
-			polygon_index= flood_map(source_polygon_index, INT32_MAX, cost, _breadth_first, data);
-			while (polygon_index!=NONE&&polygon_index!=destination_polygon_index)
+			if (cached)
 			{
-				polygon_index= flood_map(NONE, INT32_MAX, cost, _breadth_first, data);
+				/* we flooded this before and nothing it depended on has changed */
+				path_polygon_indexes= cached->polygon_indexes;
+				reached_destination= cached->reached_destination;
+			}
+			else
+			{
+				/* NON-RANDOM PATH: we have a valid destination point: flood out from the source_polygon_index
+					until we reach destination_polygon_index or we run out of stack space */
+				recording_dependencies= cost_class ? true : false;
+				flood_dependencies.clear();
+				flood_dependencies_overflowed= false;
+				
+				reached_destination= flood_path(source_polygon_index, destination_polygon_index, cost, data);
+				
+				recording_dependencies= false;
+				if (cost_class) cache_path(source_polygon_index, destination_polygon_index, cost_class, reached_destination);
 			}
-
-			/* if we reached destination_polygon_index, extract the path by calling
-				reverse_flood_map().  remember to add the destination to the end of the path */
-			reached_destination= polygon_index==destination_polygon_index ? true : false;
 		}
 		else
 		{
@@ -201,9 +265,13 @@ short new_path(
 			
 			choose_random_flood_node((world_vector2d *)destination_point); /* choose a random destination */
 			reached_destination= false; /* we didn’t even have one */
+			
+			path_polygon_indexes.clear();
+			while ((polygon_index= reverse_flood_map())!=NONE) path_polygon_indexes.push_back(polygon_index);
 		}
 
-		depth= flood_depth();
+		/* the last polygon is the source, at depth zero */
+		depth= static_cast<short>(path_polygon_indexes.size())-1;
 		if (reached_destination)
 		{
 			/* a depth of zero yeilds one point (the destination), two and greater 2*depth */
@@ -233,9 +301,10 @@ short new_path(
 			if (reached_destination && --step_count<MAXIMUM_POINTS_PER_PATH) path->points[step_count]= *destination_point;
 			
 			/* add all the points up to but not including the source (if we have room) */
-			last_polygon_index= reverse_flood_map();
-			while ((polygon_index= reverse_flood_map())!=NONE)
+			last_polygon_index= path_polygon_indexes[0];
+			for (size_t i= 1; i<path_polygon_indexes.size(); ++i)
 			{
+				polygon_index= path_polygon_indexes[i];
 				if (--step_count<MAXIMUM_POINTS_PER_PATH) calculate_midpoint_of_shared_line(last_polygon_index, polygon_index, minimum_separation, path->points+step_count);
 //				if (polygon_index!=source_polygon_index&&--step_count<MAXIMUM_POINTS_PER_PATH) find_center_of_polygon(polygon_index, path->points+step_count);
 				last_polygon_index= polygon_index;
@@ -323,44 +392,189 @@ void delete_path(
 	paths[path_index].step_count= NONE;
 }
 
+void note_path_cost_dependency(
+	short kind,
+	short index,
+	int32 value)
+{
+	if (recording_dependencies)
+	{
+		struct path_cost_dependency dependency;
+		
+		if (flood_dependencies.size()<MAXIMUM_PATH_COST_DEPENDENCIES)
+		{
+			dependency.kind= kind;
+			dependency.index= index;
+			dependency.value= value;
+			flood_dependencies.push_back(dependency);
+		}
+		else
+		{
+			/* too much changeable state to be worth remembering */
+			flood_dependencies_overflowed= true;
+		}
+	}
+}
+
+void invalidate_path_cache(
+	void)
+{
+	path_cache_version+= 1;
+}
+
 /* ---------- private code */
 
+/* floods from source_polygon_index until destination_polygon_index is reached or the flood
+	runs dry, leaving the polygons traversed in path_polygon_indexes */
+static bool flood_path(
+	short source_polygon_index,
+	short destination_polygon_index,
+	cost_proc_ptr cost,
+	void *data)
+{
+	short polygon_index;
+	
+	polygon_index= flood_map(source_polygon_index, INT32_MAX, cost, _breadth_first, data);
+	while (polygon_index!=NONE&&polygon_index!=destination_polygon_index)
+	{
+		polygon_index= flood_map(NONE, INT32_MAX, cost, _breadth_first, data);
+	}
+	
+	path_polygon_indexes.clear();
+	while ((polygon_index= reverse_flood_map())!=NONE) path_polygon_indexes.push_back(polygon_index);
+	
+	/* if we reached destination_polygon_index, the path runs backwards from it.  remember to add
+		the destination to the end of the path */
+	return path_polygon_indexes.size() && path_polygon_indexes[0]==destination_polygon_index;
+}
+
+static struct cached_path *find_cached_path(
+	short source_polygon_index,
+	short destination_polygon_index,
+	const struct path_cost_class *cost_class)
+{
+	for (size_t i= 0; i<cached_paths.size(); ++i)
+	{
+		struct cached_path *cached= &cached_paths[i];
+		
+		if (cached->source_polygon_index==source_polygon_index &&
+			cached->destination_polygon_index==destination_polygon_index &&
+			cached->version==path_cache_version &&
+			path_cost_classes_match(&cached->cost_class, cost_class))
+		{
+			size_t j;
+			
+			for (j= 0; j<cached->dependencies.size(); ++j)
+			{
+				struct path_cost_dependency *dependency= &cached->dependencies[j];
+				
+				if (cost_class->dependency_proc(dependency->kind, dependency->index)!=dependency->value) break;
+			}
+			
+			if (j==cached->dependencies.size())
+			{
+				cached->last_used= ++path_cache_use_count;
+				return cached;
+			}
+		}
+	}
+	
+	return (struct cached_path *) NULL;
+}
+
+static void cache_path(
+	short source_polygon_index,
+	short destination_polygon_index,
+	const struct path_cost_class *cost_class,
+	bool reached_destination)
+{
+	struct cached_path *cached= NULL;
+	
+	if (flood_dependencies_overflowed) return;
+	
+	/* replace a stale entry for the same route if there is one */
+	for (size_t i= 0; i<cached_paths.size() && !cached; ++i)
+	{
+		struct cached_path *candidate= &cached_paths[i];
+		
+		if (candidate->source_polygon_index==source_polygon_index &&
+			candidate->destination_polygon_index==destination_polygon_index &&
+			path_cost_classes_match(&candidate->cost_class, cost_class))
+		{
+			cached= candidate;
+		}
+	}
+	
+	if (!cached)
+	{
+		if (cached_paths.size()<MAXIMUM_CACHED_PATHS)
+		{
+			cached_paths.push_back(cached_path());
+			cached= &cached_paths.back();
+		}
+		else
+		{
+			/* evict the least recently used entry */
+			cached= &cached_paths[0];
+			for (size_t i= 1; i<cached_paths.size(); ++i)
+			{
+				if (cached_paths[i].last_used<cached->last_used) cached= &cached_paths[i];
+			}
+		}
+	}
+	
+	cached->source_polygon_index= source_polygon_index;
+	cached->destination_polygon_index= destination_polygon_index;
+	cached->cost_class= *cost_class;
+	cached->version= path_cache_version;
+	cached->last_used= ++path_cache_use_count;
+	cached->reached_destination= reached_destination;
+	cached->polygon_indexes= path_polygon_indexes;
+	cached->dependencies= flood_dependencies;
+}
+
+static bool path_cost_classes_match(
+	const struct path_cost_class *a,
+	const struct path_cost_class *b)
+{
+	return a->cost==b->cost && a->dependency_proc==b->dependency_proc &&
+		!memcmp(a->parameters, b->parameters, sizeof(a->parameters));
+}
+
 static void calculate_midpoint_of_shared_line(
 	short polygon1,
 	short polygon2,
 	world_distance minimum_separation,
 	world_point2d *midpoint)
 {
-	short shared_line_index;
 	world_distance range, origin;
-	struct line_data *shared_line;
-	struct endpoint_data *endpoint0, *endpoint1;
+	struct polygon_edge_data *edge;
+	world_point2d *vertex0, *vertex1;
 	
-	shared_line_index= find_shared_line(polygon1, polygon2);
-	assert(shared_line_index!=NONE);
-	shared_line= get_line_data(shared_line_index);
-
-	endpoint0= get_endpoint_data(shared_line->endpoint_indexes[0]);
-	endpoint1= get_endpoint_data(shared_line->endpoint_indexes[1]);
+	/* the edge carries the shared line's length and endpoints, so we needn't look up the line */
+	edge= find_polygon_edge(polygon1, polygon2);
+	assert(edge);
+	vertex0= &edge->vertexes[0];
+	vertex1= &edge->vertexes[1];
 
 	origin= 0;
-	range= shared_line->length;
-	if (ENDPOINT_IS_ELEVATION(endpoint0)) origin+= minimum_separation, range-= minimum_separation;
-	if (ENDPOINT_IS_ELEVATION(endpoint1)) range-= minimum_separation;
+	range= edge->length;
+	if (ENDPOINT_IS_ELEVATION(get_endpoint_data(edge->endpoint_indexes[0]))) origin+= minimum_separation, range-= minimum_separation;
+	if (ENDPOINT_IS_ELEVATION(get_endpoint_data(edge->endpoint_indexes[1]))) range-= minimum_separation;
 	if (range<=0)
 	{
 		/* uhh... this line is really too small for us to pass through */
-		midpoint->x= endpoint0->vertex.x + (endpoint1->vertex.x-endpoint0->vertex.x)/2;
-		midpoint->y= endpoint0->vertex.y + (endpoint1->vertex.y-endpoint0->vertex.y)/2;
+		midpoint->x= vertex0->x + (vertex1->x-vertex0->x)/2;
+		midpoint->y= vertex0->y + (vertex1->y-vertex0->y)/2;
 	}
 	else
 	{
-		world_distance dx= endpoint1->vertex.x-endpoint0->vertex.x;
-		world_distance dy= endpoint1->vertex.y-endpoint0->vertex.y;
+		world_distance dx= vertex1->x-vertex0->x;
+		world_distance dy= vertex1->y-vertex0->y;
 		world_distance offset= origin + ((global_random()*range)>>16);
 		
-		midpoint->x= endpoint0->vertex.x + (offset*dx)/shared_line->length;
-		midpoint->y= endpoint0->vertex.y + (offset*dy)/shared_line->length;
+		midpoint->x= vertex0->x + (offset*dx)/edge->length;
+		midpoint->y= vertex0->y + (offset*dy)/edge->length;
 	}
 }
 
@@ -67,6 +67,7 @@ Jun 30, 2002 (tiennou):
 #include "world.h"
 #include "map.h"
 #include "platforms.h"
+#include "flood_map.h"
 #include "lightsource.h"
 #include "SoundManager.h"
 #include "player.h"
@@ -877,6 +878,7 @@ void adjust_platform_endpoint_and_line_heights(
 			line->highest_adjacent_floor= polygon->floor_height;
 			line->lowest_adjacent_ceiling= polygon->ceiling_height;
 		}
+		update_polygon_adjacency_graph_line(polygon->line_indexes[i]);
 
 		/* adjust endpoint heights */
 		// Skip this step if no polygon indexes were found
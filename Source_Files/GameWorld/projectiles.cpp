@@ -632,8 +632,8 @@ void load_projectile_sounds(
 	{
 		struct projectile_definition *definition= get_projectile_definition(projectile_type);
 		
-		SoundManager::instance()->LoadSound(definition->flyby_sound);
-		SoundManager::instance()->LoadSound(definition->rebound_sound);
+		SoundManager::instance()->PrefetchSound(definition->flyby_sound);
+		SoundManager::instance()->PrefetchSound(definition->rebound_sound);
 	}
 }
 
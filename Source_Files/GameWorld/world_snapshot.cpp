@@ -0,0 +1,168 @@
+/*
+WORLD_SNAPSHOT.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+ 
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	A copy of the dynamic world that can be put back later
+*/
+
+#include "world_snapshot.h"
+
+#include "cseries.h"
+#include "map.h"
+#include "effects.h"
+#include "lightsource.h"
+#include "media.h"
+#include "monsters.h"
+#include "platforms.h"
+#include "player.h"
+#include "projectiles.h"
+#include "weapons.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+// small enough that a moving object dirties little more than itself
+static const std::size_t SNAPSHOT_CHUNK_SIZE = 256;
+
+// copies chunks that differ from one side to the other, returning how many bytes
+static std::size_t copy_changed_chunks(uint8* to, const uint8* from, std::size_t size)
+{
+	std::size_t copied = 0;
+	for (std::size_t offset = 0; offset < size; offset += SNAPSHOT_CHUNK_SIZE)
+	{
+		std::size_t count = std::min(SNAPSHOT_CHUNK_SIZE, size - offset);
+		if (memcmp(to + offset, from + offset, count))
+		{
+			memcpy(to + offset, from + offset, count);
+			copied += count;
+		}
+	}
+
+	return copied;
+}
+
+WorldSnapshot::WorldSnapshot() : m_random_seed(0), m_valid(false), m_copied_bytes(0)
+{
+}
+
+template <typename T>
+void WorldSnapshot::AddRegion(std::vector<Region>& regions, T* base, std::size_t count)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "snapshots copy memory");
+	if (!count) return;
+
+	regions.push_back({ reinterpret_cast<uint8*>(base), count * sizeof(T) });
+}
+
+void WorldSnapshot::GatherRegions(std::vector<Region>& regions) const
+{
+	regions.clear();
+
+	AddRegion(regions, dynamic_world, 1);
+	AddRegion(regions, players, dynamic_world->player_count);
+	AddRegion(regions, static_cast<player_weapon_data*>(get_weapon_array()), dynamic_world->player_count);
+
+	AddRegion(regions, ObjectList);
+	AddRegion(regions, MonsterList);
+	AddRegion(regions, ProjectileList);
+	AddRegion(regions, EffectList);
+
+	// platforms move endpoints, lines and polygons, and control panels live in sides;
+	// the automap is left out since the renderer fills it in between ticks
+	AddRegion(regions, EndpointList);
+	AddRegion(regions, LineList);
+	AddRegion(regions, SideList);
+	AddRegion(regions, PolygonList);
+	AddRegion(regions, PlatformList);
+	AddRegion(regions, LightList);
+	AddRegion(regions, MediaList);
+}
+
+bool WorldSnapshot::SameLayout(const std::vector<Region>& regions) const
+{
+	if (regions.size() != m_regions.size()) return false;
+
+	for (std::size_t i = 0; i < regions.size(); ++i)
+	{
+		if (regions[i].base != m_regions[i].base || regions[i].size != m_regions[i].size) return false;
+	}
+
+	return true;
+}
+
+void WorldSnapshot::Take()
+{
+	assert(dynamic_world);
+
+	std::vector<Region> regions;
+	GatherRegions(regions);
+
+	m_copied_bytes = 0;
+	if (!SameLayout(regions))
+	{
+		std::size_t size = 0;
+		for (auto& region : regions)
+		{
+			size += region.size;
+		}
+
+		m_regions.swap(regions);
+		m_data.resize(size);
+
+		uint8* data = m_data.data();
+		for (auto& region : m_regions)
+		{
+			memcpy(data, region.base, region.size);
+			data += region.size;
+		}
+		m_copied_bytes = size;
+	}
+	else
+	{
+		uint8* data = m_data.data();
+		for (auto& region : m_regions)
+		{
+			m_copied_bytes += copy_changed_chunks(data, region.base, region.size);
+			data += region.size;
+		}
+	}
+
+	m_random_seed = get_random_seed();
+	m_valid = true;
+}
+
+bool WorldSnapshot::Restore()
+{
+	if (!m_valid || !dynamic_world) return false;
+
+	std::vector<Region> regions;
+	GatherRegions(regions);
+	if (!SameLayout(regions)) return false;
+
+	m_copied_bytes = 0;
+	const uint8* data = m_data.data();
+	for (auto& region : m_regions)
+	{
+		m_copied_bytes += copy_changed_chunks(region.base, data, region.size);
+		data += region.size;
+	}
+
+	set_random_seed(m_random_seed);
+	return true;
+}
@@ -0,0 +1,83 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+/*
+WORLD_SNAPSHOT.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+ 
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	A copy of the dynamic world (dynamic_world, players and their weapons, objects,
+	monsters, projectiles, effects, map geometry, platforms, lights, medias and the
+	random seed) that can be put back later, for rolling back predicted ticks.
+
+	The world is compared against the copy in small chunks, and only chunks that
+	differ are copied in either direction, so a snapshot of a world that has moved on
+	a few ticks costs about one pass over memory rather than two full copies.
+
+	Not covered: Lua state, pathfinding, ephemera, sounds, the interface and anything
+	else kept outside the lists above; code that rolls back must not touch them.
+*/
+
+#include "cstypes.h"
+
+#include <cstddef>
+#include <vector>
+
+class WorldSnapshot
+{
+public:
+	WorldSnapshot();
+
+	// copies whatever changed since the last Take()
+	void Take();
+
+	// puts the world back the way it was at the last Take(); returns false (and
+	// changes nothing) if there is no snapshot, or the world's lists were
+	// reallocated since it was taken, as on a level change
+	bool Restore();
+
+	bool IsValid() const { return m_valid; }
+	void Invalidate() { m_valid = false; }
+
+	std::size_t Size() const { return m_data.size(); }
+
+	// bytes copied by the last Take() or Restore()
+	std::size_t CopiedBytes() const { return m_copied_bytes; }
+
+private:
+	struct Region
+	{
+		uint8* base;
+		std::size_t size;
+	};
+
+	template <typename T>
+	static void AddRegion(std::vector<Region>& regions, T* base, std::size_t count);
+	template <typename T>
+	static void AddRegion(std::vector<Region>& regions, std::vector<T>& list) { AddRegion(regions, list.data(), list.size()); }
+
+	void GatherRegions(std::vector<Region>& regions) const;
+	bool SameLayout(const std::vector<Region>& regions) const;
+
+	std::vector<Region> m_regions;
+	std::vector<uint8> m_data;
+	uint16 m_random_seed;
+	bool m_valid;
+	std::size_t m_copied_bytes;
+};
+
+#endif
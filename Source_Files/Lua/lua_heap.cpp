@@ -0,0 +1,283 @@
+/*
+LUA_HEAP.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Memory for a Lua state, and pacing of its garbage collector
+*/
+
+#include "lua_heap.h"
+
+#include "Logging.h"
+#include "map.h" // TICKS_PER_SECOND
+
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+
+// leaked, since states still open at exit may be destroyed after it would be
+static std::vector<LuaHeap *>& heaps()
+{
+	static std::vector<LuaHeap *> *registry = new std::vector<LuaHeap *>;
+	return *registry;
+}
+
+uint64_t LuaHeap::s_allocations = 0;
+uint64_t LuaHeap::s_allocated_bytes = 0;
+
+LuaHeap::LuaHeap() :
+	m_state(NULL),
+	m_block_used(kBlockSize),
+	m_bytes_in_use(0),
+	m_peak_bytes(0),
+	m_collecting(false),
+	m_live_bytes(0)
+{
+	for (int i = 0; i < kSizeClasses; ++i)
+		m_free[i] = NULL;
+
+	ResetStats();
+	heaps().push_back(this);
+}
+
+LuaHeap::~LuaHeap()
+{
+	for (void *block : m_blocks)
+		free(block);
+
+	heaps().erase(std::remove(heaps().begin(), heaps().end(), this), heaps().end());
+}
+
+static int panic(lua_State *L)
+{
+	logError("unprotected error in call to Lua API (%s)", lua_tostring(L, -1));
+	return 0;
+}
+
+lua_State *LuaHeap::NewState()
+{
+	assert(!m_state);
+	lua_State *L = lua_newstate(Allocate, this);
+	if (L)
+		lua_atpanic(L, panic);
+
+	m_state = L;
+
+	return L;
+}
+
+LuaHeap *LuaHeap::Of(lua_State *L)
+{
+	void *ud;
+	return lua_getallocf(L, &ud) == Allocate ? static_cast<LuaHeap *>(ud) : NULL;
+}
+
+std::vector<lua_State *> LuaHeap::States()
+{
+	std::vector<lua_State *> states;
+	for (LuaHeap *heap : heaps())
+	{
+		if (heap->m_state)
+			states.push_back(heap->m_state);
+	}
+
+	return states;
+}
+
+/* ---------- allocation */
+
+void *LuaHeap::AllocateSmall(int size_class)
+{
+	void *ptr = m_free[size_class];
+	if (ptr)
+	{
+		m_free[size_class] = *static_cast<void **>(ptr);
+		return ptr;
+	}
+
+	size_t size = (size_class + 1) * kGranularity;
+	if (m_block_used + size > kBlockSize)
+	{
+		// what's left of the old block is too small to matter
+		void *block = malloc(kBlockSize);
+		if (!block)
+			return NULL;
+
+		m_blocks.push_back(block);
+		m_block_used = 0;
+	}
+
+	ptr = static_cast<uint8 *>(m_blocks.back()) + m_block_used;
+	m_block_used += size;
+	return ptr;
+}
+
+void LuaHeap::FreeSmall(void *ptr, int size_class)
+{
+	*static_cast<void **>(ptr) = m_free[size_class];
+	m_free[size_class] = ptr;
+}
+
+// lua_Alloc; Lua passes a block's size back when it frees or resizes it, so blocks
+// need no header to say which size class they came from
+void *LuaHeap::Allocate(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	LuaHeap *heap = static_cast<LuaHeap *>(ud);
+
+	// without a block, osize is the kind of object being made
+	if (!ptr)
+		osize = 0;
+
+	int old_class = ptr ? SizeClass(osize) : NONE;
+	int new_class = nsize ? SizeClass(nsize) : NONE;
+	void *result;
+
+	if (nsize == 0)
+	{
+		if (old_class != NONE)
+			heap->FreeSmall(ptr, old_class);
+		else
+			free(ptr);
+		result = NULL;
+	}
+	else if (ptr && old_class == new_class && new_class != NONE)
+	{
+		result = ptr;
+	}
+	else if (old_class == NONE && new_class == NONE)
+	{
+		result = realloc(ptr, nsize);
+	}
+	else
+	{
+		result = new_class != NONE ? heap->AllocateSmall(new_class) : malloc(nsize);
+		if (!result && nsize < osize)
+		{
+			// Lua doesn't expect shrinking to fail; the old block is big enough, and
+			// will be filed under the smaller size when it's freed
+			result = ptr;
+		}
+		else if (result && ptr)
+		{
+			memcpy(result, ptr, std::min(osize, nsize));
+			if (old_class != NONE)
+				heap->FreeSmall(ptr, old_class);
+			else
+				free(ptr);
+		}
+	}
+
+	if (result || nsize == 0)
+	{
+		heap->m_bytes_in_use += nsize;
+		heap->m_bytes_in_use -= osize;
+		heap->m_peak_bytes = std::max(heap->m_peak_bytes, heap->m_bytes_in_use);
+
+		if (nsize > osize)
+		{
+			++s_allocations;
+			s_allocated_bytes += nsize - osize;
+		}
+	}
+
+	return result;
+}
+
+/* ---------- collection */
+
+static int step_collector(lua_State *L)
+{
+	int kilobytes = static_cast<int>(lua_tointeger(L, 1));
+	lua_pushboolean(L, lua_gc(L, LUA_GCSTEP, kilobytes));
+	return 1;
+}
+
+void LuaHeap::Step(lua_State *L)
+{
+	// start a collection a little before Lua's own pacing would, so that most of the
+	// work happens here rather than while a trigger is allocating
+	if (!m_collecting && m_bytes_in_use < m_live_bytes + m_live_bytes / 2)
+		return;
+
+	m_collecting = true;
+
+	// enough for a collection to take a second or so of ticks
+	int kilobytes = static_cast<int>(std::max<size_t>(16, m_live_bytes / (TICKS_PER_SECOND * 1024)));
+
+	auto start = std::chrono::steady_clock::now();
+
+	// finalizers run as part of a step, and may fail
+	lua_pushcfunction(L, step_collector);
+	lua_pushinteger(L, kilobytes);
+	if (lua_pcall(L, 1, 1, 0) != LUA_OK)
+	{
+		logWarning("Lua error during garbage collection: %s", lua_tostring(L, -1));
+	}
+	else if (lua_toboolean(L, -1))
+	{
+		m_collecting = false;
+		m_live_bytes = m_bytes_in_use;
+		++m_cycles;
+	}
+	lua_pop(L, 1);
+
+	uint32 microseconds = static_cast<uint32>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+	++m_steps;
+	m_step_microseconds += microseconds;
+	m_longest_step_microseconds = std::max(m_longest_step_microseconds, microseconds);
+}
+
+/* ---------- statistics */
+
+LuaHeapStats LuaHeap::GetStats() const
+{
+	LuaHeapStats stats;
+	stats.name = m_name;
+	stats.bytes_in_use = m_bytes_in_use;
+	stats.peak_bytes = m_peak_bytes;
+	stats.pooled_bytes = m_blocks.size() * kBlockSize;
+	stats.steps = m_steps;
+	stats.cycles = m_cycles;
+	stats.step_microseconds = m_step_microseconds;
+	stats.longest_step_microseconds = m_longest_step_microseconds;
+	return stats;
+}
+
+void LuaHeap::ResetStats()
+{
+	m_peak_bytes = m_bytes_in_use;
+	m_steps = 0;
+	m_cycles = 0;
+	m_step_microseconds = 0;
+	m_longest_step_microseconds = 0;
+}
+
+std::vector<LuaHeapStats> L_Get_Heap_Stats()
+{
+	std::vector<LuaHeapStats> stats;
+	for (LuaHeap *heap : heaps())
+		stats.push_back(heap->GetStats());
+
+	return stats;
+}
+
+void L_Reset_Heap_Stats()
+{
+	for (LuaHeap *heap : heaps())
+		heap->ResetStats();
+}
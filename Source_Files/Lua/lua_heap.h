@@ -0,0 +1,122 @@
+#ifndef __LUA_HEAP_H
+#define __LUA_HEAP_H
+
+/*
+LUA_HEAP.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Memory for a Lua state, and pacing of its garbage collector
+*/
+
+#include "cseries.h"
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <string>
+#include <vector>
+
+struct LuaHeapStats
+{
+	std::string name;
+	size_t bytes_in_use;
+	size_t peak_bytes;
+	size_t pooled_bytes; // reserved for small blocks, used or not
+	uint32 steps;        // collector steps run between ticks
+	uint32 cycles;       // collections those steps finished
+	uint64_t step_microseconds;
+	uint32 longest_step_microseconds;
+};
+
+// A size-class pool for the small blocks a Lua state is mostly made of, with the
+// rest left to malloc(), and collector steps taken between ticks so collection work
+// isn't done in the middle of a trigger. The heap must outlive its state.
+class LuaHeap
+{
+public:
+	LuaHeap();
+	~LuaHeap();
+
+	// a state allocating from this heap; close it with lua_close()
+	lua_State *NewState();
+
+	// runs a bounded amount of incremental collection; call once a tick, outside of
+	// triggers. How much is done depends only on the heap's contents, so every
+	// player in a netgame collects the same way
+	void Step(lua_State *L);
+
+	void SetName(const std::string& name) { m_name = name; }
+	const std::string& GetName() const { return m_name; }
+	LuaHeapStats GetStats() const;
+	void ResetStats();
+
+	// the heap a state was made by, or NULL if it wasn't made by one
+	static LuaHeap *Of(lua_State *L);
+
+	// every open state made by a heap
+	static std::vector<lua_State *> States();
+
+	// blocks made or grown, and the bytes they grew by, across all heaps
+	static uint64_t AllocationCount() { return s_allocations; }
+	static uint64_t AllocatedBytes() { return s_allocated_bytes; }
+
+private:
+	enum {
+		kGranularity = 16,
+		kSizeClasses = 32, // up to 512 bytes
+		kBlockSize = 64 * 1024
+	};
+
+	static void *Allocate(void *ud, void *ptr, size_t osize, size_t nsize);
+	void *AllocateSmall(int size_class);
+	void FreeSmall(void *ptr, int size_class);
+
+	static int SizeClass(size_t size) {
+		return size > kGranularity * kSizeClasses ? NONE : static_cast<int>((size + kGranularity - 1) / kGranularity) - 1;
+	}
+
+	std::string m_name;
+	lua_State *m_state; // closed before the heap is destroyed
+
+	void *m_free[kSizeClasses];
+	std::vector<void *> m_blocks;
+	size_t m_block_used; // bytes carved from the newest block
+
+	size_t m_bytes_in_use;
+	size_t m_peak_bytes;
+
+	// collector pacing
+	bool m_collecting;
+	size_t m_live_bytes; // after the last finished collection
+
+	uint32 m_steps;
+	uint32 m_cycles;
+	uint64_t m_step_microseconds;
+	uint32 m_longest_step_microseconds;
+
+	static uint64_t s_allocations;
+	static uint64_t s_allocated_bytes;
+};
+
+// every Lua state's heap, for the console
+std::vector<LuaHeapStats> L_Get_Heap_Stats();
+void L_Reset_Heap_Stats();
+
+#endif
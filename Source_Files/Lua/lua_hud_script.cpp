@@ -42,6 +42,8 @@ extern "C"
 #include "Plugins.h"
 
 #include "lua_hud_script.h"
+#include "lua_heap.h"
+#include "lua_profiler.h"
 #include "lua_hud_objects.h"
 
 #include <boost/iostreams/device/array.hpp>
@@ -77,8 +79,9 @@ void* L_Persistent_Table_Key();
 class LuaHUDState
 {
 public:
-	LuaHUDState() : running_(false), inited_(false), num_scripts_(0) {
-		state_.reset(luaL_newstate(), lua_close);
+	LuaHUDState() : heap_(new LuaHeap), running_(false), inited_(false), num_scripts_(0) {
+		heap_->SetName("HUD Lua");
+		state_.reset(heap_->NewState(), lua_close);
 	}
 
 	virtual ~LuaHUDState() {
@@ -92,6 +95,7 @@ public:
 	bool Run();
 	void Stop() { running_ = false; }
 	void MarkCollections(std::set<short>& collections);
+	void CollectGarbage() { heap_->Step(State()); }
 
 	virtual void Initialize() {
 		const luaL_Reg *lib = lualibs;
@@ -111,9 +115,11 @@ public:
 protected:
 	bool GetTrigger(const char *trigger);
 	void CallTrigger(int numArgs = 0);
+	const char *trigger_ = nullptr; // the last one GetTrigger() found
 
 	virtual void RegisterFunctions();
 
+	std::unique_ptr<LuaHeap> heap_; // outlives state_
 	std::shared_ptr<lua_State> state_;
 	lua_State* State() { return state_.get(); }
 
@@ -153,11 +159,13 @@ bool LuaHUDState::GetTrigger(const char* trigger)
 	}
 
 	lua_remove(State(), -2);
+	trigger_ = trigger;
 	return true;
 }
 
 void LuaHUDState::CallTrigger(int numArgs)
 {
+	LuaTriggerProfile profile(State(), trigger_);
 	if (lua_pcall(State(), numArgs, 0, 0) == LUA_ERRRUN)
 		L_Error(lua_tostring(State(), -1));
 }
@@ -302,7 +310,12 @@ void L_Call_HUDCleanup()
 void L_Call_HUDDraw()
 {
 	if (hud_state)
+	{
 		hud_state->Draw();
+
+		// after drawing, rather than while the next frame's draw is allocating
+		hud_state->CollectGarbage();
+	}
 }
 
 void L_Call_HUDResize()
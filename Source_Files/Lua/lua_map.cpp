@@ -31,6 +31,7 @@ LUA_MAP.CPP
 #include "lua_templates.h"
 #include "lightsource.h"
 #include "map.h"
+#include "flood_map.h"
 #include "media.h"
 #include "platforms.h"
 #include "player.h"
@@ -1721,6 +1722,7 @@ static int Lua_Polygon_Set_Permutation(lua_State *L)
 	
 	int permutation = static_cast<int>(lua_tonumber(L, 2));
 	get_polygon_data(Lua_Polygon::Index(L, 1))->permutation = permutation;
+	invalidate_path_cache();
 	return 0;
 }
 
@@ -1728,6 +1730,7 @@ static int Lua_Polygon_Set_Type(lua_State *L)
 {
 	polygon_data* polygon = get_polygon_data(Lua_Polygon::Index(L, 1));
 	polygon->type = Lua_PolygonType::ToIndex(L, 2);
+	invalidate_path_cache();
 	return 0;
 }
 
@@ -3630,6 +3633,39 @@ const luaL_Reg Lua_Level_Get[] = {
 char Lua_TransferMode_Name[] = "transfer_mode";
 char Lua_TransferModes_Name[] = "TransferModes";
 
+// x, y, radius in WU
+void L_Get_Query_Circle(lua_State *L, int arg, const char *function, world_point2d& center, int32& radius)
+{
+	if (!lua_isnumber(L, arg) || !lua_isnumber(L, arg + 1) || !lua_isnumber(L, arg + 2))
+		luaL_error(L, "%s: incorrect argument type", function);
+
+	double r = lua_tonumber(L, arg + 2) * WORLD_ONE;
+	if (r < 0)
+		luaL_error(L, "%s: invalid radius", function);
+
+	center.x = static_cast<world_distance>(lua_tonumber(L, arg) * WORLD_ONE);
+	center.y = static_cast<world_distance>(lua_tonumber(L, arg + 1) * WORLD_ONE);
+	radius = static_cast<int32>(std::min(r, double(INT32_MAX)));
+}
+
+short L_Get_Query_Polygon(lua_State *L, int arg, const char *function)
+{
+	if (lua_isnumber(L, arg))
+	{
+		short polygon_index = static_cast<short>(lua_tonumber(L, arg));
+		if (!Lua_Polygon::Valid(polygon_index))
+			luaL_error(L, "%s: invalid polygon index", function);
+		return polygon_index;
+	}
+	else if (Lua_Polygon::Is(L, arg))
+	{
+		return Lua_Polygon::Index(L, arg);
+	}
+
+	luaL_error(L, "%s: incorrect argument type", function);
+	return NONE;
+}
+
 static void compatibility(lua_State *L);
 #define NUMBER_OF_CONTROL_PANEL_DEFINITIONS 54
 
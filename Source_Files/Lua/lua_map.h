@@ -147,4 +147,16 @@ typedef L_Container<Lua_Medias_Name, Lua_Media> Lua_Medias;
 
 int Lua_Map_register (lua_State *L);
 
+// arguments of the bulk object queries (Monsters.in_range() and friends)
+void L_Get_Query_Circle(lua_State *L, int arg, const char *function, world_point2d& center, int32& radius);
+short L_Get_Query_Polygon(lua_State *L, int arg, const char *function);
+
+// whether location is within radius of center, horizontally; all in internal units
+static inline bool L_In_Query_Circle(const world_point3d& location, const world_point2d& center, int32 radius)
+{
+	int64_t dx = location.x - center.x;
+	int64_t dy = location.y - center.y;
+	return dx * dx + dy * dy <= int64_t(radius) * radius;
+}
+
 #endif
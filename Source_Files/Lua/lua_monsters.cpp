@@ -26,7 +26,9 @@ LUA_MONSTERS.CPP
 #include "lua_player.h"
 #include "lua_templates.h"
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 #include "flood_map.h"
 #include "monsters.h"
@@ -1128,8 +1130,113 @@ int Lua_Monsters_New(lua_State *L)
 	return 1;
 }
 
+// the bulk queries below return monsters in index order, as Monsters() does; scratch space is
+// kept between calls, since scripts tend to ask every tick
+static std::vector<short> query_candidates;
+static std::vector<int16> query_monsters;
+
+// Monsters.in_range(x, y, radius [, result])
+static int Lua_Monsters_In_Range(lua_State *L)
+{
+	world_point2d center;
+	int32 radius;
+	L_Get_Query_Circle(L, 1, "in_range", center, radius);
+
+	if (radius <= INT16_MAX)
+	{
+		find_monsters_in_range(&center, static_cast<world_distance>(radius), query_candidates);
+	}
+	else
+	{
+		query_candidates.clear();
+		for (int16 monster_index = 0; monster_index < Lua_Monsters::Length(); ++monster_index)
+			query_candidates.push_back(monster_index);
+	}
+
+	query_monsters.clear();
+	for (short monster_index : query_candidates)
+	{
+		if (!Lua_Monster::Valid(monster_index))
+			continue;
+
+		monster_data *monster = get_monster_data(monster_index);
+		if (L_In_Query_Circle(get_object_data(monster->object_index)->location, center, radius))
+			query_monsters.push_back(monster_index);
+	}
+
+	L_Push_Array<Lua_Monster>(L, 4, query_monsters);
+	return 1;
+}
+
+// Monsters.in_polygon(polygon [, result])
+static int Lua_Monsters_In_Polygon(lua_State *L)
+{
+	short polygon_index = L_Get_Query_Polygon(L, 1, "in_polygon");
+
+	query_monsters.clear();
+	for (short object_index = get_polygon_data(polygon_index)->first_object; object_index != NONE; )
+	{
+		object_data *object = get_object_data(object_index);
+		if (GET_OBJECT_OWNER(object) == _object_is_monster && Lua_Monster::Valid(object->permutation))
+			query_monsters.push_back(object->permutation);
+		object_index = object->next_object;
+	}
+	std::sort(query_monsters.begin(), query_monsters.end());
+
+	L_Push_Array<Lua_Monster>(L, 2, query_monsters);
+	return 1;
+}
+
+// Monsters.of_type(type [, result])
+static int Lua_Monsters_Of_Type(lua_State *L)
+{
+	short monster_type = Lua_MonsterType::ToIndex(L, 1);
+
+	query_monsters.clear();
+	for (int16 monster_index = 0; monster_index < Lua_Monsters::Length(); ++monster_index)
+	{
+		if (Lua_Monster::Valid(monster_index) && get_monster_data(monster_index)->type == monster_type)
+			query_monsters.push_back(monster_index);
+	}
+
+	L_Push_Array<Lua_Monster>(L, 2, query_monsters);
+	return 1;
+}
+
+// Monsters.positions([monsters, x, y, z]): every valid monster, and where each one is
+static int Lua_Monsters_Positions(lua_State *L)
+{
+	static std::vector<double> x, y, z;
+
+	query_monsters.clear();
+	x.clear();
+	y.clear();
+	z.clear();
+	for (int16 monster_index = 0; monster_index < Lua_Monsters::Length(); ++monster_index)
+	{
+		if (!Lua_Monster::Valid(monster_index))
+			continue;
+
+		object_data *object = get_object_data(get_monster_data(monster_index)->object_index);
+		query_monsters.push_back(monster_index);
+		x.push_back((double) object->location.x / WORLD_ONE);
+		y.push_back((double) object->location.y / WORLD_ONE);
+		z.push_back((double) object->location.z / WORLD_ONE);
+	}
+
+	L_Push_Array<Lua_Monster>(L, 1, query_monsters);
+	L_Push_Number_Array(L, 2, x);
+	L_Push_Number_Array(L, 3, y);
+	L_Push_Number_Array(L, 4, z);
+	return 4;
+}
+
 const luaL_Reg Lua_Monsters_Methods[] = {
+	{"in_polygon", L_TableFunction<Lua_Monsters_In_Polygon>},
+	{"in_range", L_TableFunction<Lua_Monsters_In_Range>},
 	{"new", L_TableFunction<Lua_Monsters_New>},
+	{"of_type", L_TableFunction<Lua_Monsters_Of_Type>},
+	{"positions", L_TableFunction<Lua_Monsters_Positions>},
 	{0, 0}
 };
 
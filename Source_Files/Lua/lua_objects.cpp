@@ -33,7 +33,9 @@ LUA_OBJECTS.CPP
 #include "item_definitions.h"
 #include "scenery_definitions.h"
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 #include "SoundManager.h"
 
@@ -441,8 +443,67 @@ int Lua_Items_New(lua_State *L)
 	return 1;
 }
 
+// the bulk queries below return items in index order, as Items() does
+static std::vector<int16> query_items;
+
+// Items.in_range(x, y, radius [, result])
+static int Lua_Items_In_Range(lua_State *L)
+{
+	world_point2d center;
+	int32 radius;
+	L_Get_Query_Circle(L, 1, "in_range", center, radius);
+
+	query_items.clear();
+	for (int16 object_index = 0; object_index < Lua_Items::Length(); ++object_index)
+	{
+		if (Lua_Item::Valid(object_index) && L_In_Query_Circle(get_object_data(object_index)->location, center, radius))
+			query_items.push_back(object_index);
+	}
+
+	L_Push_Array<Lua_Item>(L, 4, query_items);
+	return 1;
+}
+
+// Items.in_polygon(polygon [, result])
+static int Lua_Items_In_Polygon(lua_State *L)
+{
+	short polygon_index = L_Get_Query_Polygon(L, 1, "in_polygon");
+
+	query_items.clear();
+	for (short object_index = get_polygon_data(polygon_index)->first_object; object_index != NONE; )
+	{
+		object_data *object = get_object_data(object_index);
+		if (GET_OBJECT_OWNER(object) == _object_is_item)
+			query_items.push_back(object_index);
+		object_index = object->next_object;
+	}
+	std::sort(query_items.begin(), query_items.end());
+
+	L_Push_Array<Lua_Item>(L, 2, query_items);
+	return 1;
+}
+
+// Items.of_type(type [, result])
+static int Lua_Items_Of_Type(lua_State *L)
+{
+	short item_type = Lua_ItemType::ToIndex(L, 1);
+
+	query_items.clear();
+	for (int16 object_index = 0; object_index < Lua_Items::Length(); ++object_index)
+	{
+		if (Lua_Item::Valid(object_index) && get_object_data(object_index)->permutation == item_type)
+			query_items.push_back(object_index);
+	}
+
+	L_Push_Array<Lua_Item>(L, 2, query_items);
+	return 1;
+}
+
 const luaL_Reg Lua_Items_Methods[] = {
+	{"in_polygon", L_TableFunction<Lua_Items_In_Polygon>},
+	{"in_range", L_TableFunction<Lua_Items_In_Range>},
 	{"new", L_TableFunction<Lua_Items_New>},
+	{"of_type", L_TableFunction<Lua_Items_Of_Type>},
 	{0, 0}
 };
 
@@ -0,0 +1,570 @@
+/*
+LUA_PROFILER.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Lua trigger and function profiler
+*/
+
+#include "lua_profiler.h"
+#include "lua_heap.h"
+
+#include "FileHandler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+enum
+{
+	NUMBER_OF_TRIGGER_BUCKETS = 16, // under 8 us, under 16 us, ... under 128 ms, longer
+	SHORTEST_TRIGGER_BUCKET = 8,
+
+	// each line of a flame graph has its whole stack, so deep recursion
+	// would make the file grow with the square of the depth
+	MAXIMUM_FLAME_GRAPH_DEPTH = 256
+};
+
+// a trigger, or a function called from one, at some point in the call tree
+struct profile_node
+{
+	int frame; // index into frame_names
+	int parent;
+	std::vector<std::pair<int, int> > children; // frame name, node
+
+	uint64_t calls;
+	uint64_t self_nanoseconds;
+	uint64_t total_nanoseconds;
+	uint64_t self_allocations;
+};
+
+struct trigger_stats
+{
+	uint64_t calls;
+	uint64_t total_nanoseconds;
+	uint64_t maximum_nanoseconds;
+	uint64_t allocations;
+	uint64_t allocated_bytes;
+	uint32 buckets[NUMBER_OF_TRIGGER_BUCKETS];
+};
+
+// what's running now, innermost last
+struct profile_frame
+{
+	int node;
+	const void *function; // NULL for a trigger
+	int trigger;          // index into triggers, or NONE
+
+	uint64_t start;
+	uint64_t child_nanoseconds;
+	uint64_t start_allocations;
+	uint64_t start_allocated_bytes;
+	uint64_t child_allocations;
+};
+
+bool lua_profiler_enabled = false;
+bool lua_profiler_hooked = false;
+
+static bool profiling_functions = false;
+
+// names of triggers ("Map Lua/idle") and functions ("spawn (Map Lua:120)");
+// flamegraph.pl splits frames on ';', so neither may have one
+static std::vector<std::string> frame_names;
+static std::vector<int> frame_triggers; // index into triggers, or NONE for a function
+static std::map<std::string, int> trigger_frames;
+
+// Lua functions are known by their source string and first line, C functions by
+// their address; a source string freed with its state could in principle come
+// back for another, but only ever mislabels a function
+typedef std::tuple<const void *, int, lua_CFunction> function_key;
+static std::map<function_key, int> function_frames;
+
+static std::vector<trigger_stats> triggers;
+static std::vector<profile_node> nodes;
+static std::vector<profile_frame> frames;
+
+static uint64_t nanosecond_count()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string frame_name(std::string name)
+{
+	std::replace(name.begin(), name.end(), ';', ':');
+	return name;
+}
+
+static int find_child(int parent, int frame)
+{
+	for (auto& child : nodes[parent].children)
+	{
+		if (child.first == frame)
+			return child.second;
+	}
+
+	profile_node node = { frame, parent, {}, 0, 0, 0, 0 };
+	nodes.push_back(node);
+	nodes[parent].children.push_back(std::make_pair(frame, static_cast<int>(nodes.size() - 1)));
+	return static_cast<int>(nodes.size() - 1);
+}
+
+static void push_frame(int frame, const void *function, uint64_t now)
+{
+	int parent = frames.empty() ? 0 : frames.back().node;
+
+	profile_frame f;
+	f.node = find_child(parent, frame);
+	f.function = function;
+	f.trigger = frame_triggers[frame];
+	f.start = now;
+	f.child_nanoseconds = 0;
+	f.start_allocations = LuaHeap::AllocationCount();
+	f.start_allocated_bytes = LuaHeap::AllocatedBytes();
+	f.child_allocations = 0;
+	frames.push_back(f);
+
+	++nodes[f.node].calls;
+}
+
+static void pop_frame(uint64_t now)
+{
+	const profile_frame& f = frames.back();
+	profile_node& node = nodes[f.node];
+
+	uint64_t nanoseconds = now - f.start;
+	uint64_t allocations = LuaHeap::AllocationCount() - f.start_allocations;
+	node.total_nanoseconds += nanoseconds;
+	node.self_nanoseconds += nanoseconds - std::min(nanoseconds, f.child_nanoseconds);
+	node.self_allocations += allocations - std::min(allocations, f.child_allocations);
+
+	if (f.trigger != NONE)
+	{
+		trigger_stats& stats = triggers[f.trigger];
+		++stats.calls;
+		stats.total_nanoseconds += nanoseconds;
+		stats.maximum_nanoseconds = std::max(stats.maximum_nanoseconds, nanoseconds);
+		stats.allocations += allocations;
+		stats.allocated_bytes += LuaHeap::AllocatedBytes() - f.start_allocated_bytes;
+
+		int bucket = 0;
+		uint64_t limit = SHORTEST_TRIGGER_BUCKET * 1000;
+		while (bucket < NUMBER_OF_TRIGGER_BUCKETS - 1 && nanoseconds >= limit)
+		{
+			++bucket;
+			limit *= 2;
+		}
+		++stats.buckets[bucket];
+	}
+
+	frames.pop_back();
+	if (!frames.empty())
+	{
+		frames.back().child_nanoseconds += nanoseconds;
+		frames.back().child_allocations += allocations;
+	}
+}
+
+static int function_frame(lua_State *L, lua_Debug *ar, lua_CFunction cfunction)
+{
+	function_key key(ar->source, ar->linedefined, cfunction);
+	auto it = function_frames.find(key);
+	if (it != function_frames.end())
+		return it->second;
+
+	lua_getinfo(L, "n", ar);
+	std::string name = ar->name ? ar->name : "?";
+
+	// called by the engine, so nothing names it
+	const profile_frame& caller = frames.back();
+	if (!ar->name && caller.trigger != NONE)
+	{
+		const std::string& trigger = frame_names[nodes[caller.node].frame];
+		name = "Triggers." + trigger.substr(trigger.rfind('/') + 1);
+	}
+
+	std::ostringstream s;
+	if (cfunction)
+		s << name << " [C]";
+	else if (ar->what && strcmp(ar->what, "main") == 0)
+		s << "main chunk (" << ar->short_src << ")";
+	else
+		s << name << " (" << ar->short_src << ":" << ar->linedefined << ")";
+
+	frame_names.push_back(frame_name(s.str()));
+	frame_triggers.push_back(NONE);
+	int frame = static_cast<int>(frame_names.size() - 1);
+	function_frames[key] = frame;
+	return frame;
+}
+
+static void profile_hook(lua_State *L, lua_Debug *ar)
+{
+	// calls outside of triggers (loading scripts, the console) aren't counted
+	if (!lua_profiler_enabled || !profiling_functions || frames.empty())
+		return;
+
+	uint64_t now = nanosecond_count();
+
+	if (ar->event == LUA_HOOKCALL || ar->event == LUA_HOOKTAILCALL)
+	{
+		lua_getinfo(L, "Sf", ar);
+		const void *function = lua_topointer(L, -1);
+		lua_CFunction cfunction = lua_tocfunction(L, -1);
+		lua_pop(L, 1);
+
+		// the caller's frame is gone, and there will be no return for it
+		if (ar->event == LUA_HOOKTAILCALL && frames.back().function)
+			pop_frame(now);
+
+		push_frame(function_frame(L, ar, cfunction), function, now);
+	}
+	else if (ar->event == LUA_HOOKRET)
+	{
+		lua_getinfo(L, "f", ar);
+		const void *function = lua_topointer(L, -1);
+		lua_pop(L, 1);
+
+		// errors unwind without return hooks, so frames the returning function
+		// called may still be open; never look past the current trigger
+		size_t i = frames.size();
+		while (i > 0 && frames[i - 1].function && frames[i - 1].function != function)
+			--i;
+
+		if (i > 0 && frames[i - 1].function)
+		{
+			while (frames.size() >= i)
+				pop_frame(now);
+		}
+	}
+}
+
+bool LuaTriggerProfile::Begin(lua_State *L, const char *trigger)
+{
+	bool hooked = lua_gethook(L) == profile_hook;
+	bool hook = lua_profiler_enabled && profiling_functions;
+
+	// leave alone a hook set from the script with debug.sethook()
+	if (hooked && !hook)
+		lua_sethook(L, NULL, 0, 0);
+	else if (hook && !hooked && !lua_gethook(L))
+	{
+		lua_sethook(L, profile_hook, LUA_MASKCALL | LUA_MASKRET, 0);
+		lua_profiler_hooked = true;
+	}
+
+	if (!lua_profiler_enabled)
+		return false;
+
+	LuaHeap *heap = LuaHeap::Of(L);
+	std::string name = frame_name((heap ? heap->GetName() : std::string("Lua")) + "/" + trigger);
+
+	int frame;
+	auto it = trigger_frames.find(name);
+	if (it != trigger_frames.end())
+	{
+		frame = it->second;
+	}
+	else
+	{
+		trigger_stats stats = { 0, 0, 0, 0, 0, {} };
+		triggers.push_back(stats);
+
+		frame_names.push_back(name);
+		frame_triggers.push_back(static_cast<int>(triggers.size() - 1));
+		frame = static_cast<int>(frame_names.size() - 1);
+		trigger_frames[name] = frame;
+	}
+
+	push_frame(frame, NULL, nanosecond_count());
+	return true;
+}
+
+void LuaTriggerProfile::End()
+{
+	uint64_t now = nanosecond_count();
+
+	// anything the trigger left open ended with it
+	while (!frames.empty() && frames.back().function)
+		pop_frame(now);
+
+	if (!frames.empty())
+		pop_frame(now);
+}
+
+// so triggers stop going through LuaTriggerProfile::Begin()
+static void remove_profile_hooks()
+{
+	for (lua_State *L : LuaHeap::States())
+	{
+		if (lua_gethook(L) == profile_hook)
+			lua_sethook(L, NULL, 0, 0);
+	}
+
+	lua_profiler_hooked = false;
+}
+
+void L_Start_Profiling(bool functions)
+{
+	L_Reset_Profile();
+	if (!functions)
+		remove_profile_hooks();
+
+	profiling_functions = functions;
+	lua_profiler_enabled = true;
+}
+
+void L_Stop_Profiling()
+{
+	lua_profiler_enabled = false;
+	remove_profile_hooks();
+}
+
+void L_Reset_Profile()
+{
+	frame_names.clear();
+	frame_triggers.clear();
+	trigger_frames.clear();
+	function_frames.clear();
+	triggers.clear();
+	frames.clear();
+
+	nodes.clear();
+	profile_node root = { NONE, NONE, {}, 0, 0, 0, 0 };
+	nodes.push_back(root);
+}
+
+struct function_summary
+{
+	int frame;
+	uint64_t calls;
+	uint64_t self_nanoseconds;
+	uint64_t total_nanoseconds;
+	uint64_t self_allocations;
+};
+
+// calls f(node, true) on the way down the call tree and f(node, false) on the
+// way back up; scripts can recurse far deeper than the C++ stack, so this doesn't
+template <typename F>
+static void walk_call_tree(F f)
+{
+	if (nodes.empty()) return;
+
+	std::vector<std::pair<int, size_t> > stack; // node, next child
+	stack.push_back(std::make_pair(0, 0));
+	f(nodes[0], true);
+
+	while (!stack.empty())
+	{
+		auto& top = stack.back();
+		const profile_node& node = nodes[top.first];
+		if (top.second < node.children.size())
+		{
+			int child = node.children[top.second++].second;
+			stack.push_back(std::make_pair(child, 0));
+			f(nodes[child], true);
+		}
+		else
+		{
+			f(node, false);
+			stack.pop_back();
+		}
+	}
+}
+
+static std::vector<function_summary> summarize_functions()
+{
+	std::vector<function_summary> summaries(frame_names.size());
+	for (size_t i = 0; i < summaries.size(); ++i)
+	{
+		summaries[i] = { static_cast<int>(i), 0, 0, 0, 0 };
+	}
+
+	// totals only count the outermost call of a recursive function
+	std::vector<int> active(frame_names.size());
+	walk_call_tree([&summaries, &active](const profile_node& node, bool entering) {
+		if (node.frame == NONE) return;
+
+		if (!entering)
+		{
+			--active[node.frame];
+			return;
+		}
+
+		function_summary& summary = summaries[node.frame];
+		summary.calls += node.calls;
+		summary.self_nanoseconds += node.self_nanoseconds;
+		summary.self_allocations += node.self_allocations;
+		if (!active[node.frame])
+			summary.total_nanoseconds += node.total_nanoseconds;
+
+		++active[node.frame];
+	});
+
+	summaries.erase(std::remove_if(summaries.begin(), summaries.end(), [](const function_summary& summary) {
+		return frame_triggers[summary.frame] != NONE || !summary.calls;
+	}), summaries.end());
+
+	std::sort(summaries.begin(), summaries.end(), [](const function_summary& a, const function_summary& b) {
+		return a.self_nanoseconds > b.self_nanoseconds;
+	});
+
+	return summaries;
+}
+
+static std::vector<int> sorted_trigger_frames()
+{
+	std::vector<int> sorted;
+	for (auto& trigger : trigger_frames)
+		sorted.push_back(trigger.second);
+
+	std::sort(sorted.begin(), sorted.end(), [](int a, int b) {
+		return triggers[frame_triggers[a]].total_nanoseconds > triggers[frame_triggers[b]].total_nanoseconds;
+	});
+
+	return sorted;
+}
+
+std::vector<std::string> L_Summarize_Profile(size_t maximum_lines)
+{
+	std::vector<std::string> lines;
+
+	for (int frame : sorted_trigger_frames())
+	{
+		const trigger_stats& stats = triggers[frame_triggers[frame]];
+		if (!stats.calls || lines.size() >= maximum_lines) break;
+
+		std::ostringstream s;
+		s << frame_names[frame] << ": " << stats.calls << " calls, " << stats.total_nanoseconds / stats.calls / 1000 << " us avg, "
+		  << stats.maximum_nanoseconds / 1000 << " us max, " << stats.allocations / stats.calls << " allocations avg";
+		lines.push_back(s.str());
+	}
+
+	size_t trigger_lines = lines.size();
+	for (const function_summary& summary : summarize_functions())
+	{
+		if (lines.size() >= trigger_lines + maximum_lines) break;
+
+		std::ostringstream s;
+		s << frame_names[summary.frame] << ": " << summary.calls << " calls, " << summary.self_nanoseconds / 1000 << " us self, "
+		  << summary.total_nanoseconds / 1000 << " us total";
+		lines.push_back(s.str());
+	}
+
+	return lines;
+}
+
+static bool write_profile_text(FileSpecifier& file, const std::string& text)
+{
+	OpenedFile opened_file;
+	if (!file.OpenForWritingText(opened_file)) return false;
+
+	return opened_file.Write(static_cast<int32>(text.size()), const_cast<char *>(text.data()));
+}
+
+static void write_csv_field(std::ostringstream& s, const std::string& field)
+{
+	s << '"';
+	for (char c : field)
+	{
+		if (c == '"') s << '"';
+		s << c;
+	}
+	s << '"';
+}
+
+bool L_Write_Trigger_Profile(FileSpecifier& file)
+{
+	std::ostringstream s;
+	s << "trigger,calls,total_us,max_us,allocations,allocated_bytes";
+	for (int i = 0; i < NUMBER_OF_TRIGGER_BUCKETS - 1; ++i)
+		s << ",under_" << (SHORTEST_TRIGGER_BUCKET << i) << "_us";
+	s << ",longer\n";
+
+	for (int frame : sorted_trigger_frames())
+	{
+		const trigger_stats& stats = triggers[frame_triggers[frame]];
+		write_csv_field(s, frame_names[frame]);
+		s << "," << stats.calls << "," << stats.total_nanoseconds / 1000 << "," << stats.maximum_nanoseconds / 1000
+		  << "," << stats.allocations << "," << stats.allocated_bytes;
+		for (int i = 0; i < NUMBER_OF_TRIGGER_BUCKETS; ++i)
+			s << "," << stats.buckets[i];
+		s << "\n";
+	}
+
+	return write_profile_text(file, s.str());
+}
+
+bool L_Write_Function_Profile(FileSpecifier& file)
+{
+	std::ostringstream s;
+	s << "function,calls,self_us,total_us,self_allocations\n";
+
+	for (const function_summary& summary : summarize_functions())
+	{
+		write_csv_field(s, frame_names[summary.frame]);
+		s << "," << summary.calls << "," << summary.self_nanoseconds / 1000 << "," << summary.total_nanoseconds / 1000
+		  << "," << summary.self_allocations << "\n";
+	}
+
+	return write_profile_text(file, s.str());
+}
+
+// one line per call stack, with its self time in microseconds; calls deeper
+// than MAXIMUM_FLAME_GRAPH_DEPTH are lumped together under "..."
+bool L_Write_Flame_Graph(FileSpecifier& file)
+{
+	std::ostringstream s;
+	std::string path;
+	std::vector<size_t> path_lengths;
+	size_t depth = 0;
+	uint64_t deeper_nanoseconds = 0;
+
+	walk_call_tree([&](const profile_node& node, bool entering) {
+		if (node.frame == NONE) return;
+
+		if (!entering)
+		{
+			if (--depth < MAXIMUM_FLAME_GRAPH_DEPTH)
+			{
+				if (depth == MAXIMUM_FLAME_GRAPH_DEPTH - 1 && deeper_nanoseconds >= 1000)
+					s << path << ";... " << deeper_nanoseconds / 1000 << "\n";
+				deeper_nanoseconds = 0;
+
+				path.resize(path_lengths.back());
+				path_lengths.pop_back();
+			}
+			return;
+		}
+
+		if (depth++ >= MAXIMUM_FLAME_GRAPH_DEPTH)
+		{
+			deeper_nanoseconds += node.self_nanoseconds;
+			return;
+		}
+
+		path_lengths.push_back(path.size());
+		if (!path.empty()) path += ";";
+		path += frame_names[node.frame];
+
+		if (node.self_nanoseconds >= 1000)
+			s << path << " " << node.self_nanoseconds / 1000 << "\n";
+	});
+
+	return write_profile_text(file, s.str());
+}
@@ -0,0 +1,77 @@
+#ifndef __LUA_PROFILER_H
+#define __LUA_PROFILER_H
+
+/*
+LUA_PROFILER.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Times Lua triggers, and with call and return hooks the functions they
+	call; the results can be summarized from the console, or written out as
+	CSV or as collapsed stacks for flamegraph.pl and speedscope
+*/
+
+#include "cseries.h"
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <string>
+#include <vector>
+
+class FileSpecifier;
+
+extern bool lua_profiler_enabled;
+extern bool lua_profiler_hooked; // some state may still have the hook set
+
+// with functions, hooks every call; otherwise only triggers are timed
+void L_Start_Profiling(bool functions);
+void L_Stop_Profiling();
+void L_Reset_Profile();
+
+// the slowest triggers and the functions with the most self time, for the console
+std::vector<std::string> L_Summarize_Profile(size_t maximum_lines);
+
+bool L_Write_Trigger_Profile(FileSpecifier& file);
+bool L_Write_Function_Profile(FileSpecifier& file);
+bool L_Write_Flame_Graph(FileSpecifier& file);
+
+// times a trigger from just before its lua_pcall() to after it; triggers called
+// from inside other triggers (e.g. monster_damaged by monster:damage()) nest
+class LuaTriggerProfile
+{
+public:
+	LuaTriggerProfile(lua_State *L, const char *trigger) : m_active(false)
+	{
+		if (lua_profiler_enabled || lua_profiler_hooked) m_active = Begin(L, trigger);
+	}
+
+	~LuaTriggerProfile()
+	{
+		if (m_active) End();
+	}
+
+private:
+	static bool Begin(lua_State *L, const char *trigger);
+	static void End();
+
+	bool m_active;
+};
+
+#endif
@@ -33,7 +33,9 @@ LUA_MONSTERS.CPP
 #include "player.h"
 #include "projectiles.h"
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 #define DONT_REPEAT_DEFINITIONS
 #include "projectile_definitions.h"
@@ -353,8 +355,108 @@ int Lua_Projectiles_New_Projectile(lua_State *L)
 	return 1;
 }
 
+// the bulk queries below return projectiles in index order, as Projectiles() does
+static std::vector<int16> query_projectiles;
+
+// Projectiles.in_range(x, y, radius [, result])
+static int Lua_Projectiles_In_Range(lua_State *L)
+{
+	world_point2d center;
+	int32 radius;
+	L_Get_Query_Circle(L, 1, "in_range", center, radius);
+
+	query_projectiles.clear();
+	for (int16 projectile_index = 0; projectile_index < Lua_Projectiles::Length(); ++projectile_index)
+	{
+		if (!Lua_Projectile::Valid(projectile_index))
+			continue;
+
+		projectile_data *projectile = get_projectile_data(projectile_index);
+		if (L_In_Query_Circle(get_object_data(projectile->object_index)->location, center, radius))
+			query_projectiles.push_back(projectile_index);
+	}
+
+	L_Push_Array<Lua_Projectile>(L, 4, query_projectiles);
+	return 1;
+}
+
+// Projectiles.in_polygon(polygon [, result])
+static int Lua_Projectiles_In_Polygon(lua_State *L)
+{
+	short polygon_index = L_Get_Query_Polygon(L, 1, "in_polygon");
+
+	query_projectiles.clear();
+	for (short object_index = get_polygon_data(polygon_index)->first_object; object_index != NONE; )
+	{
+		object_data *object = get_object_data(object_index);
+		if (GET_OBJECT_OWNER(object) == _object_is_projectile && Lua_Projectile::Valid(object->permutation))
+			query_projectiles.push_back(object->permutation);
+		object_index = object->next_object;
+	}
+	std::sort(query_projectiles.begin(), query_projectiles.end());
+
+	L_Push_Array<Lua_Projectile>(L, 2, query_projectiles);
+	return 1;
+}
+
+// Projectiles.of_type(type [, result])
+static int Lua_Projectiles_Of_Type(lua_State *L)
+{
+	short projectile_type = Lua_ProjectileType::ToIndex(L, 1);
+
+	query_projectiles.clear();
+	for (int16 projectile_index = 0; projectile_index < Lua_Projectiles::Length(); ++projectile_index)
+	{
+		if (Lua_Projectile::Valid(projectile_index) && get_projectile_data(projectile_index)->type == projectile_type)
+			query_projectiles.push_back(projectile_index);
+	}
+
+	L_Push_Array<Lua_Projectile>(L, 2, query_projectiles);
+	return 1;
+}
+
+// Projectiles.by_owner(owner [, result]); owner is a monster or player, or nil for none
+static int Lua_Projectiles_By_Owner(lua_State *L)
+{
+	short monster_index = NONE;
+	if (lua_isnil(L, 1))
+	{
+		monster_index = NONE;
+	}
+	else if (lua_isnumber(L, 1))
+	{
+		monster_index = static_cast<int>(lua_tonumber(L, 1));
+	}
+	else if (Lua_Monster::Is(L, 1))
+	{
+		monster_index = Lua_Monster::Index(L, 1);
+	}
+	else if (Lua_Player::Is(L, 1))
+	{
+		monster_index = get_player_data(Lua_Player::Index(L, 1))->monster_index;
+	}
+	else
+	{
+		return luaL_error(L, "by_owner: incorrect argument type");
+	}
+
+	query_projectiles.clear();
+	for (int16 projectile_index = 0; projectile_index < Lua_Projectiles::Length(); ++projectile_index)
+	{
+		if (Lua_Projectile::Valid(projectile_index) && get_projectile_data(projectile_index)->owner_index == monster_index)
+			query_projectiles.push_back(projectile_index);
+	}
+
+	L_Push_Array<Lua_Projectile>(L, 2, query_projectiles);
+	return 1;
+}
+
 const luaL_Reg Lua_Projectiles_Methods[] = {
+	{"by_owner", L_TableFunction<Lua_Projectiles_By_Owner>},
+	{"in_polygon", L_TableFunction<Lua_Projectiles_In_Polygon>},
+	{"in_range", L_TableFunction<Lua_Projectiles_In_Range>},
 	{"new", L_TableFunction<Lua_Projectiles_New_Projectile>},
+	{"of_type", L_TableFunction<Lua_Projectiles_Of_Type>},
 	{0, 0}
 };
 
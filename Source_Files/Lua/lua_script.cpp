@@ -111,6 +111,8 @@ extern "C"
 #include "interpolated_world.h"
 
 #include "lua_script.h"
+#include "lua_heap.h"
+#include "lua_profiler.h"
 #include "lua_music.h"
 #include "lua_ephemera.h"
 #include "lua_map.h"
@@ -188,8 +190,8 @@ class LuaState
 {
 	friend bool CollectLuaStats(std::map<std::string, std::string>&, std::map<std::string, std::string>&);
 public:
-	LuaState() : running_(false), num_scripts_(0) {
-		state_.reset(luaL_newstate(), lua_close);
+	LuaState() : heap_(new LuaHeap), running_(false), num_scripts_(0) {
+		state_.reset(heap_->NewState(), lua_close);
 	}
 
 	virtual ~LuaState() {
@@ -205,6 +207,8 @@ public:
 	bool Matches(lua_State *state) { return state == State(); }
 	void MarkCollections(std::set<short>* collections);
 	void ExecuteCommand(const std::string& line);
+	void CollectGarbage() { heap_->Step(State()); }
+	void SetHeapName(const std::string& name) { heap_->SetName(name); }
 	std::string SavePassed();
 	std::string SaveAll();
 
@@ -250,10 +254,12 @@ public:
 protected:
 	bool GetTrigger(const char *trigger);
 	void CallTrigger(int numArgs = 0);
+	const char *trigger_ = nullptr; // the last one GetTrigger() found
 
 	virtual void RegisterFunctions();
 	virtual void LoadCompatibility();
 
+	std::unique_ptr<LuaHeap> heap_; // outlives state_
 	std::shared_ptr<lua_State> state_;
 	lua_State* State() { return state_.get(); }
 
@@ -335,11 +341,13 @@ bool LuaState::GetTrigger(const char* trigger)
 	}
 
 	lua_remove(State(), -2);
+	trigger_ = trigger;
 	return true;
 }
 
 void LuaState::CallTrigger(int numArgs)
 {
+	LuaTriggerProfile profile(State(), trigger_);
 	if (lua_pcall(State(), numArgs, 0, 0) == LUA_ERRRUN)
 		L_Error(lua_tostring(State(), -1));
 }
@@ -1217,6 +1225,9 @@ void L_Call_Idle()
 void L_Call_PostIdle()
 {
 	L_Dispatch(std::bind(&LuaState::PostIdle, std::placeholders::_1));
+
+	// the tick's triggers are done; collect now rather than during the next ones
+	L_Dispatch(std::bind(&LuaState::CollectGarbage, std::placeholders::_1));
 }
 
 void L_Call_Start_Refuel (short type, short player_index, short panel_side_index)
@@ -1764,19 +1775,47 @@ static int L_Prompt(lua_State *L)
 
 
 
+static const char *LuaScriptDescription(ScriptType script_type)
+{
+	const char *desc = "level_script";
+	switch (script_type) {
+		case _embedded_lua_script:
+			desc = "Map Lua";
+			break;
+		case _lua_netscript:
+			desc = "Netscript";
+			break;
+		case _solo_lua_script:
+			desc = "Solo Lua";
+			break;
+		case _stats_lua_script:
+			desc = "Stats Lua";
+			break;
+	}
+	return desc;
+}
+
 static std::unique_ptr<LuaState> LuaStateFactory(ScriptType script_type)
 {
+	std::unique_ptr<LuaState> state;
 	switch (script_type) {
 	case _embedded_lua_script:
-        return std::make_unique<EmbeddedLuaState>();
+        state = std::make_unique<EmbeddedLuaState>();
+        break;
 	case _lua_netscript:
-        return std::make_unique<NetscriptState>();
+        state = std::make_unique<NetscriptState>();
+        break;
 	case _solo_lua_script:
-        return std::make_unique<SoloScriptState>();
+        state = std::make_unique<SoloScriptState>();
+        break;
 	case _stats_lua_script:
-        return std::make_unique<StatsLuaState>();
+        state = std::make_unique<StatsLuaState>();
+        break;
 	}
-    return nullptr;
+
+	if (state)
+		state->SetHeapName(LuaScriptDescription(script_type));
+    return state;
 }
 
 bool LoadLuaScript(const char *buffer, size_t len, ScriptType script_type)
@@ -1787,22 +1826,7 @@ bool LoadLuaScript(const char *buffer, size_t len, ScriptType script_type)
 		states.insert({ script_type, LuaStateFactory(script_type) });
 		states[script_type]->Initialize();
 	}
-	const char *desc = "level_script";
-	switch (script_type) {
-		case _embedded_lua_script:
-			desc = "Map Lua";
-			break;
-		case _lua_netscript:
-			desc = "Netscript";
-			break;
-		case _solo_lua_script:
-			desc = "Solo Lua";
-			break;
-		case _stats_lua_script:
-			desc = "Stats Lua";
-			break;
-	}
-	return states[script_type]->Load(buffer, len, desc);
+	return states[script_type]->Load(buffer, len, LuaScriptDescription(script_type));
 }
 
 #ifdef HAVE_OPENGL
@@ -21,6 +21,12 @@ LUA_TEMPLATES.H
 	http://www.gnu.org/licenses/gpl.html
 
 	Templates to help create the Lua/C interface
+
+Oct 16, 2026:
+	__index and __newindex are closures over the class's accessor table and metatable, and
+	call C accessors directly, so reading a field no longer costs two registry lookups, a
+	luaL_checkudata() and a lua_pcall().  Push() and Invalidate() use raw integer lookups.
+	Added L_Push_Array() and L_Push_Number_Array() for the bulk queries.
 */
 
 #include "cseries.h"
@@ -38,6 +44,7 @@ extern "C"
 #include <map>
 #include <new>
 #include <functional>
+#include <vector>
 
 static inline int luaL_typerror(lua_State* L, int narg, const char* tname)
 {
@@ -67,6 +74,60 @@ int L_TableFunction(lua_State *L)
 	return 1;
 }
 
+// for queries that return many things at once: the results go in the table at result_index,
+// or a new table if that isn't one, from 1 on with nothing after them, and the table is left on
+// the stack.  a script asking every tick can pass its last result back in to reuse it
+
+static inline void L_Truncate_Array(lua_State *L, int length)
+{
+	for (int i = length + 1; ; ++i)
+	{
+		lua_rawgeti(L, -1, i);
+		bool empty = lua_isnil(L, -1);
+		lua_pop(L, 1);
+		if (empty)
+			break;
+
+		lua_pushnil(L);
+		lua_rawseti(L, -2, i);
+	}
+}
+
+template<class T>
+void L_Push_Array(lua_State *L, int result_index, const std::vector<int16>& indexes)
+{
+	if (lua_istable(L, result_index))
+		lua_pushvalue(L, result_index);
+	else
+		lua_createtable(L, static_cast<int>(indexes.size()), 0);
+
+	int length = 0;
+	for (int16 index : indexes)
+	{
+		T::Push(L, index);
+		lua_rawseti(L, -2, ++length);
+	}
+
+	L_Truncate_Array(L, length);
+}
+
+static inline void L_Push_Number_Array(lua_State *L, int result_index, const std::vector<double>& numbers)
+{
+	if (lua_istable(L, result_index))
+		lua_pushvalue(L, result_index);
+	else
+		lua_createtable(L, static_cast<int>(numbers.size()), 0);
+
+	int length = 0;
+	for (double number : numbers)
+	{
+		lua_pushnumber(L, number);
+		lua_rawseti(L, -2, ++length);
+	}
+
+	L_Truncate_Array(L, length);
+}
+
 template<char *name, typename index_t = int16>
 class L_Class {
 public:
@@ -110,6 +171,10 @@ protected:
 	static instance_t *NewInstance(lua_State *L, index_t index);
 
 	static int _get(lua_State *L);
+
+	// pushes f as a closure over the accessor table and the metatable, for __index (set is
+	// false) or __newindex; anything standing in for _get() or _set() must be made this way
+	static void _push_accessor_closure(lua_State *L, lua_CFunction f, bool set);
 	
 	// registry keys
 	static void _push_get_methods_key(lua_State *L) {
@@ -126,6 +191,11 @@ protected:
 
 	// special tables
 	static void _push_custom_fields_table(lua_State *L);
+
+private:
+	static void _check_self(lua_State *L);
+	static lua_CFunction _plain_accessor(lua_State *L, int index);
+	static void _pcall_accessor(lua_State *L, int nargs, int nresults);
 };
 
 struct always_valid
@@ -139,7 +209,32 @@ std::function<bool (index_t)> L_Class<name, index_t>::Valid = always_valid();
 template<char *name, typename index_t>
 void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const luaL_Reg set[], const luaL_Reg metatable[])
 {
-	// create the metatable itself
+	// register get methods
+	_push_get_methods_key(L);
+	lua_newtable(L);
+
+	// always want index
+	lua_pushcfunction(L, _index);
+	lua_setfield(L, -2, "index");
+
+	if (get)
+		luaL_setfuncs(L, get, 0);
+	lua_settable(L, LUA_REGISTRYINDEX);
+
+	// register set methods
+	_push_set_methods_key(L);
+	lua_newtable(L);
+
+	if (set)
+		luaL_setfuncs(L, set, 0);
+	lua_settable(L, LUA_REGISTRYINDEX);
+		
+	// register a table for instances
+	_push_instances_key(L);
+	lua_newtable(L);
+	lua_settable(L, LUA_REGISTRYINDEX);
+
+	// create the metatable itself; __index and __newindex need the tables above
 	luaL_newmetatable(L, name);
 
 	// Lua 5.1 doesn't do this reverse mapping any more--do it ourselves
@@ -148,11 +243,11 @@ void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const
 	lua_settable(L, LUA_REGISTRYINDEX);
 
 	// register metatable get
-	lua_pushcfunction(L, _get);
+	_push_accessor_closure(L, _get, false);
 	lua_setfield(L, -2, "__index");
 
 	// register metatable set
-	lua_pushcfunction(L, _set);
+	_push_accessor_closure(L, _set, true);
 	lua_setfield(L, -2, "__newindex");
 
 	// register metatable tostring
@@ -167,31 +262,6 @@ void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const
 	
 	// clear the stack
 	lua_pop(L, 1);
-	
-	// register get methods
-	_push_get_methods_key(L);
-	lua_newtable(L);
-
-	// always want index
-	lua_pushcfunction(L, _index);
-	lua_setfield(L, -2, "index");
-
-	if (get)
-		luaL_setfuncs(L, get, 0);
-	lua_settable(L, LUA_REGISTRYINDEX);
-
-	// register set methods
-	_push_set_methods_key(L);
-	lua_newtable(L);
-
-	if (set)
-		luaL_setfuncs(L, set, 0);
-	lua_settable(L, LUA_REGISTRYINDEX);
-		
-	// register a table for instances
-	_push_instances_key(L);
-	lua_newtable(L);
-	lua_settable(L, LUA_REGISTRYINDEX);
 
 	// register is_
 	lua_pushcfunction(L, _is);
@@ -199,6 +269,18 @@ void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const
 	lua_setglobal(L, is_name.c_str());
 }
 
+template<char *name, typename index_t>
+void L_Class<name, index_t>::_push_accessor_closure(lua_State *L, lua_CFunction f, bool set)
+{
+	if (set)
+		_push_set_methods_key(L);
+	else
+		_push_get_methods_key(L);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+	luaL_getmetatable(L, name);
+	lua_pushcclosure(L, f, 2);
+}
+
 template<char *name, typename index_t>
 template<typename instance_t>
 instance_t *L_Class<name, index_t>::NewInstance(lua_State *L, index_t index)
@@ -244,11 +326,8 @@ instance_t *L_Class<name, index_t>::Push(lua_State *L, index_t index)
 	}
 
 	// look it up in the index table
-	_push_instances_key(L);
-	lua_gettable(L, LUA_REGISTRYINDEX);
-
-	lua_pushnumber(L, index);
-	lua_gettable(L, -2);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, (void *) (&name[3]));
+	lua_rawgeti(L, -1, index);
 
 	if (lua_isnil(L, -1)) 
 	{
@@ -258,9 +337,8 @@ instance_t *L_Class<name, index_t>::Push(lua_State *L, index_t index)
 		t = NewInstance<instance_t>(L, index);
 
 		// insert it into the instance table
-		lua_pushnumber(L, index);
-		lua_pushvalue(L, -2);
-		lua_settable(L, -4);
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, -3, index);
 
 	}
 	else
@@ -310,12 +388,9 @@ template<char *name, typename index_t>
 void L_Class<name, index_t>::Invalidate(lua_State *L, index_t index)
 {
 	// remove it from the index table
-	_push_instances_key(L);
-	lua_gettable(L, LUA_REGISTRYINDEX);
-
-	lua_pushnumber(L, index);
+	lua_rawgetp(L, LUA_REGISTRYINDEX, (void *) (&name[3]));
 	lua_pushnil(L);
-	lua_settable(L, -3);
+	lua_rawseti(L, -2, index);
 	lua_pop(L, 1);
 
 	// clear custom fields
@@ -345,20 +420,65 @@ int L_Class<name, index_t>::_is(lua_State *L)
 	return 1;
 }
 
+// what luaL_checkudata(L, 1, name) checks, against the metatable upvalue instead of the registry
+template<char *name, typename index_t>
+void L_Class<name, index_t>::_check_self(lua_State *L)
+{
+	if (lua_type(L, 1) == LUA_TUSERDATA && lua_getmetatable(L, 1))
+	{
+		bool same = lua_rawequal(L, -1, lua_upvalueindex(2));
+		lua_pop(L, 1);
+		if (same)
+			return;
+	}
+
+	// for the error
+	luaL_checktype(L, 1, LUA_TUSERDATA);
+	luaL_checkudata(L, 1, name);
+}
+
+// a C accessor with no upvalues of its own can run in our frame instead of through lua_pcall()
+template<char *name, typename index_t>
+lua_CFunction L_Class<name, index_t>::_plain_accessor(lua_State *L, int index)
+{
+	lua_CFunction f = lua_tocfunction(L, index);
+	if (f && lua_getupvalue(L, index, 1))
+	{
+		lua_pop(L, 1);
+		f = 0;
+	}
+
+	return f;
+}
+
+template<char *name, typename index_t>
+void L_Class<name, index_t>::_pcall_accessor(lua_State *L, int nargs, int nresults)
+{
+	if (lua_pcall(L, nargs, nresults, 0) == LUA_ERRRUN)
+	{
+		// report the error as being on this line
+		luaL_where(L, 1);
+		lua_pushvalue(L, -2);
+		lua_concat(L, 2);
+		lua_error(L);
+	}
+}
+
 template<char *name, typename index_t>
 int L_Class<name, index_t>::_get(lua_State *L)
 {
 	if (lua_isstring(L, 2))
 	{
-		luaL_checktype(L, 1, LUA_TUSERDATA);
-		luaL_checkudata(L, 1, name);
-		if (!Valid(Index(L, 1)) && strcmp(lua_tostring(L, 2), "valid") != 0 && strcmp(lua_tostring(L, 2), "index") != 0)
+		_check_self(L);
+		index_t index = Index(L, 1);
+		const char *key = lua_tostring(L, 2);
+		if (!Valid(index) && strcmp(key, "valid") != 0 && strcmp(key, "index") != 0)
 			luaL_error(L, "invalid object");
 
-		if (lua_tostring(L, 2)[0] == '_')
+		if (key[0] == '_')
 		{
 			_push_custom_fields_table(L);
-			lua_pushnumber(L, Index(L, 1));
+			lua_pushnumber(L, index);
 			lua_gettable(L, -2);
 			if (lua_istable(L, -1))
 			{
@@ -376,27 +496,27 @@ int L_Class<name, index_t>::_get(lua_State *L)
 		}
 		else
 		{
-			// pop the get table
-			_push_get_methods_key(L);
-			lua_gettable(L, LUA_REGISTRYINDEX);
-
-			// get the function from that table
+			// get the function from the get table
 			lua_pushvalue(L, 2);
-			lua_gettable(L, -2);
-			lua_remove(L, -2);
-		
-			if (lua_isfunction(L, -1))
+			lua_rawget(L, lua_upvalueindex(1));
+
+			lua_CFunction f = _plain_accessor(L, -1);
+			if (f)
+			{
+				// with the object as its only argument, and one result, as lua_pcall() gave it;
+				// its errors already point at the script's line
+				lua_settop(L, 1);
+				int results = f(L);
+				if (results == 0)
+					lua_pushnil(L);
+				else if (results > 1)
+					lua_pop(L, results - 1);
+			}
+			else if (lua_isfunction(L, -1))
 			{
 				// execute the function with table as our argument
 				lua_pushvalue(L, 1);
-				if (lua_pcall(L, 1, 1, 0) == LUA_ERRRUN)
-				{
-					// report the error as being on this line
-					luaL_where(L, 1);
-					lua_pushvalue(L, -2);
-					lua_concat(L, 2);
-					lua_error(L);
-				}
+				_pcall_accessor(L, 1, 1);
 			}
 			else
 			{
@@ -432,8 +552,7 @@ int L_Class<name, index_t>::_new(lua_State *L)
 template<char *name, typename index_t>
 int L_Class<name, index_t>::_set(lua_State *L)
 {
-	luaL_checktype(L, 1, LUA_TUSERDATA);
-	luaL_checkudata(L, 1, name);
+	_check_self(L);
 
 	if (lua_isstring(L, 2) && lua_tostring(L, 2)[0] == '_')
 	{
@@ -467,32 +586,30 @@ int L_Class<name, index_t>::_set(lua_State *L)
 	}
 	else
 	{
-		// pop the set table
-		_push_set_methods_key(L);
-		lua_gettable(L, LUA_REGISTRYINDEX);
-		
-		// get the function from that table
+		// get the function from the set table
 		lua_pushvalue(L, 2);
-		lua_gettable(L, -2);
+		lua_rawget(L, lua_upvalueindex(1));
 		
 		if (lua_isnil(L, -1))
 		{
 			luaL_error(L, "no such index");
 		}
 		
-		// execute the function with table, value as our arguments
-		lua_pushvalue(L, 1);
-		lua_pushvalue(L, 3);
-		if (lua_pcall(L, 2, 0, 0) == LUA_ERRRUN)
+		lua_CFunction f = _plain_accessor(L, -1);
+		if (f)
 		{
-			// report the error as being on this line
-			luaL_where(L, 1);
-			lua_pushvalue(L, -2);
-			lua_concat(L, 2);
-			lua_error(L);
+			// with table, value as its arguments
+			lua_settop(L, 3);
+			lua_remove(L, 2);
+			f(L);
+		}
+		else
+		{
+			// execute the function with table, value as our arguments
+			lua_pushvalue(L, 1);
+			lua_pushvalue(L, 3);
+			_pcall_accessor(L, 2, 0);
 		}
-		
-		lua_pop(L, 1);
 	}
 
 	return 0;
@@ -799,7 +916,7 @@ void L_Container<name, T>::Register(lua_State *L, const luaL_Reg get[], const lu
 	L_Class<name>::Register(L, get, set, metatable);
 	luaL_getmetatable(L, name);
 	
-	lua_pushcfunction(L, _get_container);
+	L_Class<name>::_push_accessor_closure(L, _get_container, false);
 	lua_setfield(L, -2, "__index");
 	
 	lua_pushcfunction(L, _call);
@@ -890,7 +1007,7 @@ void L_EnumContainer<name, T>::Register(lua_State *L, const luaL_Reg methods[],
 	
 	luaL_getmetatable(L, name);
 
-	lua_pushcfunction(L, _get_enumcontainer);
+	L_Container<name, T>::_push_accessor_closure(L, _get_enumcontainer, false);
 	lua_setfield(L, -2, "__index");
 
 	lua_pop(L, 1);
@@ -39,6 +39,13 @@
 #include "FileHandler.h"
 #include "game_wad.h"
 
+// for profiling
+#include "TickProfiler.h"
+#include "SoundManager.h"
+#include "lua_heap.h"
+#include "lua_profiler.h"
+#include "OGL_Setup.h"
+
 #include <boost/algorithm/string/predicate.hpp>
 
 using namespace std;
@@ -50,6 +57,9 @@ Console::Console() : m_active(false), m_carnage_messages_exist(false), m_use_lua
 	m_command_iter = m_prev_commands.end();
 	m_carnage_messages.resize(NUMBER_OF_PROJECTILE_TYPES);
 	register_save_commands();
+	register_profile_commands();
+	register_sound_commands();
+	register_lua_commands();
 }
 
 Console *Console::instance() {
@@ -456,6 +466,227 @@ void Console::clear_saves()
 	last_level.clear();
 }
 
+struct start_profiling
+{
+	void operator() (const std::string&) const {
+		reset_tick_profiler();
+		set_tick_profiler_enabled(true);
+		screen_printf("Profiling started");
+	}
+};
+
+struct stop_profiling
+{
+	void operator() (const std::string&) const {
+		set_tick_profiler_enabled(false);
+		screen_printf("Profiling stopped");
+	}
+};
+
+struct show_profile
+{
+	void operator() (const std::string&) const {
+		auto lines = summarize_tick_profile(5);
+		if (lines.empty())
+		{
+			screen_printf("Nothing profiled; try .profile start");
+			return;
+		}
+
+		for (auto& line : lines)
+			screen_printf("%s", line.c_str());
+	}
+};
+
+struct show_load_times
+{
+	void operator() (const std::string&) const {
+		auto lines = OGL_SummarizeLoadTimes(6);
+		if (lines.empty())
+		{
+			screen_printf("No replacement textures or models loaded");
+			return;
+		}
+
+		for (auto& line : lines)
+			screen_printf("%s", line.c_str());
+	}
+};
+
+// writes the buffered samples to the local data directory
+struct write_profile
+{
+	write_profile(bool trace) : m_trace(trace) { }
+
+	void operator() (const std::string& arg) const {
+		std::string filename = arg;
+		if (filename == "")
+			filename = m_trace ? "profile.json" : "profile.csv";
+
+		FileSpecifier fs;
+		fs.SetToLocalDataDir();
+		fs += filename;
+		if (m_trace ? write_tick_profile_trace(fs) : write_tick_profile_csv(fs))
+			screen_printf("Saved %s", utf8_to_mac_roman(fs.GetPath()).c_str());
+		else
+			screen_printf("An error occurred while saving the profile");
+	}
+
+private:
+	bool m_trace;
+};
+
+void Console::register_profile_commands()
+{
+	CommandParser profileParser;
+	profileParser.register_command("start", start_profiling());
+	profileParser.register_command("stop", stop_profiling());
+	profileParser.register_command("show", show_profile());
+	profileParser.register_command("load", show_load_times());
+	profileParser.register_command("csv", write_profile(false));
+	profileParser.register_command("trace", write_profile(true));
+	register_command("profile", profileParser);
+}
+
+struct show_sound_stats
+{
+	void operator() (const std::string&) const {
+		SoundManager::CacheStats stats = SoundManager::instance()->GetCacheStats();
+		uint32 loads = stats.hits + stats.misses;
+		screen_printf("%d sounds in memory, %u of %u KB", stats.sounds_resident, static_cast<unsigned>(stats.bytes_resident >> 10), static_cast<unsigned>(stats.bytes_limit >> 10));
+		screen_printf("%u hits, %u misses (%u%% hit), %u prefetched, %u evictions", stats.hits, stats.misses, loads ? stats.hits * 100 / loads : 0, stats.prefetches, stats.evictions);
+	}
+};
+
+struct reset_sound_stats
+{
+	void operator() (const std::string&) const {
+		SoundManager::instance()->ResetCacheStats();
+		screen_printf("Sound statistics reset");
+	}
+};
+
+void Console::register_sound_commands()
+{
+	CommandParser soundParser;
+	soundParser.register_command("stats", show_sound_stats());
+	soundParser.register_command("reset", reset_sound_stats());
+	register_command("sound", soundParser);
+}
+
+struct show_lua_stats
+{
+	void operator() (const std::string&) const {
+		std::vector<LuaHeapStats> heaps = L_Get_Heap_Stats();
+		if (heaps.empty())
+			screen_printf("No Lua states");
+
+		for (const LuaHeapStats& stats : heaps) {
+			screen_printf("%s: %u KB in use, %u KB peak, %u KB pooled", stats.name.c_str(), static_cast<unsigned>(stats.bytes_in_use >> 10), static_cast<unsigned>(stats.peak_bytes >> 10), static_cast<unsigned>(stats.pooled_bytes >> 10));
+			screen_printf("%u GC steps (%u cycles), %u us average, %u us longest", stats.steps, stats.cycles, stats.steps ? static_cast<unsigned>(stats.step_microseconds / stats.steps) : 0, stats.longest_step_microseconds);
+		}
+	}
+};
+
+struct reset_lua_stats
+{
+	void operator() (const std::string&) const {
+		L_Reset_Heap_Stats();
+		screen_printf("Lua statistics reset");
+	}
+};
+
+// with "triggers", only times triggers, without hooking every function call
+struct start_lua_profiling
+{
+	void operator() (const std::string& arg) const {
+		bool functions = arg != "triggers";
+		L_Start_Profiling(functions);
+		screen_printf(functions ? "Lua profiling started" : "Lua trigger profiling started");
+	}
+};
+
+struct stop_lua_profiling
+{
+	void operator() (const std::string&) const {
+		L_Stop_Profiling();
+		screen_printf("Lua profiling stopped");
+	}
+};
+
+struct show_lua_profile
+{
+	void operator() (const std::string&) const {
+		auto lines = L_Summarize_Profile(4);
+		if (lines.empty())
+		{
+			screen_printf("No Lua triggers profiled; try .lua profile start");
+			return;
+		}
+
+		for (auto& line : lines)
+			screen_printf("%s", line.c_str());
+	}
+};
+
+// writes the profile to the local data directory
+struct write_lua_profile
+{
+	enum { _triggers, _functions, _flame_graph };
+
+	write_lua_profile(int kind) : m_kind(kind) { }
+
+	void operator() (const std::string& arg) const {
+		std::string filename = arg;
+		if (filename == "")
+		{
+			switch (m_kind)
+			{
+			case _triggers: filename = "lua_triggers.csv"; break;
+			case _functions: filename = "lua_functions.csv"; break;
+			default: filename = "lua_profile.folded"; break;
+			}
+		}
+
+		FileSpecifier fs;
+		fs.SetToLocalDataDir();
+		fs += filename;
+
+		bool saved;
+		switch (m_kind)
+		{
+		case _triggers: saved = L_Write_Trigger_Profile(fs); break;
+		case _functions: saved = L_Write_Function_Profile(fs); break;
+		default: saved = L_Write_Flame_Graph(fs); break;
+		}
+
+		if (saved)
+			screen_printf("Saved %s", utf8_to_mac_roman(fs.GetPath()).c_str());
+		else
+			screen_printf("An error occurred while saving the profile");
+	}
+
+private:
+	int m_kind;
+};
+
+void Console::register_lua_commands()
+{
+	CommandParser luaProfileParser;
+	luaProfileParser.register_command("start", start_lua_profiling());
+	luaProfileParser.register_command("stop", stop_lua_profiling());
+	luaProfileParser.register_command("show", show_lua_profile());
+	luaProfileParser.register_command("triggers", write_lua_profile(write_lua_profile::_triggers));
+	luaProfileParser.register_command("functions", write_lua_profile(write_lua_profile::_functions));
+	luaProfileParser.register_command("flame", write_lua_profile(write_lua_profile::_flame_graph));
+
+	CommandParser luaParser;
+	luaParser.register_command("stats", show_lua_stats());
+	luaParser.register_command("reset", reset_lua_stats());
+	luaParser.register_command("profile", luaProfileParser);
+	register_command("lua", luaParser);
+}
+
 void reset_mml_console()
 {
 	Console *console = Console::instance();
@@ -111,6 +111,9 @@ private:
 	bool m_use_lua_console;
 
 	void register_save_commands();
+	void register_profile_commands();
+	void register_sound_commands();
+	void register_lua_commands();
 };
 
 class InfoTree;
@@ -22,6 +22,8 @@
 	Jan. 16, 2003 (Woody Zenfell): Created.
 
 	May 21, 2003 (Woody Zenfell): being a little more defensive about NULL file pointer.
+
+	Oct 16, 2026: deferred logging for worker threads.
 */
 
 #include "Logging.h"
@@ -49,6 +51,7 @@ static int	sLoggingThreshhold = logNoteLevel;	// log messages at or above this l
 static bool	sShowLocations	= true;			// should filenames and line numbers be printed as well?
 static bool	sFlushOutput	= false;		// flush output after every log-write?  (good if crash expected)
 const char*	logDomain	= "global";
+static thread_local DeferredLog*	sDeferredLog = NULL;	// this thread's messages go here instead, if set
 
 
 static void InitializeLogging();
@@ -75,11 +78,28 @@ Logger::pushLogContext(const char* inFile, int inLine, const char* inContext, ..
 }
 
 
+static void
+deferMessageV(const char* inDomain, int inLevel, const char* inFile, int inLine, const char* inMessage, va_list inArgs) {
+    // the threshhold only changes on the main thread, between loads
+    if(inLevel >= sLoggingThreshhold)
+        return;
+
+    char	stringBuffer[kStringBufferSize];
+    vsnprintf(stringBuffer, kStringBufferSize, inMessage, inArgs);
+
+    DeferredLogMessage	theMessage = { inDomain, inLevel, inFile, inLine, stringBuffer };
+    sDeferredLog->push_back(theMessage);
+}
+
+
 void
 Logger::logMessage(const char* inDomain, int inLevel, const char* inFile, int inLine, const char* inMessage, ...) {
     va_list theVarArgs;
     va_start(theVarArgs, inMessage);
-    logMessageV(inDomain, inLevel, inFile, inLine, inMessage, theVarArgs);
+    if(sDeferredLog != NULL)
+        deferMessageV(inDomain, inLevel, inFile, inLine, inMessage, theVarArgs);
+    else
+        logMessageV(inDomain, inLevel, inFile, inLine, inMessage, theVarArgs);
     va_end(theVarArgs);
 }
 
@@ -88,10 +108,28 @@ void
 Logger::logMessageNMT(const char* inDomain, int inLevel, const char* inFile, int inLine, const char* inMessage, ...) {
 	va_list theVarArgs;
 	va_start(theVarArgs, inMessage);
-	logMessageV(inDomain, inLevel, inFile, inLine, inMessage, theVarArgs);
+	if(sDeferredLog != NULL)
+		deferMessageV(inDomain, inLevel, inFile, inLine, inMessage, theVarArgs);
+	else
+		logMessageV(inDomain, inLevel, inFile, inLine, inMessage, theVarArgs);
 	va_end(theVarArgs);
 }
 
+
+void
+deferLogging(DeferredLog* outLog) {
+    sDeferredLog = outLog;
+}
+
+
+void
+logDeferredMessages(const DeferredLog& inLog) {
+    assert(sDeferredLog == NULL);
+
+    for(const DeferredLogMessage& theMessage : inLog)
+        GetCurrentLogger()->logMessage(theMessage.mDomain, theMessage.mLevel, theMessage.mFile, theMessage.mLine, "%s", theMessage.mMessage.c_str());
+}
+
 Logger::~Logger() {
 }
 
@@ -25,6 +25,9 @@
 	Split out the repetitive bits to Logging_gruntwork.h; now generating that with a script
 	Now offering logWarningNMT3() and co. for use in non-main threads, for added safety
 	New Logging level 'summary'
+
+ Oct 16, 2026:
+	Worker threads can defer their messages for the main thread to log later
 */
 
 #ifndef LOGGING_H
@@ -32,6 +35,9 @@
 
 #include <stdarg.h>
 
+#include <string>
+#include <vector>
+
 enum {
 	logFatalLevel	= 0,	// program must exit
 	logErrorLevel	= 10,	// can't do something significant
@@ -75,6 +81,24 @@ void reset_mml_logging();
 // Log file name, for display in error messages
 const char *loggingFileName();
 
+// A message a worker thread logged while it was deferring
+struct DeferredLogMessage {
+	const char*	mDomain;
+	int	mLevel;
+	const char*	mFile;
+	int	mLine;
+	std::string	mMessage;
+};
+
+typedef std::vector<DeferredLogMessage> DeferredLog;
+
+// While a thread has a deferred log, its log*() and log*NMT() calls append to it
+// instead of writing out, so code that only ever logged from the main thread can
+// run on a worker; NULL resumes logging normally.  The main thread then logs what
+// was collected with logDeferredMessages().
+void deferLogging(DeferredLog* outLog);
+void logDeferredMessages(const DeferredLog& inLog);
+
 
 // Catch-all domain for use when nobody overrides us
 extern const char* logDomain;
@@ -0,0 +1,43 @@
+#ifndef SCOPED_MUTEX_H
+#define SCOPED_MUTEX_H
+
+/*
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Holds an SDL mutex for the life of a block
+*/
+
+#include <SDL2/SDL_mutex.h>
+
+class ScopedMutex
+{
+public:
+	ScopedMutex(SDL_mutex* mutex) : mutex_(mutex) {
+		SDL_LockMutex(mutex_);
+	}
+
+	~ScopedMutex() { 
+		SDL_UnlockMutex(mutex_);
+	}
+private:
+	ScopedMutex(const ScopedMutex&);
+	ScopedMutex& operator=(const ScopedMutex&);
+
+	SDL_mutex* mutex_;
+};
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "Statistics.h"
 #include "HTTP.h"
+#include "ScopedMutex.h"
 #include "lua_script.h"
 
 #include "sdl_widgets.h"
@@ -30,20 +31,6 @@
 #include <functional>
 #include <sstream>
 
-class ScopedMutex
-{
-public:
-	ScopedMutex(SDL_mutex* mutex) : mutex_(mutex) {
-		SDL_LockMutex(mutex_);
-	}
-
-	~ScopedMutex() { 
-		SDL_UnlockMutex(mutex_);
-	}
-private:
-	SDL_mutex* mutex_;
-};
-
 StatsManager::StatsManager() : thread_(0), run_(true), busy_(false)
 {
 	entry_mutex_ = SDL_CreateMutex();
@@ -0,0 +1,219 @@
+/*
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Per-subsystem tick profiler
+*/
+
+#include "TickProfiler.h"
+
+#include "FileHandler.h"
+#include "map.h"
+
+#include <algorithm>
+#include <sstream>
+
+struct profile_sample
+{
+	uint64_t start;
+	uint32 duration;
+	int32 tick;
+	int16 section;
+};
+
+bool tick_profiler_enabled = false;
+
+static std::vector<profile_sample> profile_samples;
+static size_t next_profile_sample = 0;
+static bool profile_samples_wrapped = false;
+static uint64_t profile_section_microseconds[NUMBER_OF_PROFILE_SECTIONS];
+
+static const char *profile_section_names[NUMBER_OF_PROFILE_SECTIONS] =
+{
+	"lua",
+	"lights",
+	"medias",
+	"platforms",
+	"control panels",
+	"players",
+	"projectiles",
+	"monsters",
+	"effects",
+	"objects",
+	"ambient sounds",
+	"scenery",
+	"ephemera",
+	"items",
+	"textures",
+	"chase cam",
+	"motion sensor",
+	"exploration",
+	"network",
+
+	"visibility tree",
+	"sort polygons",
+	"place objects",
+	"rasterize",
+	"overhead map"
+};
+
+void set_tick_profiler_enabled(bool enabled)
+{
+	if (enabled && profile_samples.empty())
+	{
+		profile_samples.resize(MAXIMUM_PROFILE_SAMPLES);
+	}
+
+	tick_profiler_enabled = enabled;
+}
+
+void reset_tick_profiler()
+{
+	next_profile_sample = 0;
+	profile_samples_wrapped = false;
+	objlist_clear(profile_section_microseconds, NUMBER_OF_PROFILE_SECTIONS);
+}
+
+const char *get_profile_section_name(short section)
+{
+	assert(section >= 0 && section < NUMBER_OF_PROFILE_SECTIONS);
+	return profile_section_names[section];
+}
+
+uint64_t get_profile_section_microseconds(short section)
+{
+	assert(section >= 0 && section < NUMBER_OF_PROFILE_SECTIONS);
+	return profile_section_microseconds[section];
+}
+
+void record_profile_sample(short section, uint64_t start, uint64_t end)
+{
+	assert(section >= 0 && section < NUMBER_OF_PROFILE_SECTIONS);
+	if (profile_samples.empty()) return;
+
+	profile_sample& sample = profile_samples[next_profile_sample];
+	sample.start = start;
+	sample.duration = static_cast<uint32>(end - start);
+	sample.tick = dynamic_world ? dynamic_world->tick_count : 0;
+	sample.section = section;
+
+	profile_section_microseconds[section] += sample.duration;
+
+	if (++next_profile_sample == profile_samples.size())
+	{
+		next_profile_sample = 0;
+		profile_samples_wrapped = true;
+	}
+}
+
+// calls f on the buffered samples, oldest first
+template <typename F>
+static void for_each_profile_sample(F f)
+{
+	if (profile_samples_wrapped)
+	{
+		for (size_t i = next_profile_sample; i < profile_samples.size(); ++i)
+			f(profile_samples[i]);
+	}
+
+	for (size_t i = 0; i < next_profile_sample; ++i)
+		f(profile_samples[i]);
+}
+
+static bool write_profile_text(FileSpecifier& file, const std::string& text)
+{
+	OpenedFile opened_file;
+	if (!file.OpenForWritingText(opened_file)) return false;
+
+	return opened_file.Write(static_cast<int32>(text.size()), const_cast<char *>(text.data()));
+}
+
+bool write_tick_profile_csv(FileSpecifier& file)
+{
+	std::ostringstream s;
+	s << "tick,section,start_us,duration_us\n";
+
+	for_each_profile_sample([&s](const profile_sample& sample) {
+		s << sample.tick << "," << profile_section_names[sample.section] << "," << sample.start << "," << sample.duration << "\n";
+	});
+
+	return write_profile_text(file, s.str());
+}
+
+// Chrome's trace event format: world sections on one track, render phases on another
+bool write_tick_profile_trace(FileSpecifier& file)
+{
+	std::ostringstream s;
+	s << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	for_each_profile_sample([&s, &first](const profile_sample& sample) {
+		bool world = sample.section < NUMBER_OF_WORLD_PROFILE_SECTIONS;
+
+		if (!first) s << ",";
+		first = false;
+
+		s << "\n{\"name\":\"" << profile_section_names[sample.section]
+		  << "\",\"cat\":\"" << (world ? "world" : "render")
+		  << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (world ? 1 : 2)
+		  << ",\"ts\":" << sample.start << ",\"dur\":" << sample.duration
+		  << ",\"args\":{\"tick\":" << sample.tick << "}}";
+	});
+
+	s << "\n]}\n";
+
+	return write_profile_text(file, s.str());
+}
+
+std::vector<std::string> summarize_tick_profile(size_t maximum_lines)
+{
+	struct section_summary
+	{
+		short section;
+		uint64_t total;
+		uint32 maximum;
+		uint32 count;
+	} summaries[NUMBER_OF_PROFILE_SECTIONS];
+
+	for (short i = 0; i < NUMBER_OF_PROFILE_SECTIONS; ++i)
+	{
+		summaries[i] = { i, 0, 0, 0 };
+	}
+
+	for_each_profile_sample([&summaries](const profile_sample& sample) {
+		section_summary& summary = summaries[sample.section];
+		summary.total += sample.duration;
+		summary.maximum = std::max(summary.maximum, sample.duration);
+		summary.count++;
+	});
+
+	std::sort(summaries, summaries + NUMBER_OF_PROFILE_SECTIONS, [](const section_summary& a, const section_summary& b) {
+		return a.total > b.total;
+	});
+
+	std::vector<std::string> lines;
+	for (short i = 0; i < NUMBER_OF_PROFILE_SECTIONS && lines.size() < maximum_lines; ++i)
+	{
+		const section_summary& summary = summaries[i];
+		if (!summary.count) break;
+
+		std::ostringstream s;
+		s << profile_section_names[summary.section] << ": " << summary.total / summary.count << " us avg, " << summary.maximum << " us max";
+		lines.push_back(s.str());
+	}
+
+	return lines;
+}
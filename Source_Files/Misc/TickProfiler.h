@@ -0,0 +1,116 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+/*
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Times the subsystems called by each world tick and the phases of
+	render_view(); the most recent samples are kept in a ring buffer that
+	can be summarized from the console or written out as CSV or as a
+	Chrome trace (chrome://tracing, Perfetto)
+*/
+
+#include "cseries.h"
+
+#include <string>
+#include <vector>
+
+class FileSpecifier;
+
+enum /* profiled sections */
+{
+	// world update, in update_world_elements_one_tick() order
+	_profile_lua,
+	_profile_lights,
+	_profile_medias,
+	_profile_platforms,
+	_profile_control_panels,
+	_profile_players,
+	_profile_projectiles,
+	_profile_monsters,
+	_profile_effects,
+	_profile_objects,
+	_profile_ambient_sounds,
+	_profile_scenery,
+	_profile_ephemera,
+	_profile_items,
+	_profile_textures,
+	_profile_chase_cam,
+	_profile_motion_sensor,
+	_profile_exploration,
+	_profile_network,
+
+	// render_view()
+	_profile_render_visibility,
+	_profile_render_sort,
+	_profile_render_objects,
+	_profile_render_rasterize,
+	_profile_render_overhead_map,
+
+	NUMBER_OF_PROFILE_SECTIONS,
+	NUMBER_OF_WORLD_PROFILE_SECTIONS = _profile_render_visibility
+};
+
+enum
+{
+	MAXIMUM_PROFILE_SAMPLES = 16384 // a little over twenty seconds of ticks and frames
+};
+
+extern bool tick_profiler_enabled;
+
+void set_tick_profiler_enabled(bool enabled);
+void reset_tick_profiler(void);
+
+const char *get_profile_section_name(short section);
+
+// accumulated since the last reset, unlike the ring buffer which only holds recent samples
+uint64_t get_profile_section_microseconds(short section);
+
+void record_profile_sample(short section, uint64_t start, uint64_t end);
+
+bool write_tick_profile_csv(FileSpecifier& file);
+bool write_tick_profile_trace(FileSpecifier& file);
+
+// one line per section, busiest first, for the console
+std::vector<std::string> summarize_tick_profile(size_t maximum_lines);
+
+class ProfileScope
+{
+public:
+	ProfileScope(short section) : m_section(section), m_active(tick_profiler_enabled)
+	{
+		if (m_active) m_start = machine_microsecond_count();
+	}
+
+	~ProfileScope()
+	{
+		if (m_active) record_profile_sample(m_section, m_start, machine_microsecond_count());
+	}
+
+private:
+	short m_section;
+	bool m_active;
+	uint64_t m_start = 0;
+};
+
+#define PROFILE_CALL(section, statement) \
+	do { \
+		ProfileScope profile_scope(section); \
+		statement; \
+	} while (0)
+
+#endif
@@ -0,0 +1,117 @@
+/*
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	A fixed set of threads for fork-join work
+*/
+
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int thread_count) :
+	job_(nullptr), job_count_(0), next_job_(0), next_worker_(1),
+	busy_workers_(0), batch_(0), quit_(false)
+{
+	mutex_ = SDL_CreateMutex();
+	start_ = SDL_CreateCond();
+	done_ = SDL_CreateCond();
+
+	for (int i = 1; i < thread_count; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(Run, "WorkerPool_thread", this);
+		if (!thread) break; // run with what we have
+		threads_.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	SDL_LockMutex(mutex_);
+	quit_ = true;
+	SDL_CondBroadcast(start_);
+	SDL_UnlockMutex(mutex_);
+
+	for (SDL_Thread *thread : threads_)
+	{
+		SDL_WaitThread(thread, NULL);
+	}
+
+	SDL_DestroyCond(done_);
+	SDL_DestroyCond(start_);
+	SDL_DestroyMutex(mutex_);
+}
+
+void WorkerPool::run(int job_count, const std::function<void(int, int)>& job)
+{
+	if (threads_.empty() || job_count < 2)
+	{
+		for (int i = 0; i < job_count; ++i)
+			job(i, 0);
+		return;
+	}
+
+	SDL_LockMutex(mutex_);
+	job_ = &job;
+	job_count_ = job_count;
+	next_job_ = 0;
+	busy_workers_ = static_cast<int>(threads_.size());
+	++batch_;
+	SDL_CondBroadcast(start_);
+	SDL_UnlockMutex(mutex_);
+
+	work(0);
+
+	// every thread has to finish the batch before job goes out of scope
+	SDL_LockMutex(mutex_);
+	while (busy_workers_)
+		SDL_CondWait(done_, mutex_);
+	job_ = nullptr;
+	SDL_UnlockMutex(mutex_);
+}
+
+void WorkerPool::work(int worker)
+{
+	for (int i = next_job_++; i < job_count_; i = next_job_++)
+	{
+		(*job_)(i, worker);
+	}
+}
+
+int WorkerPool::Run(void *p)
+{
+	WorkerPool *pool = static_cast<WorkerPool *>(p);
+	int worker = pool->next_worker_++;
+	uint32 batch = 0;
+
+	SDL_LockMutex(pool->mutex_);
+	for (;;)
+	{
+		while (!pool->quit_ && pool->batch_ == batch)
+			SDL_CondWait(pool->start_, pool->mutex_);
+		if (pool->quit_) break;
+
+		batch = pool->batch_;
+		SDL_UnlockMutex(pool->mutex_);
+
+		pool->work(worker);
+
+		SDL_LockMutex(pool->mutex_);
+		if (--pool->busy_workers_ == 0)
+			SDL_CondSignal(pool->done_);
+	}
+	SDL_UnlockMutex(pool->mutex_);
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/*
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	A fixed set of threads for fork-join work: run() hands out a batch of
+	numbered jobs and returns once every one of them has finished
+*/
+
+#include "cseries.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
+class WorkerPool
+{
+public:
+	// the thread calling run() takes jobs too, so this starts thread_count-1 threads
+	WorkerPool(int thread_count);
+	~WorkerPool();
+
+	int thread_count() const { return static_cast<int>(threads_.size()) + 1; }
+
+	// calls job(index, worker) for every index in [0, job_count); worker is in
+	// [0, thread_count()) and identifies the thread, for per-thread scratch space
+	void run(int job_count, const std::function<void(int, int)>& job);
+
+private:
+	static int Run(void *);
+	void work(int worker);
+
+	std::vector<SDL_Thread *> threads_;
+	SDL_mutex *mutex_;
+	SDL_cond *start_;
+	SDL_cond *done_;
+
+	const std::function<void(int, int)> *job_;
+	int job_count_;
+	std::atomic_int next_job_;
+	std::atomic_int next_worker_;
+
+	int busy_workers_;
+	uint32 batch_;
+	bool quit_;
+};
+
+#endif
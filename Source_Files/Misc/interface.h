@@ -374,6 +374,7 @@ void stop_recording(void);
 void stop_replay(void);
 void move_replay(void);
 void check_recording_replaying(void);
+bool pull_replay_flags_for_one_tick(void);
 bool has_recording_file(void);
 void increment_replay_speed(void);
 void decrement_replay_speed(void);
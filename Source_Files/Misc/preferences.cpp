@@ -976,6 +976,18 @@ static const char *sw_sdl_driver_labels[5] = {
 };
 
 
+static const char *sw_rendering_threads_labels[] = {
+	"1", "2", "4", "8", "16", NULL
+};
+
+static int16 sw_rendering_threads_to_index(int16 threads)
+{
+	int16 index = 0;
+	while (sw_rendering_threads_labels[index + 1] && (2 << index) <= threads)
+		++index;
+	return index;
+}
+
 static const char* ephemera_quality_labels[] = {
 	"Off", "Low", "Medium", "High", "Ultra", NULL
 };
@@ -1088,6 +1100,10 @@ static void software_rendering_options_dialog(void* arg)
 	table->dual_add(sw_driver_w->label("Acceleration"), d);
 	table->dual_add(sw_driver_w, d);
 
+	w_select *sw_threads_w = new w_select(sw_rendering_threads_to_index(graphics_preferences->software_rendering_threads), sw_rendering_threads_labels);
+	table->dual_add(sw_threads_w->label("Rendering Threads"), d);
+	table->dual_add(sw_threads_w, d);
+
 	placer->add(table, true);
 
 	placer->add(new w_spacer(), true);
@@ -1133,6 +1149,12 @@ static void software_rendering_options_dialog(void* arg)
 			changed = true;
 		}
 
+		if (sw_threads_w->get_selection() != sw_rendering_threads_to_index(graphics_preferences->software_rendering_threads))
+		{
+			graphics_preferences->software_rendering_threads = 1 << sw_threads_w->get_selection();
+			changed = true;
+		}
+
 		if (ephemera_quality_w->get_selection() != graphics_preferences->ephemera_quality)
 		{
 			graphics_preferences->ephemera_quality = ephemera_quality_w->get_selection();
@@ -3522,6 +3544,7 @@ InfoTree graphics_preferences_tree()
 	root.put_attr("ogl_flags", graphics_preferences->OGL_Configure.Flags);
 	root.put_attr("software_alpha_blending", graphics_preferences->software_alpha_blending);
 	root.put_attr("software_sdl_driver", graphics_preferences->software_sdl_driver);
+	root.put_attr("software_rendering_threads", graphics_preferences->software_rendering_threads);
 	root.put_attr("fps_target", graphics_preferences->fps_target);
 	root.put_attr("anisotropy_level", graphics_preferences->OGL_Configure.AnisotropyLevel);
 	root.put_attr("multisamples", graphics_preferences->OGL_Configure.Multisamples);
@@ -4004,6 +4027,7 @@ static void default_graphics_preferences(graphics_preferences_data *preferences)
 
 	preferences->software_alpha_blending = _sw_alpha_off;
 	preferences->software_sdl_driver = _sw_driver_default;
+	preferences->software_rendering_threads = 1;
 	preferences->fps_target = 30;
 
 	preferences->movie_export_video_quality = 50;
@@ -4481,6 +4505,7 @@ void parse_graphics_preferences(InfoTree root, std::string version)
 	root.read_attr("ogl_flags", graphics_preferences->OGL_Configure.Flags);
 	root.read_attr("software_alpha_blending", graphics_preferences->software_alpha_blending);
 	root.read_attr("software_sdl_driver", graphics_preferences->software_sdl_driver);
+	root.read_attr_bounded<int16>("software_rendering_threads", graphics_preferences->software_rendering_threads, 1, 64);
 	root.read_attr("fps_target", graphics_preferences->fps_target);
 	root.read_attr("anisotropy_level", graphics_preferences->OGL_Configure.AnisotropyLevel);
 	root.read_attr("multisamples", graphics_preferences->OGL_Configure.Multisamples);
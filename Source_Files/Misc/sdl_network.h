@@ -120,6 +120,26 @@ void NetDDPDisposeFrame(DDPFramePtr frame);
 
 OSErr NetDDPSendFrame(DDPFramePtr frame, NetAddrBlock *address, short protocolType, short socket);
 
+// The listening thread passes packets to the handler only when it can take the mytm mutex
+// without waiting; TMTasks call this (holding the mutex) to handle any it had to leave behind.
+void NetDDPDispatchReceivedPackets(void);
+
+// Counters for the current (or last) socket
+struct NetDDPStatistics
+{
+	uint32 mPacketsReceived;
+	uint32 mBatchesReceived;		// wakeups of the listening thread that received something
+	uint32 mLargestBatch;
+	uint32 mFullRingWaits;			// times the listening thread had to wait for the mutex to make room
+	uint32 mPacketsDispatchedByTasks;	// rather than by the listening thread
+	uint64_t mQueuedMicroseconds;		// from receipt until the handler was called, summed over packets
+	uint32 mMaximumQueuedMicroseconds;
+	uint64_t mHandlerMicroseconds;		// in the handler, summed over packets
+	uint32 mMaximumHandlerMicroseconds;
+};
+
+void NetDDPGetStatistics(NetDDPStatistics *outStatistics);
+
 /* ---------- prototypes/NETWORK_ADSP.C */
 
 // jkvw: removed - we use TCPMess now
@@ -74,6 +74,10 @@ Aug 26, 2000 (Loren Petrich):
 
 Feb 20, 2002 (Woody Zenfell):
     Uses GetRealActionQueues()->enqueueActionFlags() rather than queue_action_flags().
+
+Oct 16, 2026:
+	Films end with the game state hashes of the recorded game, past header.length where
+	older versions stop reading; replays check against them.
 */
 
 #include "cseries.h"
@@ -98,6 +102,7 @@ Feb 20, 2002 (Woody Zenfell):
 #include "joystick.h"
 #include "Movie.h"
 #include "InfoTree.h"
+#include "game_state_hash.h"
 
 /* ---------- constants */
 
@@ -266,6 +271,17 @@ bool game_is_being_replayed()
 	return replay.game_is_being_replayed;
 }
 
+/* for headless playback: moves one tick of flags from the film into the real action queues
+	without going through the input controller; returns false when the film is exhausted */
+bool pull_replay_flags_for_one_tick(
+	void)
+{
+	if (!replay.game_is_being_replayed) return false;
+
+	check_recording_replaying();
+	return pull_flags_from_recording(1) != 0;
+}
+
 void increment_heartbeat_count(int value)
 {
 	heartbeat_count+=value;
@@ -558,6 +574,7 @@ bool setup_for_replay_from_file(
 		byte Header[SIZEOF_recording_header];
 		FilmFile.Read(SIZEOF_recording_header,Header);
 		unpack_recording_header(Header,&replay.header,1);
+		start_replay_game_state_hashes(FilmFile, replay.header.length);
 		replay.header.game_information.cheat_flags = _allow_crosshair | _allow_tunnel_vision | _allow_behindview | _allow_overlay_map;
 	
 		/* Set to the mapfile this replay came from.. */
@@ -592,6 +609,7 @@ void start_recording(
 {
 	assert(!replay.valid);
 	replay.valid= true;
+	reset_recorded_game_state_hashes();
 	
 	if(get_recording_filedesc(FilmFileSpec))
 		FilmFileSpec.Delete();
@@ -602,6 +620,7 @@ void start_recording(
 		if (FilmFileSpec.Open(FilmFile,true))
 		{
 			replay.game_is_being_recorded= true;
+			start_recording_game_state_hashes();
 	
 			// save a header containing information about the game.
 			byte Header[SIZEOF_recording_header];
@@ -640,6 +659,10 @@ void stop_recording(
 		
 		FilmFile.GetLength(total_length);
 		assert(total_length==replay.header.length);
+
+		FilmFile.SetPosition(total_length);
+		write_recorded_game_state_hashes(FilmFile);
+		stop_recording_game_state_hashes();
 		
 		FilmFile.Close();
 	}
@@ -670,6 +693,7 @@ void rewind_recording(
 		
 		// Use the packed length here!!!
 		replay.header.length= SIZEOF_recording_header;
+		reset_recorded_game_state_hashes();
 	}
 }
 
@@ -30,7 +30,8 @@
 
 enum {
         kOriginalNetworkAudioDistributionTypeID = 0,    // for compatibility with older versions
-        kNewNetworkAudioDistributionTypeID = 1          // new-style realtime network audio data
+        kNewNetworkAudioDistributionTypeID = 1,         // new-style realtime network audio data
+        kGameStateHashDistributionTypeID = 2            // game_state_hash, for spotting out-of-sync games
 };
 
 #endif // NETWORK_DISTRIBUTION_TYPES_H
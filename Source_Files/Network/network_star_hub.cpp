@@ -40,6 +40,10 @@
  *	NAT-friendly networking - we no longer get spoke addresses form topology -
  *	instead spokes send identification packets to hub with player ID.
  *	Hub can then associate the ID in the identification packet with the paket's source address.
+ *
+ *  Oct 16, 2026:
+ *	send_packets() encodes each tick's action flags once per call and copies them into every
+ *	recipient's packet, instead of fetching and encoding them again for each recipient.
  */
 
 #if !defined(DISABLE_NETWORKING)
@@ -1304,6 +1308,10 @@ hub_tick()
 
 	logContextNMT("performing hub_tick %d", sNetworkTicker);
 
+        // Hear from players whose packets arrived while we (or another task) held the mutex
+        // before deciding whether they're netdead.
+        NetDDPDispatchReceivedPackets();
+
         // Check for newly netdead players
         bool shouldSend = false;
         for(size_t i = 0; i < sNetworkPlayers.size(); i++)
@@ -1442,6 +1450,40 @@ hub_tick()
 #define INT8_MIN -128
 #endif
 
+// A player's flags for a tick are the same in every outgoing packet; the only difference is
+// that a spoke doesn't get its own flags back unless they were reflected.  So send_packets()
+// encodes each tick once, as a row of big-endian flags for every player still contributing, and
+// copies rows (less the recipient's column) into each packet.  Rows go backwards from
+// sSmallestIncompleteTick - 1 and are only encoded as far back as some recipient needs.
+static std::vector<int32>	sSmallestTickToSend;	// per player; doesn't depend on the recipient
+static std::vector<uint8>	sEncodedFlags;
+static std::vector<int32>	sEncodedFlagsColumns;	// per row, where each player's flags start, then where the row ends
+
+static void
+encode_flags_rows_down_to(int32 inTick)
+{
+	size_t thePlayerCount = sNetworkPlayers.size();
+	int32 theRowCount = static_cast<int32>(sEncodedFlagsColumns.size() / (thePlayerCount + 1));
+
+	for(int32 tick = sSmallestIncompleteTick - 1 - theRowCount; tick >= inTick; tick--)
+	{
+		for(size_t j = 0; j < thePlayerCount; j++)
+		{
+			sEncodedFlagsColumns.push_back(static_cast<int32>(sEncodedFlags.size()));
+			if(tick < sSmallestTickToSend[j])
+			{
+				// as AOStreamBE would write it
+				action_flags_t theFlags = getFlagsQueue(j).peek(tick);
+				sEncodedFlags.push_back(static_cast<uint8>(theFlags >> 24));
+				sEncodedFlags.push_back(static_cast<uint8>(theFlags >> 16));
+				sEncodedFlags.push_back(static_cast<uint8>(theFlags >> 8));
+				sEncodedFlags.push_back(static_cast<uint8>(theFlags));
+			}
+		}
+		sEncodedFlagsColumns.push_back(static_cast<int32>(sEncodedFlags.size()));
+	}
+}
+
 static void
 send_packets()
 {
@@ -1465,6 +1507,21 @@ send_packets()
 	{
 		sFlagSendTimeQueue.enqueue(sNetworkTicker);
 	}
+
+	// Figure out at what tick each player stops contributing flags; rows are encoded from these
+	// as recipients need them
+	sSmallestTickToSend.resize(sNetworkPlayers.size());
+	for(size_t j = 0; j < sNetworkPlayers.size(); j++)
+	{
+		NetworkPlayer_hub& theOtherPlayer = sNetworkPlayers[j];
+		sSmallestTickToSend[j] = sSmallestIncompleteTick;
+
+		// Don't send flags for netdead people
+		if(!theOtherPlayer.mConnected && sSmallestTickToSend[j] > theOtherPlayer.mNetDeadTick)
+			sSmallestTickToSend[j] = theOtherPlayer.mNetDeadTick;
+	}
+	sEncodedFlags.clear();
+	sEncodedFlagsColumns.clear();
 		
         for(size_t i = 0; i < sNetworkPlayers.size(); i++)
         {
@@ -1578,42 +1635,30 @@ send_packets()
 				}
         
                                 // Action_flags!!
-                                // First, preprocess the players to figure out at what tick they'll each stop
-                                // contributing
-				std::vector<int32> theSmallestTickWeWontSend;
-                                theSmallestTickWeWontSend.resize(sNetworkPlayers.size());
-                                for(size_t j = 0; j < sNetworkPlayers.size(); j++)
-                                {
-                                        // Don't encode our own flags
-                                        if(j == i && !reflectFlags)
-                                        {
-                                                theSmallestTickWeWontSend[j] = thePlayer.mSmallestUnacknowledgedTick - 1;
-                                                continue;
-                                        }
-        
-                                        theSmallestTickWeWontSend[j] = sSmallestIncompleteTick;
-                                        NetworkPlayer_hub& theOtherPlayer = sNetworkPlayers[j];
-        
-                                        // Don't send flags for netdead people
-                                        if(!theOtherPlayer.mConnected && theSmallestTickWeWontSend[j] > theOtherPlayer.mNetDeadTick)
-                                                theSmallestTickWeWontSend[j] = theOtherPlayer.mNetDeadTick;
-                                }
-        
-                                // Now, encode the flags in tick-major order (this is much easier to decode
-                                // at the other end)
+                                // Encoded in tick-major order (this is much easier to decode at the other end),
+                                // leaving out the recipient's own flags unless they're being reflected
+                                if(startTick < endTick)
+                                        encode_flags_rows_down_to(startTick);
+
                                 for(int32 tick = startTick; tick < endTick; tick++)
                                 {
-                                        for(size_t j = 0; j < sNetworkPlayers.size(); j++)
+                                        const int32* theColumns = &sEncodedFlagsColumns[(sSmallestIncompleteTick - 1 - tick) * (sNetworkPlayers.size() + 1)];
+                                        int32 theRowStart = theColumns[0];
+                                        int32 theRowEnd = theColumns[sNetworkPlayers.size()];
+                                        int32 theOwnStart = reflectFlags ? theRowEnd : theColumns[i];
+                                        int32 theOwnEnd = reflectFlags ? theRowEnd : theColumns[i + 1];
+
+                                        if(theRowEnd - theRowStart > theOwnEnd - theOwnStart)
                                         {
-                                                if(tick < theSmallestTickWeWontSend[j])
+                                                if(!haveSentStartTick)
                                                 {
-                                                        if(!haveSentStartTick)
-                                                        {
-                                                                ps << tick;
-                                                                haveSentStartTick = true;
-                                                        }
-                                                        ps << getFlagsQueue(j).peek(tick);
+                                                        ps << tick;
+                                                        haveSentStartTick = true;
                                                 }
+                                                if(theOwnStart > theRowStart)
+                                                        ps.write(sEncodedFlags.data() + theRowStart, theOwnStart - theRowStart);
+                                                if(theRowEnd > theOwnEnd)
+                                                        ps.write(sEncodedFlags.data() + theOwnEnd, theRowEnd - theOwnEnd);
                                         }
                                 }
 				
@@ -904,6 +904,9 @@ static bool
 spoke_tick()
 {
 	logContextNMT("processing spoke_tick %d", sNetworkTicker);
+
+        // Handle anything the listening thread couldn't while we (or another task) held the mutex.
+        NetDDPDispatchReceivedPackets();
 	
         sNetworkTicker++;
 
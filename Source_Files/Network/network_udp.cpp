@@ -27,6 +27,10 @@
  *  Sept-Nov 2001 (Woody Zenfell): a few additions to implement socket-listening thread.
  *
  *  May 18, 2003 (Woody Zenfell): now uses passed-in port number for local socket.
+ *
+ *  Oct 16, 2026: the listening thread drains every pending datagram into a ring of packet
+ *  buffers and only hands them to the packet handler when the mytm mutex is free; TMTasks
+ *  dispatch whatever it couldn't.  Keeps counters (NetDDPGetStatistics()).
  */
 
 #if !defined(DISABLE_NETWORKING)
@@ -39,13 +43,45 @@
 
 #include "thread_priority_sdl.h"
 #include "mytm.h" // mytm_mutex stuff
+#include "Logging.h"
+
+#include <atomic>
 
 // Global variables (most comments and "sSomething" variables are ZZZ)
-// Storage for incoming packet data
+// Storage for outgoing packet data
 static UDPpacket*		sUDPPacketBuffer	= NULL;
 
-// Storage for the DDP packet we pass back to the handler proc
-static DDPPacketBuffer		ddpPacketBuffer;
+// Received packets wait in this ring until someone holding the mytm mutex passes them to the
+// handler proc.  The listening thread is the only one adding packets; the ones taking them out
+// are serialized by the mytm mutex.  Slots are reused only once the handler has returned.
+enum { kPacketRingSize = 64 }; // must be a power of two
+
+struct ReceivedPacket
+{
+	DDPPacketBuffer	mPacket;
+	uint64_t		mReceivedAt; // SDL_GetPerformanceCounter()
+};
+
+static ReceivedPacket		sPacketRing[kPacketRingSize];
+
+// SDL_net receives straight into the ring's DDP packets through these
+static UDPpacket		sRingUDPPackets[kPacketRingSize];
+static UDPpacket*		sReceiveVector[kPacketRingSize + 1];
+
+// Free-running; the ring holds the packets from sRingTail up to (not including) sRingHead
+static std::atomic<uint32>	sRingHead(0);
+static std::atomic<uint32>	sRingTail(0);
+
+// Updated from the listening thread and TMTasks, so read them through NetDDPGetStatistics()
+static std::atomic<uint32>	sPacketsReceived(0);
+static std::atomic<uint32>	sBatchesReceived(0);
+static std::atomic<uint32>	sLargestBatch(0);
+static std::atomic<uint32>	sFullRingWaits(0);
+static std::atomic<uint32>	sPacketsDispatchedByTasks(0);
+static std::atomic<uint64_t>	sQueuedMicroseconds(0);
+static std::atomic<uint32>	sMaximumQueuedMicroseconds(0);
+static std::atomic<uint64_t>	sHandlerMicroseconds(0);
+static std::atomic<uint32>	sMaximumHandlerMicroseconds(0);
 
 // Keep track of our one sending/receiving socket
 static UDPsocket 		sSocket			= NULL;
@@ -63,35 +99,115 @@ static SDL_Thread*		sReceivingThread	= NULL;
 static volatile bool		sKeepListening		= false;
 
 
+static uint32
+microseconds_since(uint64_t inCounter, uint64_t inNow) {
+    return static_cast<uint32>((inNow - inCounter) * 1000000 / SDL_GetPerformanceFrequency());
+}
+
+static void
+note_maximum(std::atomic<uint32>& ioMaximum, uint32 inValue) {
+    if(inValue > ioMaximum.load(std::memory_order_relaxed))
+        ioMaximum.store(inValue, std::memory_order_relaxed);
+}
+
+static bool
+packets_are_waiting() {
+    return sRingHead.load(std::memory_order_acquire) != sRingTail.load(std::memory_order_acquire);
+}
+
+// Only the listening thread calls this.  Receives as many pending datagrams as the ring has room
+// for; returns false if the ring was already full.
+static bool
+receive_pending_packets() {
+    uint32 theHead = sRingHead.load(std::memory_order_relaxed);
+    uint32 theSpace = kPacketRingSize - (theHead - sRingTail.load(std::memory_order_acquire));
+    
+    if(theSpace == 0)
+        return false;
+    
+    for(uint32 i = 0; i < theSpace; i++)
+        sReceiveVector[i] = &sRingUDPPackets[(theHead + i) & (kPacketRingSize - 1)];
+    sReceiveVector[theSpace] = NULL;
+    
+    int theCount = SDLNet_UDP_RecvV(sSocket, sReceiveVector);
+    if(theCount <= 0)
+        return true;
+    
+    uint64_t theNow = SDL_GetPerformanceCounter();
+    for(int i = 0; i < theCount; i++) {
+        ReceivedPacket& thePacket = sPacketRing[(theHead + i) & (kPacketRingSize - 1)];
+        thePacket.mPacket.protocolType	= kPROTOCOL_TYPE;
+        thePacket.mPacket.sourceAddress	= sReceiveVector[i]->address;
+        thePacket.mPacket.datagramSize	= sReceiveVector[i]->len;
+        thePacket.mReceivedAt		= theNow;
+    }
+    
+    sRingHead.store(theHead + theCount, std::memory_order_release);
+    
+    sPacketsReceived.fetch_add(theCount, std::memory_order_relaxed);
+    sBatchesReceived.fetch_add(1, std::memory_order_relaxed);
+    note_maximum(sLargestBatch, theCount);
+    
+    return true;
+}
+
+// Caller holds the mytm mutex.  Passes every waiting packet to the handler proc, oldest first;
+// returns how many there were.
+static uint32
+dispatch_received_packets() {
+    uint32 theFirst = sRingTail.load(std::memory_order_relaxed);
+    uint32 theHead = sRingHead.load(std::memory_order_acquire);
+    
+    for(uint32 theTail = theFirst; theTail != theHead; theTail++) {
+        ReceivedPacket& thePacket = sPacketRing[theTail & (kPacketRingSize - 1)];
+        
+        uint64_t theStart = SDL_GetPerformanceCounter();
+        sPacketHandler(&thePacket.mPacket);
+        uint64_t theEnd = SDL_GetPerformanceCounter();
+        
+        uint32 theQueued = microseconds_since(thePacket.mReceivedAt, theStart);
+        uint32 theHandling = microseconds_since(theStart, theEnd);
+        sQueuedMicroseconds.fetch_add(theQueued, std::memory_order_relaxed);
+        note_maximum(sMaximumQueuedMicroseconds, theQueued);
+        sHandlerMicroseconds.fetch_add(theHandling, std::memory_order_relaxed);
+        note_maximum(sMaximumHandlerMicroseconds, theHandling);
+        
+        // the handler is done with the slot, so the listening thread may fill it again
+        sRingTail.store(theTail + 1, std::memory_order_release);
+    }
+    
+    return theHead - theFirst;
+}
+
 // ZZZ: the socket listening thread loops in this function.  It calls the registered
 // packet handler when it gets something.
 static int
 receive_thread_function(void*) {
     while(true) {
-        // We listen with a timeout so we can shut ourselves down when needed.
-        int theResult = SDLNet_CheckSockets(sSocketSet, 1000);
+        // We listen with a timeout so we can shut ourselves down when needed.  While packets
+        // are waiting on the mytm mutex, we come back around quickly to try again.
+        int theResult = SDLNet_CheckSockets(sSocketSet, packets_are_waiting() ? 1 : 1000);
         
         if(!sKeepListening)
             break;
         
-        if(theResult > 0) {
-            theResult = SDLNet_UDP_Recv(sSocket, sUDPPacketBuffer);
-            if(theResult > 0) {
+        bool theRingIsFull = false;
+        if(theResult > 0)
+            theRingIsFull = !receive_pending_packets();
+        
+        if(packets_are_waiting()) {
+            // A running TMTask holds the mutex; it (or we, next time around) will dispatch these.
+            // If the ring is full, though, nothing more can be received until we wait our turn.
+            if(try_take_mytm_mutex()) {
+                dispatch_received_packets();
+                release_mytm_mutex();
+            }
+            else if(theRingIsFull) {
+                sFullRingWaits.fetch_add(1, std::memory_order_relaxed);
                 if(take_mytm_mutex()) {
-                    ddpPacketBuffer.protocolType	= kPROTOCOL_TYPE;
-                    ddpPacketBuffer.sourceAddress	= sUDPPacketBuffer->address;
-                    ddpPacketBuffer.datagramSize	= sUDPPacketBuffer->len;
-                    
-                    // Hope the other guy is done using whatever's in there!
-                    // (As I recall, all uses happen in sPacketHandler and its progeny, so we should be fine.)
-                    memcpy(ddpPacketBuffer.datagramData, sUDPPacketBuffer->data, sUDPPacketBuffer->len);
-                    
-                    sPacketHandler(&ddpPacketBuffer);
-                    
+                    dispatch_received_packets();
                     release_mytm_mutex();
                 }
-                else
-                    fdprintf("could not take mytm mutex - incoming packet dropped");
             }
         }
     }
@@ -135,6 +251,26 @@ OSErr NetDDPOpenSocket(short *ioPortNumber, PacketHandlerProcPtr packetHandler)
 	if (sUDPPacketBuffer == NULL)
 		return -1;
 
+	// Received packets land directly in the ring
+	for (int i = 0; i < kPacketRingSize; i++) {
+		obj_clear(sRingUDPPackets[i]);
+		sRingUDPPackets[i].channel = -1;
+		sRingUDPPackets[i].data = sPacketRing[i].mPacket.datagramData;
+		sRingUDPPackets[i].maxlen = ddpMaxData;
+	}
+	sRingHead = 0;
+	sRingTail = 0;
+
+	sPacketsReceived = 0;
+	sBatchesReceived = 0;
+	sLargestBatch = 0;
+	sFullRingWaits = 0;
+	sPacketsDispatchedByTasks = 0;
+	sQueuedMicroseconds = 0;
+	sMaximumQueuedMicroseconds = 0;
+	sHandlerMicroseconds = 0;
+	sMaximumHandlerMicroseconds = 0;
+
         //PORTGUESS
 	// Open socket (SDLNet_Open seems to like port in host byte order)
         // NOTE: only SDLNet_UDP_Open wants port in host byte order.  All other uses of port in SDL_net
@@ -180,6 +316,23 @@ OSErr NetDDPCloseSocket(short portNumber)
             sKeepListening	= false;
             SDL_WaitThread(sReceivingThread, NULL);
             sReceivingThread	= NULL;
+
+            // Whatever's still waiting is dropped, like anything the socket hadn't read yet.
+            // (SDL mutexes are recursive, so this is fine if our caller holds it too.)
+            {
+                MyTMMutexTaker theMutexTaker;
+                sRingTail = sRingHead.load();
+            }
+
+            NetDDPStatistics theStatistics;
+            NetDDPGetStatistics(&theStatistics);
+            logNote("UDP receive: %u packets in %u batches (largest %u), %u dispatched by tasks, %u full-ring waits; queued %u us average (%u max), handled in %u us average (%u max)",
+                    theStatistics.mPacketsReceived, theStatistics.mBatchesReceived, theStatistics.mLargestBatch,
+                    theStatistics.mPacketsDispatchedByTasks, theStatistics.mFullRingWaits,
+                    theStatistics.mPacketsReceived ? static_cast<uint32>(theStatistics.mQueuedMicroseconds / theStatistics.mPacketsReceived) : 0,
+                    theStatistics.mMaximumQueuedMicroseconds,
+                    theStatistics.mPacketsReceived ? static_cast<uint32>(theStatistics.mHandlerMicroseconds / theStatistics.mPacketsReceived) : 0,
+                    theStatistics.mMaximumHandlerMicroseconds);
         }
 
         if(sSocketSet) {
@@ -199,6 +352,31 @@ OSErr NetDDPCloseSocket(short portNumber)
 }
 
 
+/*
+ *  Dispatch received packets
+ */
+
+// Caller holds the mytm mutex (TMTasks always do).
+void NetDDPDispatchReceivedPackets(void)
+{
+	if (packets_are_waiting())
+		sPacketsDispatchedByTasks.fetch_add(dispatch_received_packets(), std::memory_order_relaxed);
+}
+
+void NetDDPGetStatistics(NetDDPStatistics *outStatistics)
+{
+	outStatistics->mPacketsReceived = sPacketsReceived.load(std::memory_order_relaxed);
+	outStatistics->mBatchesReceived = sBatchesReceived.load(std::memory_order_relaxed);
+	outStatistics->mLargestBatch = sLargestBatch.load(std::memory_order_relaxed);
+	outStatistics->mFullRingWaits = sFullRingWaits.load(std::memory_order_relaxed);
+	outStatistics->mPacketsDispatchedByTasks = sPacketsDispatchedByTasks.load(std::memory_order_relaxed);
+	outStatistics->mQueuedMicroseconds = sQueuedMicroseconds.load(std::memory_order_relaxed);
+	outStatistics->mMaximumQueuedMicroseconds = sMaximumQueuedMicroseconds.load(std::memory_order_relaxed);
+	outStatistics->mHandlerMicroseconds = sHandlerMicroseconds.load(std::memory_order_relaxed);
+	outStatistics->mMaximumHandlerMicroseconds = sMaximumHandlerMicroseconds.load(std::memory_order_relaxed);
+}
+
+
 /*
  *  Allocate frame
  */
@@ -85,12 +85,19 @@ public:
 
 	bool Minify();
 
+	// box-filters a full mipmap chain below an RGBA8 image
+	bool MakeMipMaps();
+
 	bool MakeRGBA();
 	bool MakeDXTC3();
 
 	void PremultiplyAlpha();
 	bool PremultipliedAlpha; // public so find silhouette version can unset
 
+	// Header and pixels exactly as they are in memory, for the replacement-texture cache
+	bool ReadRaw(OpenedFile& File);
+	bool WriteRaw(OpenedFile& File) const;
+
 	// Clearing
 	void Clear()
 		{Width = Height = Size = 0; delete []Pixels; Pixels = NULL;}
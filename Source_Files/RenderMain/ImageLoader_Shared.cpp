@@ -157,7 +157,7 @@ bool ImageDescriptor::Minify()
 			Pixels = newPixels;
 			Width = newWidth;
 			Height = newHeight;
-			Size = newWidth * newHeight;
+			Size = newWidth * newHeight * 4;
 			return true;
 			
 		} 
@@ -175,6 +175,142 @@ bool ImageDescriptor::Minify()
 }
 	
 
+bool ImageDescriptor::MakeMipMaps()
+{
+	if (Format != RGBA8 || MipMapCount > 1 || !IsPresent()) return false;
+
+	int Count = 1;
+	int TotalBytes = GetMipMapSize(0);
+	while ((Width >> Count) > 0 || (Height >> Count) > 0)
+	{
+		TotalBytes += GetMipMapSize(Count);
+		Count++;
+	}
+
+	uint32 *NewPixels = new uint32[TotalBytes / 4];
+	memcpy(NewPixels, Pixels, GetMipMapSize(0));
+	delete []Pixels;
+	Pixels = NewPixels;
+	Size = TotalBytes;
+	MipMapCount = Count;
+
+	// each level averages 2x2 blocks of the one above it, clamping odd edges
+	for (int Level = 1; Level < MipMapCount; Level++)
+	{
+		int SrcWidth = max(1, Width >> (Level - 1));
+		int SrcHeight = max(1, Height >> (Level - 1));
+		int DstWidth = max(1, Width >> Level);
+		int DstHeight = max(1, Height >> Level);
+		const uint8 *Src = (const uint8 *) GetMipMapPtr(Level - 1);
+		uint8 *Dst = (uint8 *) GetMipMapPtr(Level);
+
+		for (int y = 0; y < DstHeight; y++)
+		{
+			const uint8 *Row0 = Src + 4 * SrcWidth * min(2 * y, SrcHeight - 1);
+			const uint8 *Row1 = Src + 4 * SrcWidth * min(2 * y + 1, SrcHeight - 1);
+			for (int x = 0; x < DstWidth; x++)
+			{
+				int x0 = 4 * min(2 * x, SrcWidth - 1);
+				int x1 = 4 * min(2 * x + 1, SrcWidth - 1);
+				for (int c = 0; c < 4; c++)
+				{
+					*Dst++ = (Row0[x0 + c] + Row0[x1 + c] + Row1[x0 + c] + Row1[x1 + c] + 2) / 4;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// the pixels go out in memory order; cache files never move between machines
+static const int SIZEOF_ImageDescriptorRaw = 2 + 2 + 4 * 4 + 2 * 8;
+
+static uint64_t DoubleBits(double Value)
+{
+	uint64_t Bits;
+	memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+static double BitsDouble(uint64_t Bits)
+{
+	double Value;
+	memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+bool ImageDescriptor::ReadRaw(OpenedFile& File)
+{
+	Clear();
+
+	uint8 Header[SIZEOF_ImageDescriptorRaw];
+	if (!File.Read(SIZEOF_ImageDescriptorRaw, Header)) return false;
+
+	int16 RawFormat, Premultiplied;
+	int32 RawWidth, RawHeight, RawSize, RawMipMapCount;
+	uint32 VHigh, VLow, UHigh, ULow;
+
+	AIStreamBE Stream(Header, SIZEOF_ImageDescriptorRaw);
+	Stream >> RawFormat >> Premultiplied
+		   >> RawWidth >> RawHeight >> RawSize >> RawMipMapCount
+		   >> VHigh >> VLow >> UHigh >> ULow;
+
+	if (RawFormat < RGBA8 || RawFormat >= Unknown || RawWidth <= 0 || RawHeight <= 0 || RawSize <= 0 || (RawSize & 3) ||
+		RawWidth > 16384 || RawHeight > 16384 || RawMipMapCount < 0)
+		return false;
+
+	// the mipmaps the texture code will read must all be there, and there
+	// mustn't be more than a full chain of them
+	Format = static_cast<ImageFormat>(RawFormat);
+	Width = RawWidth;
+	Height = RawHeight;
+	int UsedBytes = 0, ChainBytes = 0;
+	int Levels = 0;
+	for (; RawWidth >> Levels || RawHeight >> Levels; ++Levels)
+	{
+		if (Levels < std::max(1, static_cast<int>(RawMipMapCount)))
+			UsedBytes += GetMipMapSize(Levels);
+		ChainBytes += GetMipMapSize(Levels);
+	}
+	Width = Height = 0;
+
+	if (RawMipMapCount > Levels || UsedBytes > RawSize || RawSize > ChainBytes)
+		return false;
+
+	Resize(RawWidth, RawHeight, RawSize);
+	MipMapCount = RawMipMapCount;
+	PremultipliedAlpha = (Premultiplied != 0);
+	VScale = BitsDouble((static_cast<uint64_t>(VHigh) << 32) | VLow);
+	UScale = BitsDouble((static_cast<uint64_t>(UHigh) << 32) | ULow);
+
+	if (!File.Read(Size, Pixels))
+	{
+		Clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool ImageDescriptor::WriteRaw(OpenedFile& File) const
+{
+	if (!IsPresent()) return false;
+
+	uint8 Header[SIZEOF_ImageDescriptorRaw];
+	uint64_t V = DoubleBits(VScale);
+	uint64_t U = DoubleBits(UScale);
+
+	AOStreamBE Stream(Header, SIZEOF_ImageDescriptorRaw);
+	Stream << static_cast<int16>(Format) << static_cast<int16>(PremultipliedAlpha)
+		   << static_cast<int32>(Width) << static_cast<int32>(Height)
+		   << static_cast<int32>(Size) << static_cast<int32>(MipMapCount)
+		   << static_cast<uint32>(V >> 32) << static_cast<uint32>(V)
+		   << static_cast<uint32>(U >> 32) << static_cast<uint32>(U);
+
+	return File.Write(SIZEOF_ImageDescriptorRaw, Header) && File.Write(Size, const_cast<uint32 *>(Pixels));
+}
+
 ImageDescriptor::ImageDescriptor(const ImageDescriptor &copyFrom) :
 	Width(copyFrom.Width),
 	Height(copyFrom.Height),
@@ -460,7 +596,7 @@ bool ImageDescriptor::LoadDDSFromFile(FileSpecifier& File, int flags, int actual
 		// we don't handle incomplete mip map chains
 		// if we're only missing one, that's OK; XBLA textures do that
 		if (!(OriginalMipMapCount == ExpectedMipMapCount || OriginalMipMapCount == (ExpectedMipMapCount - 1))) {
-			logWarning("incomplete mipmap chain (%ix%i, %ix%i, %i mipmaps)", Width, Height, ddsd.dwWidth, ddsd.dwHeight, OriginalMipMapCount);
+			logWarningNMT("incomplete mipmap chain (%ix%i, %ix%i, %i mipmaps)", Width, Height, ddsd.dwWidth, ddsd.dwHeight, OriginalMipMapCount);
 			return false;
 		}
 
@@ -32,6 +32,8 @@
 
 #include <cmath>
 
+#include <SDL2/SDL_mutex.h>
+
 #include "Dim3_Loader.h"
 #include "StudioLoader.h"
 #include "WavefrontLoader.h"
@@ -373,15 +375,20 @@ static bool StringsEqual(const char *String1, const char *String2, int MaxStrLen
 
 void OGL_ModelData::Load()
 {
-	// Already loaded?
-	if (ModelPresent()) return;
+	LoadModel();
 	
-	// Load the model
-	Model.Clear();
+	// Don't forget the skins
+	OGL_SkinManager::Load();
+}
 
-	if (ModelFile == FileSpecifier()) return;
-	if (!ModelFile.Exists()) return;
 
+// The model-file readers keep their parse state in statics
+static bool LoadModelFile(FileSpecifier& ModelFile, FileSpecifier& ModelFile1, FileSpecifier& ModelFile2,
+	vector<char>& ModelType, Model3D& Model)
+{
+	static SDL_mutex *LoaderMutex = SDL_CreateMutex();
+	SDL_LockMutex(LoaderMutex);
+	
 	bool Success = false;
 	
 	char *Type = &ModelType[0];
@@ -437,7 +444,23 @@ void OGL_ModelData::Load()
 	}
 #endif
 	
-	if (!Success)
+	SDL_UnlockMutex(LoaderMutex);
+	return Success;
+}
+
+
+void OGL_ModelData::LoadModel()
+{
+	// Already loaded?
+	if (ModelPresent()) return;
+	
+	// Load the model
+	Model.Clear();
+
+	if (ModelFile == FileSpecifier()) return;
+	if (!ModelFile.Exists()) return;
+
+	if (!LoadModelFile(ModelFile, ModelFile1, ModelFile2, ModelType, Model))
 	{
 		Model.Clear();
 		return;
@@ -575,9 +598,6 @@ void OGL_ModelData::Load()
 	
 	Model.AdjustNormals(NormalType,NormalSplit);
 	Model.CalculateTangents();
-	
-	// Don't forget the skins
-	OGL_SkinManager::Load();
 }
 
 
@@ -616,6 +636,19 @@ void OGL_LoadModels(short Collection)
 	}
 }
 
+void OGL_GetModelsToLoad(short Collection, vector<OGL_ModelData *>& Models)
+{
+	vector<ModelDataEntry>& ML = MdlList[Collection];
+	for (vector<ModelDataEntry>::iterator MdlIter = ML.begin(); MdlIter < ML.end(); MdlIter++)
+	{
+		if (MdlIter->ModelData.ForceSpriteDepth)
+		{
+			ForcingSpriteDepth = true;
+		}
+		Models.push_back(&MdlIter->ModelData);
+	}
+}
+
 void OGL_UnloadModels(short Collection)
 {
 	vector<ModelDataEntry>& ML = MdlList[Collection];
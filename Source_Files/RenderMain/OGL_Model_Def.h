@@ -123,6 +123,9 @@ public:
 	void Load();
 	void Unload();
 	
+	// Loads the model without its skins; safe to call from several threads at once
+	void LoadModel();
+	
 	OGL_ModelData():
 		Scale(1), XRot(0), YRot(0), ZRot(0), XShift(0), YShift(0), ZShift(0), Sidedness(1),
 			NormalType(1), NormalSplit(0.5), LightType(0), DepthType(0), ForceSpriteDepth(false) {}
@@ -141,6 +144,9 @@ int OGL_CountModels(short Collection);
 void OGL_LoadModels(short Collection);
 void OGL_UnloadModels(short Collection);
 
+// Appends a collection's models, for loading them elsewhere (see OGL_LoadModelsImages())
+void OGL_GetModelsToLoad(short Collection, vector<OGL_ModelData *>& Models);
+
 // for managing the sprite depth-buffer override (see ForceSpriteDepth above)
 void OGL_ResetForceSpriteDepth();  // to clear before calling OGL_LoadModels
 bool OGL_ForceSpriteDepth();
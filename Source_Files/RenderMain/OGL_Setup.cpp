@@ -67,6 +67,14 @@ Jan 25, 2002 (Br'fin (Jeremy Parsons)):
 
 Feb 5, 2002 (Br'fin (Jeremy Parsons)):
 	Refined OGL default preferences for Carbon
+
+Oct 16, 2026:
+	Substitute textures, models and skins are decoded on a worker pool during level load,
+	with the decode time of each collection kept for a report
+
+Oct 16, 2026:
+	Decoded substitute textures, with their mipmaps, are kept in an on-disk cache
+	keyed by the contents of their files and the options they were loaded with
 */
 
 #include <vector>
@@ -78,6 +86,13 @@ Feb 5, 2002 (Br'fin (Jeremy Parsons)):
 
 #include "OGL_Headers.h"
 #include "OGL_Shader.h"
+#include "Logging.h"
+#include "ReplacementTextureCache.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
 
 #endif
 
@@ -296,22 +311,37 @@ void OGL_TextureOptionsBase::Load()
 
 	NormalImg.Clear();
 	
-	// Load the normal image if it has a filename specified for it
-	if (NormalColors != FileSpecifier() && NormalColors.Exists())
-	{
-		if (!NormalImg.LoadFromFile(NormalColors,ImageLoader_Colors, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize))
-		{
-			// A texture must have a normal colored part
-			return;
-		}
-	}
-	else
+	// A texture must have a normal colored part
+	if (NormalColors == FileSpecifier() || !NormalColors.Exists())
+		return;
+
+	// Everything below depends only on these and the files' contents
+	bool BumpMap = TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap);
+	ReplacementTextureKey Key;
+	Key.add(flags);
+	Key.add(maxTextureSize);
+	Key.add(actual_width);
+	Key.add(actual_height);
+	Key.add(NormalIsPremultiplied);
+	Key.add(GlowIsPremultiplied);
+	Key.add(BumpMap);
+	Key.add_file(NormalColors);
+	Key.add_file(NormalMask);
+	Key.add_file(GlowColors);
+	Key.add_file(GlowMask);
+	if (BumpMap)
+		Key.add_file(OffsetMap);
+
+	if (ReplacementTextureCache::instance()->retrieve(Key.value(), NormalImg, GlowImg, OffsetImg))
+		return;
+
+	if (!NormalImg.LoadFromFile(NormalColors,ImageLoader_Colors, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize))
 	{
 		return;
 	}
 
 	// load a heightmap
-	if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap) && OffsetMap != FileSpecifier() && OffsetMap.Exists()) {
+	if (BumpMap && OffsetMap != FileSpecifier() && OffsetMap.Exists()) {
 		if(!OffsetImg.LoadFromFile(OffsetMap, ImageLoader_Colors, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize)) {
 			return;
 		}
@@ -384,6 +414,16 @@ void OGL_TextureOptionsBase::Load()
 		GlowImg.Clear();
 	}
 
+	// Building the mipmaps here spares the main thread from doing it at upload time
+	if (flags & ImageLoader_LoadMipMaps)
+	{
+		NormalImg.MakeMipMaps();
+		GlowImg.MakeMipMaps();
+		OffsetImg.MakeMipMaps();
+	}
+
+	if (NormalImg.IsPresent())
+		ReplacementTextureCache::instance()->store(Key.value(), NormalImg, GlowImg, OffsetImg);
 }
 
 void OGL_TextureOptionsBase::Unload()
@@ -411,22 +451,174 @@ int OGL_CountModelsImages(short Collection)
 	return OGL_CountTextures(Collection) + OGL_CountModels(Collection);
 }
 
+// One image or model to decode
+struct OGL_LoadJob
+{
+	short Collection;
+	OGL_TextureOptionsBase *Image;
+	OGL_ModelData *Model;
+	bool Skin;				// skins don't count toward the progress bar
+	uint64_t Microseconds;
+	DeferredLog Log;		// the loaders log as if on the main thread
+};
+
+// Runs the jobs on a pool, from a thread of its own, so the calling thread is
+// free to draw the progress bar
+struct OGL_LoadRun
+{
+	std::vector<OGL_LoadJob>& Jobs;
+	std::atomic_int Finished;	// non-skin jobs finished since the last poll
+	std::atomic_bool Done;
+	
+	static int Run(void *p)
+	{
+		OGL_LoadRun *LoadRun = static_cast<OGL_LoadRun *>(p);
+		WorkerPool Pool(std::max(SDL_GetCPUCount(), 1));
+		Pool.run(static_cast<int>(LoadRun->Jobs.size()), [LoadRun](int i, int) {
+			OGL_LoadJob& Job = LoadRun->Jobs[i];
+			deferLogging(&Job.Log);
+			uint64_t JobStart = machine_microsecond_count();
+			if (Job.Model)
+				Job.Model->LoadModel();
+			else
+				Job.Image->Load();
+			Job.Microseconds = machine_microsecond_count() - JobStart;
+			deferLogging(NULL);
+			
+			if (!Job.Skin)
+				++LoadRun->Finished;
+		});
+		LoadRun->Done = true;
+		return 0;
+	}
+};
+
+struct OGL_CollectionLoadTime
+{
+	short Collection;
+	int Images;
+	int Models;
+	uint64_t Microseconds;
+};
+
+static std::vector<OGL_CollectionLoadTime> CollectionLoadTimes;
+static uint64_t TotalLoadMicroseconds = 0;
+
 // for managing the model and image loading and unloading
 void OGL_LoadModelsImages(short Collection)
 {
-	assert(Collection >= 0 && Collection < MAXIMUM_COLLECTIONS);
+	OGL_LoadModelsImages(std::vector<short>(1, Collection));
+}
 
+// Decoding and post-processing (premultiplying, minifying, normals) touch nothing
+// but the texture or model itself, so they go to a worker pool; the GL uploads
+// happen later, on the main thread, when the textures are first used
+void OGL_LoadModelsImages(const std::vector<short>& Collections)
+{
 	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &glMaxTextureSize);
 	hasS3TC = OGL_CheckExtension("GL_ARB_texture_compression") && OGL_CheckExtension("GL_EXT_texture_compression_s3tc");
 	
-	// For wall/sprite images
-	OGL_LoadTextures(Collection);
+	bool LoadModels = TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_3D_Models);
 	
-	// For models, skins
-	if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_3D_Models))
-		OGL_LoadModels(Collection);
+	// Models go first: their readers share state and take turns, so they
+	// should be under way while the other threads decode images
+	std::vector<OGL_LoadJob> Jobs;
+	std::vector<OGL_LoadJob> ImageJobs;
+	for (short Collection : Collections)
+	{
+		assert(Collection >= 0 && Collection < MAXIMUM_COLLECTIONS);
+		
+		// For wall/sprite images
+		std::vector<OGL_TextureOptionsBase *> Images;
+		OGL_GetTexturesToLoad(Collection, Images);
+		for (OGL_TextureOptionsBase *Image : Images)
+			ImageJobs.push_back({Collection, Image, NULL, false, 0, DeferredLog()});
+		
+		// For models, skins
+		if (!LoadModels)
+		{
+			OGL_UnloadModels(Collection);
+			continue;
+		}
+		
+		std::vector<OGL_ModelData *> Models;
+		OGL_GetModelsToLoad(Collection, Models);
+		for (OGL_ModelData *Model : Models)
+		{
+			Jobs.push_back({Collection, NULL, Model, false, 0, DeferredLog()});
+			for (OGL_SkinData& Skin : Model->SkinData)
+				ImageJobs.push_back({Collection, &Skin, NULL, true, 0, DeferredLog()});
+		}
+	}
+	Jobs.insert(Jobs.end(), ImageJobs.begin(), ImageJobs.end());
+	
+	// Only this thread may draw the progress bar, so it polls while the pool works
+	OGL_LoadRun LoadRun = {Jobs, {0}, {false}};
+	uint64_t Start = machine_microsecond_count();
+	SDL_Thread *Thread = SDL_CreateThread(OGL_LoadRun::Run, "OGL_LoadModelsImages", &LoadRun);
+	if (Thread)
+	{
+		while (!LoadRun.Done)
+		{
+			OGL_ProgressCallback(LoadRun.Finished.exchange(0));
+			SDL_Delay(15);
+		}
+		SDL_WaitThread(Thread, NULL);
+	}
 	else
-		OGL_UnloadModels(Collection);
+		OGL_LoadRun::Run(&LoadRun);
+	OGL_ProgressCallback(LoadRun.Finished.exchange(0));
+	TotalLoadMicroseconds = machine_microsecond_count() - Start;
+	
+	for (const OGL_LoadJob& Job : Jobs)
+		logDeferredMessages(Job.Log);
+	
+	// The report: time spent decoding each collection, summed over threads
+	CollectionLoadTimes.clear();
+	for (short Collection : Collections)
+	{
+		OGL_CollectionLoadTime Time = {Collection, 0, 0, 0};
+		for (const OGL_LoadJob& Job : Jobs)
+		{
+			if (Job.Collection != Collection) continue;
+			
+			if (Job.Model)
+				Time.Models++;
+			else if (!Job.Skin)
+				Time.Images++;
+			Time.Microseconds += Job.Microseconds;
+		}
+		if (Time.Images || Time.Models)
+			CollectionLoadTimes.push_back(Time);
+	}
+	std::sort(CollectionLoadTimes.begin(), CollectionLoadTimes.end(), [](const OGL_CollectionLoadTime& a, const OGL_CollectionLoadTime& b) {
+		return a.Microseconds > b.Microseconds;
+	});
+	
+	for (const std::string& Line : OGL_SummarizeLoadTimes(CollectionLoadTimes.size() + 1))
+		logNote("%s", Line.c_str());
+}
+
+std::vector<std::string> OGL_SummarizeLoadTimes(size_t maximum_lines)
+{
+	std::vector<std::string> lines;
+	if (CollectionLoadTimes.empty() || !maximum_lines) return lines;
+	
+	std::ostringstream s;
+	s << "decoded replacements in " << TotalLoadMicroseconds / 1000 << " ms";
+	lines.push_back(s.str());
+	
+	for (const OGL_CollectionLoadTime& Time : CollectionLoadTimes)
+	{
+		if (lines.size() >= maximum_lines) break;
+		
+		std::ostringstream s;
+		s << "collection " << Time.Collection << ": " << Time.Microseconds / 1000 << " ms, "
+		  << Time.Images << " images, " << Time.Models << " models";
+		lines.push_back(s.str());
+	}
+	
+	return lines;
 }
 
 void OGL_UnloadModelsImages(short Collection)
@@ -446,6 +638,15 @@ void OGL_LoadModelsImages(short)
 {
 }
 
+void OGL_LoadModelsImages(const std::vector<short>&)
+{
+}
+
+std::vector<std::string> OGL_SummarizeLoadTimes(size_t)
+{
+	return std::vector<std::string>();
+}
+
 void OGL_UnloadModelsImages(short)
 {
 }
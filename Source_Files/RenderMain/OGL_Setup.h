@@ -68,6 +68,7 @@ Aug 21, 2001 (Loren Petrich):
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 #if (defined(__WIN32__) || (defined(__APPLE__) && defined(__MACH__)))
 #define OPENGL_DOESNT_COPY_ON_SWAP
@@ -268,8 +269,13 @@ void OGL_SetDefaults(OGL_ConfigureData& Data);
 // for managing the model and image loading and unloading;
 int OGL_CountModelsImages(short Collection);
 void OGL_LoadModelsImages(short Collection);
+void OGL_LoadModelsImages(const std::vector<short>& Collections);
 void OGL_UnloadModelsImages(short Collection);
 
+// Report on the most recent OGL_LoadModelsImages(): total time, then each
+// collection's decode time summed over the loading threads, slowest first
+std::vector<std::string> OGL_SummarizeLoadTimes(size_t maximum_lines);
+
 // Reset the textures (walls, sprites, and model skins) (good if they start to crap out)
 // Implemented in OGL_Textures.cpp
 void OGL_ResetTextures();
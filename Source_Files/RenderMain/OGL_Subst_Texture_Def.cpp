@@ -75,6 +75,15 @@ void OGL_LoadTextures(short Collection)
 }
 
 
+void OGL_GetTexturesToLoad(short Collection, vector<OGL_TextureOptionsBase *>& Textures)
+{
+	for (TOHash::iterator it = Collections[Collection].begin(); it != Collections[Collection].end(); ++it)
+	{
+		Textures.push_back(&it->second);
+	}
+}
+
+
 void OGL_UnloadTextures(short Collection)
 {
 	for (TOHash::iterator it = Collections[Collection].begin(); it != Collections[Collection].end(); ++it)
@@ -54,6 +54,9 @@ int OGL_CountTextures(short Collection);
 void OGL_LoadTextures(short Collection);
 void OGL_UnloadTextures(short Collection);
 
+// Appends a collection's texture options, for loading them elsewhere (see OGL_LoadModelsImages())
+void OGL_GetTexturesToLoad(short Collection, vector<OGL_TextureOptionsBase *>& Textures);
+
 class InfoTree;
 void parse_mml_opengl_texture(const InfoTree& root);
 void reset_mml_opengl_texture();
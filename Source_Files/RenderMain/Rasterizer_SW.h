@@ -22,11 +22,27 @@
 	Rasterizer software impementation (plugs into scottish_textures files)
 	by Loren Petrich,
 	August 7, 2000
-	
+
+Oct 16, 2026:
+	With more than one software rendering thread, the calls between Begin() and End() are
+	recorded and End() replays them in vertical bands of the screen on a worker pool
 */
 
 #include "Rasterizer.h"
 
+#include <memory>
+#include <vector>
+
+class WorkerPool;
+
+/* the columns [left, right) a texture mapper may draw into, and the scratch memory it uses */
+struct sw_raster_band
+{
+	short left, right;
+	short *scratch_table0, *scratch_table1;
+	void *precalculation_table;
+};
+
 
 class Rasterizer_SW_Class: public RasterizerClass
 {
@@ -44,11 +60,50 @@ public:
 	// Rendering calls
 	// These are defined in scottish_textures.c (too great a name to change)
 	
+	void Begin();
+	void End();
+	
 	void texture_horizontal_polygon(polygon_definition& textured_polygon);
 	
 	void texture_vertical_polygon(polygon_definition& textured_polygon);
 	
 	void texture_rectangle(rectangle_definition& textured_rectangle);
+
+	Rasterizer_SW_Class();
+	~Rasterizer_SW_Class();
+
+private:
+
+	void draw_horizontal_polygon(polygon_definition& textured_polygon, sw_raster_band& band);
+	void draw_vertical_polygon(polygon_definition& textured_polygon, sw_raster_band& band);
+	void draw_rectangle(rectangle_definition& textured_rectangle, sw_raster_band& band);
+
+	void replay_commands(sw_raster_band& band);
+
+	enum /* recorded calls */
+	{
+		_horizontal_polygon_command,
+		_vertical_polygon_command,
+		_rectangle_command
+	};
+
+	struct raster_command
+	{
+		int16 type;
+		int32 index; // into polygons or rectangles
+	};
+
+	bool recording;
+	// the static effect takes its noise from one shared seed, in drawing order
+	bool recorded_static;
+	std::vector<raster_command> commands;
+	std::vector<polygon_definition> polygons;
+	std::vector<rectangle_definition> rectangles;
+
+	std::unique_ptr<WorkerPool> pool;
+	int pool_size; // the thread count pool was made for
+	std::vector<std::unique_ptr<short[]>> worker_scratch_tables;
+	std::vector<std::unique_ptr<char[]>> worker_precalculation_tables;
 };
 
 
@@ -0,0 +1,351 @@
+/*
+ *  ReplacementTextureCache.cpp - an on-disk cache for decoded replacement textures
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ */
+
+#include "ReplacementTextureCache.h"
+
+#include "AStream.h"
+#include "InfoTree.h"
+#include "Logging.h"
+#include "ScopedMutex.h"
+
+#include <vector>
+
+static const uint32 REPLACEMENT_TEXTURE_TAG = FOUR_CHARS_TO_INT('a', '1', 't', 'x');
+
+// bump this whenever OGL_TextureOptionsBase::Load() produces different images
+static const int16 REPLACEMENT_TEXTURE_VERSION = 1;
+
+static const int SIZEOF_replacement_texture_header = 4 + 2 + 2 + 8;
+
+enum /* images in a cache file */
+{
+	_normal_image,
+	_glow_image,
+	_offset_image,
+	NUMBER_OF_CACHED_IMAGES
+};
+
+/* ---------- keys */
+
+// 64-bit FNV-1a
+ReplacementTextureKey::ReplacementTextureKey() : m_hash(UINT64_C(0xcbf29ce484222325))
+{
+	add(REPLACEMENT_TEXTURE_VERSION);
+}
+
+void ReplacementTextureKey::add_bytes(const uint8 *bytes, size_t length)
+{
+	for (size_t i = 0; i < length; ++i)
+	{
+		m_hash ^= bytes[i];
+		m_hash *= UINT64_C(0x100000001b3);
+	}
+}
+
+void ReplacementTextureKey::add(int64_t value)
+{
+	uint8 bytes[8];
+	for (int i = 0; i < 8; ++i)
+	{
+		bytes[i] = static_cast<uint8>(value >> (8 * i));
+	}
+	add_bytes(bytes, sizeof(bytes));
+}
+
+void ReplacementTextureKey::add_file(FileSpecifier& file)
+{
+	OpenedFile opened_file;
+	int32 length;
+	if (file == FileSpecifier() || !file.Exists() || !file.Open(opened_file) || !opened_file.GetLength(length))
+	{
+		add(NONE);
+		return;
+	}
+
+	add(length);
+
+	std::vector<uint8> buffer(65536);
+	while (length > 0)
+	{
+		int32 count = std::min(length, static_cast<int32>(buffer.size()));
+		if (!opened_file.Read(count, buffer.data()))
+		{
+			add(NONE);
+			return;
+		}
+
+		add_bytes(buffer.data(), count);
+		length -= count;
+	}
+}
+
+/* ---------- cache */
+
+ReplacementTextureCache* ReplacementTextureCache::instance() {
+	static ReplacementTextureCache *m_instance = nullptr;
+	if (!m_instance) {
+		m_instance = new ReplacementTextureCache;
+	}
+
+	return m_instance;
+}
+
+std::string ReplacementTextureCache::name_for_key(uint64_t key)
+{
+	char name[24];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+	return name;
+}
+
+FileSpecifier ReplacementTextureCache::file_for_key(uint64_t key) const
+{
+	FileSpecifier file;
+	file.SetToImageCacheDir();
+	file.AddPart("Textures");
+	file.AddPart(name_for_key(key));
+	return file;
+}
+
+void ReplacementTextureCache::initialize_cache()
+{
+	FileSpecifier dir;
+	dir.SetToImageCacheDir();
+	dir.AddPart("Textures");
+	dir.CreateDirectory();
+	if (!dir.IsDir())
+		return;
+
+	m_initialized = true;
+
+	FileSpecifier info = dir;
+	info.AddPart("Cache.ini");
+	if (!info.Exists())
+		return;
+
+	InfoTree pt;
+	try {
+		pt = InfoTree::load_ini(info);
+	} catch (const InfoTree::ini_error& e) {
+		logError("Could not read texture cache from %s (%s)", info.GetPath(), e.what());
+	}
+
+	// saved most recently used first
+	for (InfoTree::iterator it = pt.begin(); it != pt.end(); ++it)
+	{
+		uint64_t key = strtoull(it->first.c_str(), NULL, 16);
+		InfoTree ptc = it->second;
+		size_t filesize = 0;
+		ptc.read("filesize", filesize);
+
+		if (m_cacheinfo.count(key))
+			continue;
+
+		m_used.push_back(cache_pair_t(key, filesize));
+		m_cacheinfo[key] = std::prev(m_used.end());
+		m_cachesize += filesize;
+	}
+
+	apply_cache_limit();
+}
+
+bool ReplacementTextureCache::retrieve(uint64_t key, ImageDescriptor& normal, ImageDescriptor& glow, ImageDescriptor& offset)
+{
+	{
+		ScopedMutex lock(m_mutex);
+		std::map<uint64_t, cache_iter_t>::iterator it = m_cacheinfo.find(key);
+		if (it == m_cacheinfo.end())
+			return false;
+
+		if (it->second != m_used.begin())
+		{
+			m_used.splice(m_used.begin(), m_used, it->second);
+			m_cache_dirty = true;
+		}
+	}
+
+	OpenedFile opened_file;
+	FileSpecifier file = file_for_key(key);
+	if (!file.Open(opened_file))
+	{
+		forget(key);
+		return false;
+	}
+
+	uint8 header[SIZEOF_replacement_texture_header];
+	if (!opened_file.Read(SIZEOF_replacement_texture_header, header))
+	{
+		opened_file.Close();
+		forget(key);
+		return false;
+	}
+
+	uint32 tag, key_high, key_low;
+	int16 version, image_flags;
+	AIStreamBE stream(header, SIZEOF_replacement_texture_header);
+	stream >> tag >> version >> image_flags >> key_high >> key_low;
+	if (tag != REPLACEMENT_TEXTURE_TAG || version != REPLACEMENT_TEXTURE_VERSION ||
+		((static_cast<uint64_t>(key_high) << 32) | key_low) != key)
+	{
+		opened_file.Close();
+		forget(key);
+		return false;
+	}
+
+	ImageDescriptor *images[NUMBER_OF_CACHED_IMAGES] = { &normal, &glow, &offset };
+	for (int i = 0; i < NUMBER_OF_CACHED_IMAGES; ++i)
+	{
+		images[i]->Clear();
+		if ((image_flags & (1 << i)) && !images[i]->ReadRaw(opened_file))
+		{
+			normal.Clear();
+			glow.Clear();
+			offset.Clear();
+			opened_file.Close();
+			forget(key);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ReplacementTextureCache::store(uint64_t key, const ImageDescriptor& normal, const ImageDescriptor& glow, const ImageDescriptor& offset)
+{
+	if (!m_initialized)
+		return;
+
+	{
+		ScopedMutex lock(m_mutex);
+		if (m_cacheinfo.count(key))
+			return;
+	}
+
+	const ImageDescriptor *images[NUMBER_OF_CACHED_IMAGES] = { &normal, &glow, &offset };
+	int16 image_flags = 0;
+	for (int i = 0; i < NUMBER_OF_CACHED_IMAGES; ++i)
+	{
+		if (images[i]->IsPresent())
+			image_flags |= (1 << i);
+	}
+
+	uint8 header[SIZEOF_replacement_texture_header];
+	AOStreamBE stream(header, SIZEOF_replacement_texture_header);
+	stream << REPLACEMENT_TEXTURE_TAG << REPLACEMENT_TEXTURE_VERSION << image_flags
+		   << static_cast<uint32>(key >> 32) << static_cast<uint32>(key);
+
+	// written aside and renamed, so a crash never leaves half a file under the real name
+	FileSpecifier file = file_for_key(key);
+	FileSpecifier temp_file;
+	temp_file.SetTempName(file);
+
+	bool written;
+	int32 length = 0;
+	{
+		OpenedFile opened_file;
+		written = temp_file.Open(opened_file, true) && opened_file.Write(SIZEOF_replacement_texture_header, header);
+		for (int i = 0; i < NUMBER_OF_CACHED_IMAGES && written; ++i)
+		{
+			if (images[i]->IsPresent())
+				written = images[i]->WriteRaw(opened_file);
+		}
+		written = written && opened_file.GetLength(length);
+	}
+
+	if (written)
+	{
+		ScopedMutex lock(m_mutex);
+		if (!m_cacheinfo.count(key) && temp_file.Rename(file))
+		{
+			m_used.push_front(cache_pair_t(key, length));
+			m_cacheinfo[key] = m_used.begin();
+			m_cachesize += length;
+			m_cache_dirty = true;
+			apply_cache_limit();
+			return;
+		}
+	}
+
+	temp_file.Delete();
+}
+
+// drops an entry whose file is missing or unreadable, and the file if there is
+// one; the caller must have closed it
+void ReplacementTextureCache::forget(uint64_t key)
+{
+	ScopedMutex lock(m_mutex);
+	file_for_key(key).Delete();
+
+	std::map<uint64_t, cache_iter_t>::iterator it = m_cacheinfo.find(key);
+	if (it == m_cacheinfo.end())
+		return;
+
+	m_cachesize -= it->second->second;
+	m_used.erase(it->second);
+	m_cacheinfo.erase(it);
+	m_cache_dirty = true;
+}
+
+void ReplacementTextureCache::set_limit(size_t bytes)
+{
+	ScopedMutex lock(m_mutex);
+	m_sizelimit = bytes;
+	apply_cache_limit();
+}
+
+// caller holds the mutex
+void ReplacementTextureCache::apply_cache_limit()
+{
+	while (m_cachesize > m_sizelimit && m_used.size())
+	{
+		cache_pair_t last_item = m_used.back();
+		m_used.pop_back();
+		file_for_key(last_item.first).Delete();
+		m_cachesize -= last_item.second;
+		m_cacheinfo.erase(last_item.first);
+		m_cache_dirty = true;
+	}
+}
+
+void ReplacementTextureCache::save_cache()
+{
+	ScopedMutex lock(m_mutex);
+	if (!m_cache_dirty)
+		return;
+
+	InfoTree pt;
+
+	for (cache_iter_t it = m_used.begin(); it != m_used.end(); ++it)
+	{
+		pt.put(name_for_key(it->first) + ".filesize", it->second);
+	}
+
+	FileSpecifier info;
+	info.SetToImageCacheDir();
+	info.AddPart("Textures");
+	info.AddPart("Cache.ini");
+	try {
+		pt.save_ini(info);
+		m_cache_dirty = false;
+	} catch (const InfoTree::ini_error& e) {
+		logError("Could not save texture cache to %s (%s)", info.GetPath(), e.what());
+		return;
+	}
+}
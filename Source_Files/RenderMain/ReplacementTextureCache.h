@@ -0,0 +1,97 @@
+/*
+ *  ReplacementTextureCache.h - an on-disk cache for decoded replacement textures
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ */
+
+#ifndef REPLACEMENT_TEXTURE_CACHE_H
+#define REPLACEMENT_TEXTURE_CACHE_H
+
+#include "cseries.h"
+#include "FileHandler.h"
+#include "ImageLoader.h"
+
+#include <list>
+#include <map>
+
+#include <SDL2/SDL_mutex.h>
+
+// Names a decoded texture by the contents of its source files and the
+// options it was decoded with, so edited files never hit stale entries
+class ReplacementTextureKey {
+public:
+	ReplacementTextureKey();
+
+	void add(int64_t value);
+
+	// Hashes the file's contents, or notes that it is missing
+	void add_file(FileSpecifier& file);
+
+	uint64_t value() const { return m_hash; }
+
+private:
+	void add_bytes(const uint8 *bytes, size_t length);
+
+	uint64_t m_hash;
+};
+
+// The normal, glow and offset images that OGL_TextureOptionsBase::Load()
+// produces, stored raw so a cache hit is a few reads and no decoding.
+// Safe to use from the texture-loading threads.
+class ReplacementTextureCache {
+public:
+	typedef std::pair<uint64_t, size_t> cache_pair_t;
+	typedef std::list<cache_pair_t>::iterator cache_iter_t;
+
+	static ReplacementTextureCache* instance();
+
+	// Call this at startup, before any other calls.
+	void initialize_cache();
+
+	// Fills in the images and returns true if the key is cached;
+	// an absent image comes back cleared
+	bool retrieve(uint64_t key, ImageDescriptor& normal, ImageDescriptor& glow, ImageDescriptor& offset);
+
+	// Adds the images, evicting the least recently used entries if over the limit
+	void store(uint64_t key, const ImageDescriptor& normal, const ImageDescriptor& glow, const ImageDescriptor& offset);
+
+	void save_cache();
+
+	size_t size() { return m_cachesize; }
+	size_t limit() { return m_sizelimit; }
+	void set_limit(size_t bytes);
+
+private:
+	ReplacementTextureCache() : m_mutex(SDL_CreateMutex()) { }
+
+	static std::string name_for_key(uint64_t key);
+	FileSpecifier file_for_key(uint64_t key) const;
+	void forget(uint64_t key);
+	void apply_cache_limit();
+
+	std::list<cache_pair_t> m_used;
+	std::map<uint64_t, cache_iter_t> m_cacheinfo;
+	size_t m_cachesize = 0;
+	size_t m_sizelimit = 2000000000;
+	bool m_initialized = false;
+	bool m_cache_dirty = false;
+
+	SDL_mutex *m_mutex;
+};
+
+#endif
@@ -28,12 +28,17 @@ Monday, February 27, 1995 11:40:47 PM  (Jason')
 Jan 30, 2000 (Loren Petrich):
 	Added some typecasts
 	Removed some "static" declarations that conflict with "extern"
+
+Oct 16, 2026:
+	Opaque horizontal spans and the parallel part of opaque walls go through the
+	vector kernels in low_level_textures_simd.cpp when the CPU has them
 */
 
 #include "cseries.h"
 #include "preferences.h"
 #include "textures.h"
 #include "scottish_textures.h"
+#include "low_level_textures_simd.h"
 
 /* ---------- global state */
 
@@ -217,6 +222,14 @@ void texture_horizontal_polygon_lines
 		uint32 source_dy= data->source_dy;
 		short count= x1-x0;
 		
+		if (sw_alpha_blend == _sw_alpha_off)
+		{
+			int done= texture_horizontal_span_simd(write, base_address, shading_table, source_x, source_y, source_dx, source_dy, count, TEXBITS);
+			
+			write+= done, count-= done;
+			source_x+= done*source_dx, source_y+= done*source_dy;
+		}
+		
 		while ((count-= 1)>=0)
 		{
 			write_pixel<T, sw_alpha_blend, false>(write++, base_address[((source_y>>(HORIZONTAL_HEIGHT_DOWNSHIFT-TEXBITS))&(((1<<TEXBITS)-1)<<TEXBITS))+(source_x>>HORIZONTAL_WIDTH_DOWNSHIFT)], shading_table, opacity_table, rmask, gmask, bmask);
@@ -421,6 +434,21 @@ void texture_vertical_polygon_lines(
 				count= MIN(dy0, dy1), count= MIN(count, dy2), count= MIN(count, dy3);
 				ymax+= count;
 				
+				if (sw_alpha_blend == _sw_alpha_off && !check_transparent && count>0)
+				{
+					pixel8 * const read[4]= { read0, read1, read2, read3 };
+					T * const shading_tables[4]= { shading_table0, shading_table1, shading_table2, shading_table3 };
+					uint32 texture_y[4]= { texture_y0, texture_y1, texture_y2, texture_y3 };
+					const uint32 texture_dy[4]= { texture_dy0, texture_dy1, texture_dy2, texture_dy3 };
+					
+					if (texture_vertical_columns_x4_simd(write, bytes_per_row, count, downshift, read, shading_tables, texture_y, texture_dy))
+					{
+						texture_y0= texture_y[0], texture_y1= texture_y[1], texture_y2= texture_y[2], texture_y3= texture_y[3];
+						write = (T *)((byte *)write + count*bytes_per_row);
+						count= 0;
+					}
+				}
+				
 				for (; count>0; --count)
 				{
 					write_pixel<T, sw_alpha_blend, check_transparent>(write, read0[texture_y0>>downshift], shading_table0, opacity_table, rmask, gmask, bmask);
@@ -0,0 +1,447 @@
+/*
+LOW_LEVEL_TEXTURES_SIMD.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+Oct 16, 2026:
+	Texture coordinates are computed in vector registers with the same unsigned 32-bit
+	arithmetic as the scalar loops.  Texels are always fetched one byte at a time, since
+	a wider gather could read past the end of a texture; with AVX2 the shading table
+	lookup for 32-bit pixels is a hardware gather (the table always has 256 entries).
+*/
+
+#include "cseries.h"
+#include "low_level_textures_simd.h"
+
+#include <SDL2/SDL_cpuinfo.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SPAN_KERNELS_X86
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SPAN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SPAN_TARGET(isa)
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define SPAN_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+static bool span_kernel_supported(short kernel)
+{
+	switch (kernel)
+	{
+		case _span_kernel_scalar:
+			return true;
+#if defined(SPAN_KERNELS_X86)
+		case _span_kernel_sse2:
+			return SDL_HasSSE2();
+		case _span_kernel_avx2:
+			return SDL_HasAVX2();
+#elif defined(SPAN_KERNELS_NEON)
+		case _span_kernel_neon:
+			return SDL_HasNEON();
+#endif
+		default:
+			return false;
+	}
+}
+
+static short detect_span_kernel()
+{
+	for (short kernel = NUMBER_OF_SPAN_KERNELS - 1; kernel > _span_kernel_scalar; --kernel)
+	{
+		if (span_kernel_supported(kernel)) return kernel;
+	}
+	return _span_kernel_scalar;
+}
+
+// picked before any renderer thread can read it
+static short span_kernel = detect_span_kernel();
+
+short get_span_kernel()
+{
+	return span_kernel;
+}
+
+bool set_span_kernel(short kernel)
+{
+	if (!span_kernel_supported(kernel)) return false;
+
+	span_kernel = kernel;
+	return true;
+}
+
+/* ---------- horizontal spans */
+
+/* texel index of each lane: ((y>>(32-2*texbits)) & row mask) + (x>>(32-texbits)), exactly as
+	texture_horizontal_polygon_lines() computes it */
+
+#if defined(SPAN_KERNELS_X86)
+
+SPAN_TARGET("sse2")
+static int horizontal_span_sse2(pixel16 *write, const pixel8 *texture, const pixel16 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	const __m128i x_shift = _mm_cvtsi32_si128(32 - texbits);
+	const __m128i y_shift = _mm_cvtsi32_si128(32 - 2 * texbits);
+	const __m128i row_mask = _mm_set1_epi32(((1 << texbits) - 1) << texbits);
+	const __m128i step_x = _mm_set1_epi32(static_cast<int>(4 * source_dx));
+	const __m128i step_y = _mm_set1_epi32(static_cast<int>(4 * source_dy));
+	__m128i x = _mm_setr_epi32(source_x, source_x + source_dx, source_x + 2 * source_dx, source_x + 3 * source_dx);
+	__m128i y = _mm_setr_epi32(source_y, source_y + source_dy, source_y + 2 * source_dy, source_y + 3 * source_dy);
+
+	int written = 0;
+	for (; written + 8 <= count; written += 8)
+	{
+		alignas(16) uint32 index[8];
+		for (int half = 0; half < 2; ++half)
+		{
+			__m128i i = _mm_add_epi32(_mm_and_si128(_mm_srl_epi32(y, y_shift), row_mask), _mm_srl_epi32(x, x_shift));
+			_mm_store_si128(reinterpret_cast<__m128i *>(index + 4 * half), i);
+			x = _mm_add_epi32(x, step_x);
+			y = _mm_add_epi32(y, step_y);
+		}
+
+		__m128i pixels = _mm_setr_epi16(
+			shading_table[texture[index[0]]], shading_table[texture[index[1]]],
+			shading_table[texture[index[2]]], shading_table[texture[index[3]]],
+			shading_table[texture[index[4]]], shading_table[texture[index[5]]],
+			shading_table[texture[index[6]]], shading_table[texture[index[7]]]);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(write + written), pixels);
+	}
+
+	return written;
+}
+
+SPAN_TARGET("sse2")
+static int horizontal_span_sse2(pixel32 *write, const pixel8 *texture, const pixel32 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	const __m128i x_shift = _mm_cvtsi32_si128(32 - texbits);
+	const __m128i y_shift = _mm_cvtsi32_si128(32 - 2 * texbits);
+	const __m128i row_mask = _mm_set1_epi32(((1 << texbits) - 1) << texbits);
+	const __m128i step_x = _mm_set1_epi32(static_cast<int>(4 * source_dx));
+	const __m128i step_y = _mm_set1_epi32(static_cast<int>(4 * source_dy));
+	__m128i x = _mm_setr_epi32(source_x, source_x + source_dx, source_x + 2 * source_dx, source_x + 3 * source_dx);
+	__m128i y = _mm_setr_epi32(source_y, source_y + source_dy, source_y + 2 * source_dy, source_y + 3 * source_dy);
+
+	int written = 0;
+	for (; written + 4 <= count; written += 4)
+	{
+		alignas(16) uint32 index[4];
+		__m128i i = _mm_add_epi32(_mm_and_si128(_mm_srl_epi32(y, y_shift), row_mask), _mm_srl_epi32(x, x_shift));
+		_mm_store_si128(reinterpret_cast<__m128i *>(index), i);
+		x = _mm_add_epi32(x, step_x);
+		y = _mm_add_epi32(y, step_y);
+
+		__m128i pixels = _mm_setr_epi32(
+			shading_table[texture[index[0]]], shading_table[texture[index[1]]],
+			shading_table[texture[index[2]]], shading_table[texture[index[3]]]);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(write + written), pixels);
+	}
+
+	return written;
+}
+
+SPAN_TARGET("avx2")
+static int horizontal_span_avx2(pixel32 *write, const pixel8 *texture, const pixel32 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	const __m128i x_shift = _mm_cvtsi32_si128(32 - texbits);
+	const __m128i y_shift = _mm_cvtsi32_si128(32 - 2 * texbits);
+	const __m256i row_mask = _mm256_set1_epi32(((1 << texbits) - 1) << texbits);
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i step_x = _mm256_set1_epi32(static_cast<int>(8 * source_dx));
+	const __m256i step_y = _mm256_set1_epi32(static_cast<int>(8 * source_dy));
+	__m256i x = _mm256_add_epi32(_mm256_set1_epi32(source_x), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(source_dx)));
+	__m256i y = _mm256_add_epi32(_mm256_set1_epi32(source_y), _mm256_mullo_epi32(lanes, _mm256_set1_epi32(source_dy)));
+
+	int written = 0;
+	for (; written + 8 <= count; written += 8)
+	{
+		alignas(32) uint32 index[8];
+		__m256i i = _mm256_add_epi32(_mm256_and_si256(_mm256_srl_epi32(y, y_shift), row_mask), _mm256_srl_epi32(x, x_shift));
+		_mm256_store_si256(reinterpret_cast<__m256i *>(index), i);
+		x = _mm256_add_epi32(x, step_x);
+		y = _mm256_add_epi32(y, step_y);
+
+		__m256i texels = _mm256_setr_epi32(
+			texture[index[0]], texture[index[1]], texture[index[2]], texture[index[3]],
+			texture[index[4]], texture[index[5]], texture[index[6]], texture[index[7]]);
+		__m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int *>(shading_table), texels, 4);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(write + written), pixels);
+	}
+
+	return written;
+}
+
+#elif defined(SPAN_KERNELS_NEON)
+
+static inline uint32x4_t neon_lanes(uint32 start, uint32 delta)
+{
+	const uint32 lanes[4] = { start, start + delta, start + 2 * delta, start + 3 * delta };
+	return vld1q_u32(lanes);
+}
+
+static int horizontal_span_neon(pixel16 *write, const pixel8 *texture, const pixel16 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	const int32x4_t x_shift = vdupq_n_s32(-(32 - texbits));
+	const int32x4_t y_shift = vdupq_n_s32(-(32 - 2 * texbits));
+	const uint32x4_t row_mask = vdupq_n_u32(((1 << texbits) - 1) << texbits);
+	const uint32x4_t step_x = vdupq_n_u32(4 * source_dx);
+	const uint32x4_t step_y = vdupq_n_u32(4 * source_dy);
+	uint32x4_t x = neon_lanes(source_x, source_dx);
+	uint32x4_t y = neon_lanes(source_y, source_dy);
+
+	int written = 0;
+	for (; written + 8 <= count; written += 8)
+	{
+		uint32 index[8];
+		for (int half = 0; half < 2; ++half)
+		{
+			uint32x4_t i = vaddq_u32(vandq_u32(vshlq_u32(y, y_shift), row_mask), vshlq_u32(x, x_shift));
+			vst1q_u32(index + 4 * half, i);
+			x = vaddq_u32(x, step_x);
+			y = vaddq_u32(y, step_y);
+		}
+
+		const uint16 pixels[8] = {
+			shading_table[texture[index[0]]], shading_table[texture[index[1]]],
+			shading_table[texture[index[2]]], shading_table[texture[index[3]]],
+			shading_table[texture[index[4]]], shading_table[texture[index[5]]],
+			shading_table[texture[index[6]]], shading_table[texture[index[7]]] };
+		vst1q_u16(write + written, vld1q_u16(pixels));
+	}
+
+	return written;
+}
+
+static int horizontal_span_neon(pixel32 *write, const pixel8 *texture, const pixel32 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	const int32x4_t x_shift = vdupq_n_s32(-(32 - texbits));
+	const int32x4_t y_shift = vdupq_n_s32(-(32 - 2 * texbits));
+	const uint32x4_t row_mask = vdupq_n_u32(((1 << texbits) - 1) << texbits);
+	const uint32x4_t step_x = vdupq_n_u32(4 * source_dx);
+	const uint32x4_t step_y = vdupq_n_u32(4 * source_dy);
+	uint32x4_t x = neon_lanes(source_x, source_dx);
+	uint32x4_t y = neon_lanes(source_y, source_dy);
+
+	int written = 0;
+	for (; written + 4 <= count; written += 4)
+	{
+		uint32 index[4];
+		uint32x4_t i = vaddq_u32(vandq_u32(vshlq_u32(y, y_shift), row_mask), vshlq_u32(x, x_shift));
+		vst1q_u32(index, i);
+		x = vaddq_u32(x, step_x);
+		y = vaddq_u32(y, step_y);
+
+		const uint32 pixels[4] = {
+			shading_table[texture[index[0]]], shading_table[texture[index[1]]],
+			shading_table[texture[index[2]]], shading_table[texture[index[3]]] };
+		vst1q_u32(write + written, vld1q_u32(pixels));
+	}
+
+	return written;
+}
+
+#endif
+
+int texture_horizontal_span_simd(pixel16 *write, const pixel8 *texture, const pixel16 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	switch (get_span_kernel())
+	{
+#if defined(SPAN_KERNELS_X86)
+		case _span_kernel_avx2:
+		case _span_kernel_sse2:
+			return horizontal_span_sse2(write, texture, shading_table, source_x, source_y, source_dx, source_dy, count, texbits);
+#elif defined(SPAN_KERNELS_NEON)
+		case _span_kernel_neon:
+			return horizontal_span_neon(write, texture, shading_table, source_x, source_y, source_dx, source_dy, count, texbits);
+#endif
+		default:
+			return 0;
+	}
+}
+
+int texture_horizontal_span_simd(pixel32 *write, const pixel8 *texture, const pixel32 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits)
+{
+	switch (get_span_kernel())
+	{
+#if defined(SPAN_KERNELS_X86)
+		case _span_kernel_avx2:
+			return horizontal_span_avx2(write, texture, shading_table, source_x, source_y, source_dx, source_dy, count, texbits);
+		case _span_kernel_sse2:
+			return horizontal_span_sse2(write, texture, shading_table, source_x, source_y, source_dx, source_dy, count, texbits);
+#elif defined(SPAN_KERNELS_NEON)
+		case _span_kernel_neon:
+			return horizontal_span_neon(write, texture, shading_table, source_x, source_y, source_dx, source_dy, count, texbits);
+#endif
+		default:
+			return 0;
+	}
+}
+
+/* ---------- vertical columns */
+
+/* four columns share a row, so one vector holds the four texture_y values and a row of
+	pixels goes out in a single store */
+
+#if defined(SPAN_KERNELS_X86)
+
+SPAN_TARGET("sse2")
+static void vertical_columns_x4_sse2(pixel16 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel16 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4])
+{
+	const __m128i shift = _mm_cvtsi32_si128(downshift);
+	const __m128i dy = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texture_dy));
+	__m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texture_y));
+
+	for (; count > 0; --count)
+	{
+		alignas(16) uint32 index[4];
+		_mm_store_si128(reinterpret_cast<__m128i *>(index), _mm_srl_epi32(y, shift));
+		y = _mm_add_epi32(y, dy);
+
+		__m128i pixels = _mm_setr_epi16(
+			shading_table[0][read[0][index[0]]], shading_table[1][read[1][index[1]]],
+			shading_table[2][read[2][index[2]]], shading_table[3][read[3][index[3]]], 0, 0, 0, 0);
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(write), pixels);
+		write = reinterpret_cast<pixel16 *>(reinterpret_cast<byte *>(write) + bytes_per_row);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(texture_y), y);
+}
+
+SPAN_TARGET("sse2")
+static void vertical_columns_x4_sse2(pixel32 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel32 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4])
+{
+	const __m128i shift = _mm_cvtsi32_si128(downshift);
+	const __m128i dy = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texture_dy));
+	__m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(texture_y));
+
+	for (; count > 0; --count)
+	{
+		alignas(16) uint32 index[4];
+		_mm_store_si128(reinterpret_cast<__m128i *>(index), _mm_srl_epi32(y, shift));
+		y = _mm_add_epi32(y, dy);
+
+		__m128i pixels = _mm_setr_epi32(
+			shading_table[0][read[0][index[0]]], shading_table[1][read[1][index[1]]],
+			shading_table[2][read[2][index[2]]], shading_table[3][read[3][index[3]]]);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(write), pixels);
+		write = reinterpret_cast<pixel32 *>(reinterpret_cast<byte *>(write) + bytes_per_row);
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(texture_y), y);
+}
+
+#elif defined(SPAN_KERNELS_NEON)
+
+static void vertical_columns_x4_neon(pixel16 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel16 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4])
+{
+	const int32x4_t shift = vdupq_n_s32(-downshift);
+	const uint32x4_t dy = vld1q_u32(texture_dy);
+	uint32x4_t y = vld1q_u32(texture_y);
+
+	for (; count > 0; --count)
+	{
+		uint32 index[4];
+		vst1q_u32(index, vshlq_u32(y, shift));
+		y = vaddq_u32(y, dy);
+
+		const uint16 pixels[4] = {
+			shading_table[0][read[0][index[0]]], shading_table[1][read[1][index[1]]],
+			shading_table[2][read[2][index[2]]], shading_table[3][read[3][index[3]]] };
+		vst1_u16(write, vld1_u16(pixels));
+		write = reinterpret_cast<pixel16 *>(reinterpret_cast<byte *>(write) + bytes_per_row);
+	}
+
+	vst1q_u32(texture_y, y);
+}
+
+static void vertical_columns_x4_neon(pixel32 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel32 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4])
+{
+	const int32x4_t shift = vdupq_n_s32(-downshift);
+	const uint32x4_t dy = vld1q_u32(texture_dy);
+	uint32x4_t y = vld1q_u32(texture_y);
+
+	for (; count > 0; --count)
+	{
+		uint32 index[4];
+		vst1q_u32(index, vshlq_u32(y, shift));
+		y = vaddq_u32(y, dy);
+
+		const uint32 pixels[4] = {
+			shading_table[0][read[0][index[0]]], shading_table[1][read[1][index[1]]],
+			shading_table[2][read[2][index[2]]], shading_table[3][read[3][index[3]]] };
+		vst1q_u32(write, vld1q_u32(pixels));
+		write = reinterpret_cast<pixel32 *>(reinterpret_cast<byte *>(write) + bytes_per_row);
+	}
+
+	vst1q_u32(texture_y, y);
+}
+
+#endif
+
+bool texture_vertical_columns_x4_simd(pixel16 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel16 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4])
+{
+	switch (get_span_kernel())
+	{
+#if defined(SPAN_KERNELS_X86)
+		case _span_kernel_avx2:
+		case _span_kernel_sse2:
+			vertical_columns_x4_sse2(write, bytes_per_row, count, downshift, read, shading_table, texture_y, texture_dy);
+			return true;
+#elif defined(SPAN_KERNELS_NEON)
+		case _span_kernel_neon:
+			vertical_columns_x4_neon(write, bytes_per_row, count, downshift, read, shading_table, texture_y, texture_dy);
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+bool texture_vertical_columns_x4_simd(pixel32 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel32 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4])
+{
+	switch (get_span_kernel())
+	{
+#if defined(SPAN_KERNELS_X86)
+		case _span_kernel_avx2:
+		case _span_kernel_sse2:
+			vertical_columns_x4_sse2(write, bytes_per_row, count, downshift, read, shading_table, texture_y, texture_dy);
+			return true;
+#elif defined(SPAN_KERNELS_NEON)
+		case _span_kernel_neon:
+			vertical_columns_x4_neon(write, bytes_per_row, count, downshift, read, shading_table, texture_y, texture_dy);
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
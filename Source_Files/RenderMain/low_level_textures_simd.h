@@ -0,0 +1,71 @@
+#ifndef __LOW_LEVEL_TEXTURES_SIMD_H
+#define __LOW_LEVEL_TEXTURES_SIMD_H
+
+/*
+LOW_LEVEL_TEXTURES_SIMD.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+Oct 16, 2026:
+	Vector kernels for the opaque spans of low_level_textures.h; they compute texture
+	coordinates several pixels at a time and produce exactly the pixels the scalar loops do.
+	The kernel set is picked once from the CPU's features.
+*/
+
+#include "cseries.h"
+
+enum /* span kernels */
+{
+	_span_kernel_scalar,
+	_span_kernel_sse2,
+	_span_kernel_avx2,
+	_span_kernel_neon,
+	NUMBER_OF_SPAN_KERNELS
+};
+
+short get_span_kernel(void);
+/* for tests: false (and no change) if this CPU can't run the kernel */
+bool set_span_kernel(short kernel);
+
+/* opaque horizontal (floor/ceiling) span; writes a multiple of the vector width and returns
+	how many pixels it wrote, leaving the rest to the scalar loop */
+int texture_horizontal_span_simd(pixel16 *write, const pixel8 *texture, const pixel16 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits);
+int texture_horizontal_span_simd(pixel32 *write, const pixel8 *texture, const pixel32 *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits);
+
+inline int texture_horizontal_span_simd(pixel8 *, const pixel8 *, const pixel8 *,
+	uint32, uint32, uint32, uint32, int, int)
+{
+	return 0;
+}
+
+/* the "parallel map (x4)" part of an opaque wall: count rows of four adjacent columns, each
+	with its own texture and shading table; advances texture_y[]. returns false (and does
+	nothing) if no vector kernel is available */
+bool texture_vertical_columns_x4_simd(pixel16 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel16 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4]);
+bool texture_vertical_columns_x4_simd(pixel32 *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], pixel32 * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4]);
+
+inline bool texture_vertical_columns_x4_simd(pixel8 *, int, int, int,
+	pixel8 * const [4], pixel8 * const [4], uint32 [4], const uint32 [4])
+{
+	return false;
+}
+
+#endif
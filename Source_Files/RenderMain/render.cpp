@@ -195,6 +195,9 @@ Nov 29, 2000 (Loren Petrich):
 
 Jan 17, 2001 (Loren Petrich):
 	Added vertical flipping
+
+Oct 16, 2026:
+	Phases of render_view() are timed by the tick profiler
 */
 
 
@@ -241,6 +244,7 @@ extern WindowPtr screen_window;
 #endif
 #include "preferences.h"
 #include "screen.h"
+#include "TickProfiler.h"
 
 /* use native alignment */
 #if defined (powerc) || defined (__powerc)
@@ -444,7 +448,7 @@ void render_view(
 		// LP: now from the visibility-tree class
 		/* build the render tree, regardless of map mode, so the automap updates while active */
 		RenderVisTree.view = view;
-		RenderVisTree.build_render_tree();
+		PROFILE_CALL(_profile_render_visibility, RenderVisTree.build_render_tree());
 		
 		/* do something complicated and difficult to explain */
 		if (!view->overhead_map_active || map_is_translucent())
@@ -453,12 +457,15 @@ void render_view(
 			/* sort the render tree (so we have a depth-ordering of polygons) and accumulate
 				clipping information for each polygon */
 			RenderSortPoly.view = view;
-			RenderSortPoly.sort_render_tree();
+			PROFILE_CALL(_profile_render_sort, RenderSortPoly.sort_render_tree());
 			
 			// LP: now from the object-placement class
 			/* build the render object list by looking at the sorted render tree */
 			RenderPlaceObjs.view = view;
-			RenderPlaceObjs.build_render_object_list();
+			PROFILE_CALL(_profile_render_objects, RenderPlaceObjs.build_render_object_list());
+			
+			// everything from here to RasPtr->End() counts as rasterizing
+			ProfileScope rasterize_profile(_profile_render_rasterize);
 			
 			// LP addition: set the current rasterizer to whichever is appropriate here
 			RasterizerClass *RasPtr;
@@ -506,7 +513,7 @@ void render_view(
 		if (view->overhead_map_active)
 		{
 			/* if the overhead map is active, render it */
-			render_overhead_map(view);
+			PROFILE_CALL(_profile_render_overhead_map, render_overhead_map(view));
 		}
 	}
 }
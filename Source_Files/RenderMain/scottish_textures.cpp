@@ -96,6 +96,11 @@ Aug 9, 2000 (Loren Petrich):
 
 May 16, 2002 (Woody Zenfell):
     MSVC doesn't like "void f();  void g() { return f(); }"... fixed.
+
+Oct 16, 2026:
+	The mappers draw only inside a band of columns, with their own scratch tables, so that
+	End() can replay a recorded frame one band per thread.  A band changes where lines and
+	columns start, never how they are stepped, so the pixels are the same either way.
 */
 
 /*
@@ -120,6 +125,7 @@ not only that, but texture_horizontal_polygon() is actually faster than texture_
 
 #include "preferences.h"
 #include "SW_Texture_Extras.h"
+#include "WorkerPool.h"
 
 
 /* ---------- constants */
@@ -184,7 +190,7 @@ static void *precalculation_table = NULL;
 
 template<int TEXBITS> static void _pretexture_horizontal_polygon_lines(struct polygon_definition *polygon,
 	struct bitmap_definition *screen, struct view_data *view, struct _horizontal_polygon_line_data *data,
-	short y0, short *x0_table, short *x1_table, short line_count);
+	short y0, short *x0_table, short *x1_table, short line_count, short left, short right);
 
 template<int TEXBITS> static void _pretexture_vertical_polygon_lines(struct polygon_definition *polygon,
 	struct bitmap_definition *screen, struct view_data *view, struct _vertical_polygon_data *data,
@@ -195,7 +201,10 @@ static short *build_y_table(short *table, short x0, short y0, short x1, short y1
 
 static void _prelandscape_horizontal_polygon_lines(struct polygon_definition *polygon,
 	struct bitmap_definition *screen, struct view_data *view, struct _horizontal_polygon_line_data *data,
-	short y0, short *x0_table, short *x1_table, short line_count);
+	short y0, short *x0_table, short *x1_table, short line_count, short left, short right);
+
+static void clip_horizontal_polygon_line(struct _horizontal_polygon_line_data *data,
+	short *x0, short *x1, short left, short right, bool step_source_y);
 
 /* ---------- code */
 
@@ -204,14 +213,185 @@ static void _prelandscape_horizontal_polygon_lines(struct polygon_definition *po
 void allocate_texture_tables(
 	void)
 {
+	if (scratch_table0) return;
+	
 	scratch_table0= new short[MAXIMUM_SCRATCH_TABLE_ENTRIES];
 	scratch_table1= new short[MAXIMUM_SCRATCH_TABLE_ENTRIES];
 	precalculation_table= (void*)new char[MAXIMUM_PRECALCULATION_TABLE_ENTRY_SIZE*MAXIMUM_SCRATCH_TABLE_ENTRIES];
 	fc_assert(scratch_table0&&scratch_table1&&precalculation_table);
 }
 
+static sw_raster_band screen_band(
+	struct bitmap_definition *screen)
+{
+	sw_raster_band band= { 0, screen->width, scratch_table0, scratch_table1, precalculation_table };
+	
+	return band;
+}
+
+Rasterizer_SW_Class::Rasterizer_SW_Class() :
+	view(NULL),
+	screen(NULL),
+	recording(false),
+	recorded_static(false),
+	pool_size(0)
+{
+}
+
+Rasterizer_SW_Class::~Rasterizer_SW_Class()
+{
+}
+
+/* with more than one rendering thread, hold on to everything drawn until End() */
+void Rasterizer_SW_Class::Begin()
+{
+	recording= graphics_preferences->software_rendering_threads>1;
+	recorded_static= false;
+	
+	commands.clear();
+	polygons.clear();
+	rectangles.clear();
+}
+
+void Rasterizer_SW_Class::End()
+{
+	if (!recording) return;
+	recording= false;
+	
+	int thread_count= graphics_preferences->software_rendering_threads;
+	
+	/* static is noise from one seed, drawn in order; only one thread can reproduce it */
+	if (recorded_static || thread_count<2)
+	{
+		sw_raster_band band= screen_band(screen);
+		replay_commands(band);
+		return;
+	}
+	
+	if (pool_size!=thread_count)
+	{
+		pool.reset();
+		pool.reset(new WorkerPool(thread_count));
+		pool_size= thread_count;
+		
+		worker_scratch_tables.resize(pool->thread_count());
+		worker_precalculation_tables.resize(pool->thread_count());
+		for (int i= 0; i<pool->thread_count(); ++i)
+		{
+			if (!worker_scratch_tables[i])
+			{
+				worker_scratch_tables[i].reset(new short[2*MAXIMUM_SCRATCH_TABLE_ENTRIES]);
+				worker_precalculation_tables[i].reset(new char[MAXIMUM_PRECALCULATION_TABLE_ENTRY_SIZE*MAXIMUM_SCRATCH_TABLE_ENTRIES]);
+			}
+		}
+	}
+	
+	/* several bands per thread, so one busy part of the screen doesn't leave the other
+		threads waiting; widths are multiples of 16 so the four-column wall mapper keeps its
+		alignment and neighbouring bands rarely share a cache line */
+	int band_count= 4*pool->thread_count();
+	short band_width= (((screen->width+band_count-1)/band_count)+15)&~15;
+	band_count= (screen->width+band_width-1)/band_width;
+	
+	pool->run(band_count, [this, band_width](int index, int worker) {
+		sw_raster_band band;
+		
+		band.left= index*band_width;
+		band.right= MIN(band.left+band_width, screen->width);
+		band.scratch_table0= worker_scratch_tables[worker].get();
+		band.scratch_table1= band.scratch_table0+MAXIMUM_SCRATCH_TABLE_ENTRIES;
+		band.precalculation_table= worker_precalculation_tables[worker].get();
+		
+		replay_commands(band);
+	});
+}
+
+void Rasterizer_SW_Class::replay_commands(sw_raster_band& band)
+{
+	for (const raster_command& command : commands)
+	{
+		switch (command.type)
+		{
+			case _horizontal_polygon_command:
+				draw_horizontal_polygon(polygons[command.index], band);
+				break;
+			
+			case _vertical_polygon_command:
+				draw_vertical_polygon(polygons[command.index], band);
+				break;
+			
+			case _rectangle_command:
+			{
+				/* the rectangle mapper folds the screen and band into the definition's clip */
+				rectangle_definition rectangle= rectangles[command.index];
+				draw_rectangle(rectangle, band);
+				break;
+			}
+			
+			default:
+				assert(false);
+				break;
+		}
+	}
+}
+
 void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& textured_polygon)
 {
+	if (recording)
+	{
+		raster_command command= { _horizontal_polygon_command, static_cast<int32>(polygons.size()) };
+		
+		commands.push_back(command);
+		polygons.push_back(textured_polygon);
+		if (textured_polygon.transfer_mode==_static_transfer) recorded_static= true;
+	}
+	else
+	{
+		sw_raster_band band= screen_band(screen);
+		draw_horizontal_polygon(textured_polygon, band);
+	}
+}
+
+void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_polygon)
+{
+	if (recording)
+	{
+		raster_command command= { _vertical_polygon_command, static_cast<int32>(polygons.size()) };
+		
+		commands.push_back(command);
+		polygons.push_back(textured_polygon);
+		if (textured_polygon.transfer_mode==_static_transfer) recorded_static= true;
+	}
+	else
+	{
+		sw_raster_band band= screen_band(screen);
+		draw_vertical_polygon(textured_polygon, band);
+	}
+}
+
+void Rasterizer_SW_Class::texture_rectangle(rectangle_definition& textured_rectangle)
+{
+	if (recording)
+	{
+		raster_command command= { _rectangle_command, static_cast<int32>(rectangles.size()) };
+		
+		commands.push_back(command);
+		rectangles.push_back(textured_rectangle);
+		if (textured_rectangle.transfer_mode==_static_transfer) recorded_static= true;
+	}
+	else
+	{
+		sw_raster_band band= screen_band(screen);
+		draw_rectangle(textured_rectangle, band);
+	}
+}
+
+void Rasterizer_SW_Class::draw_horizontal_polygon(polygon_definition& textured_polygon, sw_raster_band& band)
+{
+	/* this band's scratch memory stands in for the globals */
+	short *scratch_table0= band.scratch_table0, *scratch_table1= band.scratch_table1;
+	void *precalculation_table= band.precalculation_table;
+	
 	polygon_definition *polygon = &textured_polygon;	// Reference to pointer
 	short vertex, highest_vertex, lowest_vertex;
 	point2d *vertices= polygon->vertices;
@@ -220,7 +400,7 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
 
 	/* if we get static, tinted or landscaped transfer modes punt to the vertical polygon mapper */
 	if (polygon->transfer_mode == _static_transfer) {
-		texture_vertical_polygon(textured_polygon);
+		draw_vertical_polygon(textured_polygon, band);
 		return;
 	}
 
@@ -308,13 +488,13 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
 		switch (polygon->transfer_mode)
 		{
 			case _textured_transfer:
-				TEXBITS_DISPATCH(polygon->texture, _pretexture_horizontal_polygon_lines, (polygon, screen, view, (struct _horizontal_polygon_line_data *)precalculation_table, vertices[highest_vertex].y, left_table, right_table, aggregate_total_line_count));
+				TEXBITS_DISPATCH(polygon->texture, _pretexture_horizontal_polygon_lines, (polygon, screen, view, (struct _horizontal_polygon_line_data *)precalculation_table, vertices[highest_vertex].y, left_table, right_table, aggregate_total_line_count, band.left, band.right));
 				break;
 
 			case _big_landscaped_transfer:
 				_prelandscape_horizontal_polygon_lines(polygon, screen, view, (struct _horizontal_polygon_line_data *)precalculation_table,
 					vertices[highest_vertex].y, left_table, right_table,
-					aggregate_total_line_count);
+					aggregate_total_line_count, band.left, band.right);
 				break;
 			
 			default:
@@ -425,8 +605,12 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
 	}
 }
 
-void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_polygon)
+void Rasterizer_SW_Class::draw_vertical_polygon(polygon_definition& textured_polygon, sw_raster_band& band)
 {
+	/* this band's scratch memory stands in for the globals */
+	short *scratch_table0= band.scratch_table0, *scratch_table1= band.scratch_table1;
+	void *precalculation_table= band.precalculation_table;
+	
 	polygon_definition *polygon = &textured_polygon;	// Reference to pointer
 	short vertex, highest_vertex, lowest_vertex;
 	point2d *vertices= polygon->vertices;
@@ -434,7 +618,7 @@ void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_
 	fc_assert(polygon->vertex_count>=MINIMUM_VERTICES_PER_SCREEN_POLYGON&&polygon->vertex_count<MAXIMUM_VERTICES_PER_SCREEN_POLYGON);
 
     if (polygon->transfer_mode == _big_landscaped_transfer) {
-        texture_horizontal_polygon(textured_polygon);
+        draw_horizontal_polygon(textured_polygon, band);
         return;
     }
      
@@ -520,11 +704,24 @@ void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_
 		fc_assert(aggregate_right_line_count==aggregate_total_line_count);
 		fc_assert(aggregate_left_line_count==aggregate_total_line_count);
 
+		/* keep only the columns inside this band; each column is precalculated from its own
+			x-coordinate, so skipping some doesn't change the others */
+		short x0= vertices[highest_vertex].x;
+		if (x0<band.left)
+		{
+			short delta= MIN(band.left-x0, aggregate_total_line_count);
+			
+			left_table+= delta, right_table+= delta;
+			x0+= delta, aggregate_total_line_count-= delta;
+		}
+		if (x0+aggregate_total_line_count>band.right) aggregate_total_line_count= MAX(band.right-x0, 0);
+		if (!aggregate_total_line_count) return;
+
 		/* precalculate mode-specific data */
 
           if ((polygon->transfer_mode == _textured_transfer) || (polygon->transfer_mode == _static_transfer))
           {
-			  TEXBITS_DISPATCH(polygon->texture, _pretexture_vertical_polygon_lines, (polygon, screen, view, (struct _vertical_polygon_data *)precalculation_table, vertices[highest_vertex].x, left_table, right_table, aggregate_total_line_count));
+			  TEXBITS_DISPATCH(polygon->texture, _pretexture_vertical_polygon_lines, (polygon, screen, view, (struct _vertical_polygon_data *)precalculation_table, x0, left_table, right_table, aggregate_total_line_count));
           }
           else VHALT_DEBUG(csprintf(temporary, "vertical_polygons dont support mode #%d", polygon->transfer_mode));
           
@@ -654,15 +851,19 @@ void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_
 	}
 }
 
-void Rasterizer_SW_Class::texture_rectangle(rectangle_definition& textured_rectangle)
+void Rasterizer_SW_Class::draw_rectangle(rectangle_definition& textured_rectangle, sw_raster_band& band)
 {
+	/* this band's scratch memory stands in for the globals */
+	short *scratch_table0= band.scratch_table0, *scratch_table1= band.scratch_table1;
+	void *precalculation_table= band.precalculation_table;
+	
 	rectangle_definition *rectangle = &textured_rectangle;	// Reference to pointer
 
 	if (rectangle->x0<rectangle->x1 && rectangle->y0<rectangle->y1)
 	{
-		/* subsume screen boundaries into clipping parameters */
-		if (rectangle->clip_left<0) rectangle->clip_left= 0;
-		if (rectangle->clip_right>screen->width) rectangle->clip_right= screen->width;
+		/* subsume screen (band) boundaries into clipping parameters */
+		if (rectangle->clip_left<band.left) rectangle->clip_left= band.left;
+		if (rectangle->clip_right>band.right) rectangle->clip_right= band.right;
 		if (rectangle->clip_top<0) rectangle->clip_top= 0;
 		if (rectangle->clip_bottom>screen->height) rectangle->clip_bottom= screen->height;
 	
@@ -1018,7 +1219,9 @@ template<int TEXBITS> static void _pretexture_horizontal_polygon_lines(
 	short y0,
 	short *x0_table,
 	short *x1_table,
-	short line_count)
+	short line_count,
+	short left,
+	short right)
 {
 	int32 hcosine, dhcosine;
 	int32 hsine, dhsine;
@@ -1045,7 +1248,16 @@ template<int TEXBITS> static void _pretexture_horizontal_polygon_lines(
 		int32 depth;
 		// world_distance depth;
 		short screen_x, screen_y;
-		short x0= *x0_table++;
+		short x0= *x0_table;
+		
+		/* lines outside this band are left empty, and cost no divides */
+		if (*x1_table<=left || x0>=right)
+		{
+			*x1_table++= *x0_table++;
+			data++;
+			y0++;
+			continue;
+		}
 		
 		/* calculate screen_x,screen_y */
 		screen_x= x0-view->half_screen_width;
@@ -1091,6 +1303,8 @@ template<int TEXBITS> static void _pretexture_horizontal_polygon_lines(
 			calculate_shading_table(data->shading_table, view, polygon->shading_tables, (short)MIN(depth, SHRT_MAX), polygon->ambient_shade);
 		}
 		
+		clip_horizontal_polygon_line(data, x0_table++, x1_table++, left, right, true);
+		
 		data++;
 		y0++;
 	}
@@ -1107,7 +1321,9 @@ static void _prelandscape_horizontal_polygon_lines(
 	short y0,
 	short *x0_table,
 	short *x1_table,
-	short line_count)
+	short line_count,
+	short left,
+	short right)
 {
 	// LP change: made this more general:
 	short landscape_width_bits= NextLowerExponent(polygon->texture->height);
@@ -1149,7 +1365,7 @@ static void _prelandscape_horizontal_polygon_lines(
 	y0-= view->half_screen_height + view->dtanpitch; /* back to virtual screen coordinates */
 	while ((line_count-= 1)>=0)
 	{
-		short x0= *x0_table++;
+		short x0= *x0_table;
 		
 		data->shading_table= shading_table;
 		// LP change: using vertical pixel delta
@@ -1164,11 +1380,36 @@ static void _prelandscape_horizontal_polygon_lines(
 		data->source_x= (first_horizontal_pixel + x0*horizontal_pixel_delta)<<landscape_free_bits;
 		data->source_dx= horizontal_pixel_delta<<landscape_free_bits;
 		
+		/* landscape lines keep source_y as their row */
+		clip_horizontal_polygon_line(data, x0_table++, x1_table++, left, right, false);
+		
 		data+= 1;
 		y0+= 1;
 	}
 }
 
+/* trims a precalculated line to the columns [left, right), stepping its texture coordinates
+	exactly as the line mapper would have over the skipped pixels */
+static void clip_horizontal_polygon_line(
+	struct _horizontal_polygon_line_data *data,
+	short *x0,
+	short *x1,
+	short left,
+	short right,
+	bool step_source_y)
+{
+	if (*x0<left)
+	{
+		uint32 delta= left-*x0;
+		
+		data->source_x+= delta*data->source_dx;
+		if (step_source_y) data->source_y+= delta*data->source_dy;
+		*x0= left;
+	}
+	if (*x1>right) *x1= right;
+	if (*x1<*x0) *x1= *x0;
+}
+
 /* y0<y1; this is for vertical polygons */
 static short *build_x_table(
 	short *table,
@@ -1491,14 +1491,18 @@ void load_replacement_collections()
 {
 	struct collection_header *header;
 	short collection_index;
+	std::vector<short> collections;
 
 	for (collection_index= 0, header= collection_headers; collection_index < MAXIMUM_COLLECTIONS; ++collection_index, ++header)
 	{
 		if (collection_loaded(header))
 		{
-			OGL_LoadModelsImages(collection_index);
+			collections.push_back(collection_index);
 		}
 	}
+
+	/* all at once, so the loading threads can share out the work of every collection */
+	OGL_LoadModelsImages(collections);
 }
 
 #endif
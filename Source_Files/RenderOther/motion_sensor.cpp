@@ -36,6 +36,10 @@ Mar 23, 2000 (Loren Petrich):
 Sep 2, 2000 (Loren Petrich):
 	Idiot-proofed the shapes display, since the shape accessor
 	now returns NULL pointers for nonexistent bitmaps.
+
+Oct 16, 2026:
+	motion_sensor_scan() asks the polygon grid for nearby monsters instead of
+	checking every monster slot
 */
 
 #include "cseries.h"
@@ -204,6 +208,7 @@ static shape_descriptor alien_shapes, friendly_shapes, enemy_shapes;
 
 static bool motion_sensor_changed;
 static int32 ticks_since_last_update, ticks_since_last_rescan;
+static std::vector<short> nearby_monster_indexes;
 
 /* ---------- private code */
 
@@ -301,19 +306,20 @@ void motion_sensor_scan(void)
 		visible monsters within our range */
 	if ((--ticks_since_last_rescan) < 0)
 	{
-		struct monster_data *monster;
-		short monster_index;
-		
-		for (monster_index=0,monster=monsters;monster_index<MAXIMUM_MONSTERS_PER_MAP;++monster,++monster_index)
+		/* in monster index order, so entities are added just as they were by scanning every slot */
+		find_monsters_in_range((world_point2d *) &owner_object->location, MOTION_SENSOR_RANGE, nearby_monster_indexes);
+		for (size_t i= 0; i<nearby_monster_indexes.size(); ++i)
 		{
-			if (SLOT_IS_USED(monster)&&(MONSTER_IS_PLAYER(monster)||MONSTER_IS_ACTIVE(monster)))
+			struct monster_data *monster= get_monster_data(nearby_monster_indexes[i]);
+			
+			if (MONSTER_IS_PLAYER(monster)||MONSTER_IS_ACTIVE(monster))
 			{
 				struct object_data *object= get_object_data(monster->object_index);
 				world_distance distance= guess_distance2d((world_point2d *) &object->location, (world_point2d *) &owner_object->location);
 				
 				if (distance<MOTION_SENSOR_RANGE && OBJECT_IS_VISIBLE_TO_MOTION_SENSOR(object))
 				{
-//					dprintf("found valid monster #%d", monster_index);
+//					dprintf("found valid monster #%d", object->permutation);
 					find_or_add_motion_sensor_entity(object->permutation);
 					motion_sensor_changed = true;
 				}
@@ -69,6 +69,7 @@
 #include "HUDRenderer_Lua.h"
 #include "Movie.h"
 #include "shell_options.h"
+#include "screen_present.h"
 
 #include <algorithm>
 
@@ -1675,6 +1676,30 @@ static inline bool pixel_formats_equal(SDL_PixelFormat* a, SDL_PixelFormat* b)
 
 static void update_screen(SDL_Rect &source, SDL_Rect &destination, bool hi_rez, bool every_other_line)
 {
+	// Gamma, doubling and conversion in one pass where the pixel formats allow it
+	if (bit_depth > 8)
+	{
+		bool gamma = !using_default_gamma;
+		bool overlay_active = world_view->overhead_map_active && map_is_translucent();
+
+		if (SDL_MUSTLOCK(main_surface))
+		{
+			if (SDL_LockSurface(main_surface) < 0) return;
+		}
+
+		bool presented = present_world_pixels(world_pixels, main_surface, destination, !hi_rez, every_other_line,
+			overlay_active, SDL_MapRGB(main_surface->format, 0, 0, 0),
+			gamma ? current_gamma_r : NULL, gamma ? current_gamma_g : NULL, gamma ? current_gamma_b : NULL,
+			graphics_preferences->software_rendering_threads);
+
+		if (SDL_MUSTLOCK(main_surface)) {
+			SDL_UnlockSurface(main_surface);
+		}
+
+		if (presented)
+			return;
+	}
+
 	SDL_Surface *s = world_pixels;
 	if (!using_default_gamma && bit_depth > 8) {
 		apply_gamma(world_pixels, world_pixels_corrected);
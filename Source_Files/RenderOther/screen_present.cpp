@@ -0,0 +1,374 @@
+/*
+SCREEN_PRESENT.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+Oct 16, 2026:
+	Each source channel value maps through a table straight to its bits in the destination
+	pixel, with gamma and any change of format already applied, so a pixel costs three
+	lookups instead of a switch, masks and shifts on the way in and again on the way out.
+	The tables are rebuilt only when the formats or gamma change.  Rows are split into bands
+	for the worker threads, and doubling without gamma or conversion is a vector copy.  (AVX2
+	gathers for the lookups measured no faster than the scalar loop, so there are none.)
+*/
+
+#include "cseries.h"
+#include "screen_present.h"
+#include "low_level_textures_simd.h"
+#include "WorkerPool.h"
+
+#include <string.h>
+#include <memory>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PRESENT_KERNELS_X86
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define PRESENT_TARGET(isa) __attribute__((target(isa)))
+#else
+#define PRESENT_TARGET(isa)
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define PRESENT_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+/* ---------- tables */
+
+struct present_tables
+{
+	/* what they were built for */
+	uint8 src_bytes_per_pixel, dst_bytes_per_pixel;
+	uint32 src_masks[3], dst_masks[3];
+	bool gamma;
+	uint16 gamma_tables[3][256];
+
+	/* pixels are copied as they are */
+	bool identity;
+
+	uint32 src_channel_masks[3];
+	uint8 src_channel_shifts[3];
+	uint32 channel_tables[3][256]; /* destination bits for each source channel value */
+};
+
+static present_tables tables;
+static bool tables_valid= false;
+
+static bool format_is_supported(const SDL_PixelFormat *format)
+{
+	return (format->BytesPerPixel==2 || format->BytesPerPixel==4) && !format->Amask &&
+		format->Rloss<=8 && format->Gloss<=8 && format->Bloss<=8;
+}
+
+/* the value the old chain left in the destination for a source channel value: gamma corrected
+	into a pixel of the source's format, then converted the way SDL_GetRGB() and SDL_MapRGB()
+	(and so the blitters) do */
+static uint32 build_channel_entry(int channel, uint32 value, const SDL_PixelFormat *src,
+	const SDL_PixelFormat *dst, const uint16 *gamma)
+{
+	static const uint8 SDL_PixelFormat::*losses[3]= { &SDL_PixelFormat::Rloss, &SDL_PixelFormat::Gloss, &SDL_PixelFormat::Bloss };
+	static const uint8 SDL_PixelFormat::*shifts[3]= { &SDL_PixelFormat::Rshift, &SDL_PixelFormat::Gshift, &SDL_PixelFormat::Bshift };
+	static const uint32 SDL_PixelFormat::*masks[3]= { &SDL_PixelFormat::Rmask, &SDL_PixelFormat::Gmask, &SDL_PixelFormat::Bmask };
+	uint8 loss= src->*losses[channel];
+
+	if (gamma)
+	{
+		uint8 corrected= gamma[static_cast<uint8>(value << loss)] >> 8;
+		value= corrected >> loss;
+	}
+
+	uint8 rgb[3]= { 0, 0, 0 };
+	SDL_GetRGB((value << (src->*shifts[channel])) & (src->*masks[channel]), src, &rgb[0], &rgb[1], &rgb[2]);
+	return SDL_MapRGB(dst, channel==0 ? rgb[0] : 0, channel==1 ? rgb[1] : 0, channel==2 ? rgb[2] : 0);
+}
+
+static void update_tables(const SDL_PixelFormat *src, const SDL_PixelFormat *dst,
+	const uint16 *gamma_r, const uint16 *gamma_g, const uint16 *gamma_b)
+{
+	const uint16 *gammas[3]= { gamma_r, gamma_g, gamma_b };
+	uint32 src_masks[3]= { src->Rmask, src->Gmask, src->Bmask };
+	uint32 dst_masks[3]= { dst->Rmask, dst->Gmask, dst->Bmask };
+	uint8 src_shifts[3]= { src->Rshift, src->Gshift, src->Bshift };
+	bool gamma= gamma_r && gamma_g && gamma_b;
+
+	if (tables_valid &&
+		tables.src_bytes_per_pixel==src->BytesPerPixel && tables.dst_bytes_per_pixel==dst->BytesPerPixel &&
+		!memcmp(tables.src_masks, src_masks, sizeof(src_masks)) && !memcmp(tables.dst_masks, dst_masks, sizeof(dst_masks)) &&
+		tables.gamma==gamma &&
+		(!gamma || (!memcmp(tables.gamma_tables[0], gamma_r, sizeof(tables.gamma_tables[0])) &&
+			!memcmp(tables.gamma_tables[1], gamma_g, sizeof(tables.gamma_tables[1])) &&
+			!memcmp(tables.gamma_tables[2], gamma_b, sizeof(tables.gamma_tables[2])))))
+	{
+		return;
+	}
+
+	tables.src_bytes_per_pixel= src->BytesPerPixel;
+	tables.dst_bytes_per_pixel= dst->BytesPerPixel;
+	memcpy(tables.src_masks, src_masks, sizeof(src_masks));
+	memcpy(tables.dst_masks, dst_masks, sizeof(dst_masks));
+	tables.gamma= gamma;
+	tables.identity= !gamma && src->BytesPerPixel==dst->BytesPerPixel && !memcmp(src_masks, dst_masks, sizeof(src_masks));
+
+	for (int channel= 0; channel<3; ++channel)
+	{
+		if (gamma) memcpy(tables.gamma_tables[channel], gammas[channel], sizeof(tables.gamma_tables[channel]));
+		tables.src_channel_masks[channel]= src_masks[channel];
+		tables.src_channel_shifts[channel]= src_shifts[channel];
+
+		for (uint32 value= 0; value<256; ++value)
+		{
+			tables.channel_tables[channel][value]= build_channel_entry(channel, value, src, dst, gamma ? gammas[channel] : NULL);
+		}
+	}
+
+	tables_valid= true;
+}
+
+/* ---------- rows */
+
+template <class S, class D>
+static inline D convert_pixel(S pixel)
+{
+	return static_cast<D>(
+		tables.channel_tables[0][(pixel & tables.src_channel_masks[0]) >> tables.src_channel_shifts[0]] |
+		tables.channel_tables[1][(pixel & tables.src_channel_masks[1]) >> tables.src_channel_shifts[1]] |
+		tables.channel_tables[2][(pixel & tables.src_channel_masks[2]) >> tables.src_channel_shifts[2]]);
+}
+
+/* these return how many source pixels they did, leaving the rest to the scalar loops */
+
+#if defined(PRESENT_KERNELS_X86)
+
+PRESENT_TARGET("sse2")
+static int double_row_sse2(const pixel32 *src, pixel32 *dst, int width)
+{
+	int x= 0;
+	for (; x+4<=width; x+= 4)
+	{
+		__m128i pixels= _mm_loadu_si128(reinterpret_cast<const __m128i *>(src+x));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+2*x), _mm_unpacklo_epi32(pixels, pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+2*x+4), _mm_unpackhi_epi32(pixels, pixels));
+	}
+	return x;
+}
+
+PRESENT_TARGET("sse2")
+static int double_row_sse2(const pixel16 *src, pixel16 *dst, int width)
+{
+	int x= 0;
+	for (; x+8<=width; x+= 8)
+	{
+		__m128i pixels= _mm_loadu_si128(reinterpret_cast<const __m128i *>(src+x));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+2*x), _mm_unpacklo_epi16(pixels, pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst+2*x+8), _mm_unpackhi_epi16(pixels, pixels));
+	}
+	return x;
+}
+
+#elif defined(PRESENT_KERNELS_NEON)
+
+static int double_row_neon(const pixel32 *src, pixel32 *dst, int width)
+{
+	int x= 0;
+	for (; x+4<=width; x+= 4)
+	{
+		uint32x4_t pixels= vld1q_u32(src+x);
+		uint32x4x2_t doubled= vzipq_u32(pixels, pixels);
+		vst1q_u32(dst+2*x, doubled.val[0]);
+		vst1q_u32(dst+2*x+4, doubled.val[1]);
+	}
+	return x;
+}
+
+static int double_row_neon(const pixel16 *src, pixel16 *dst, int width)
+{
+	int x= 0;
+	for (; x+8<=width; x+= 8)
+	{
+		uint16x8_t pixels= vld1q_u16(src+x);
+		uint16x8x2_t doubled= vzipq_u16(pixels, pixels);
+		vst1q_u16(dst+2*x, doubled.val[0]);
+		vst1q_u16(dst+2*x+8, doubled.val[1]);
+	}
+	return x;
+}
+
+#endif
+
+template <class T>
+static int double_row_simd(const T *src, T *dst, int width)
+{
+#if defined(PRESENT_KERNELS_X86)
+	if (get_span_kernel()!=_span_kernel_scalar) return double_row_sse2(src, dst, width);
+#elif defined(PRESENT_KERNELS_NEON)
+	if (get_span_kernel()==_span_kernel_neon) return double_row_neon(src, dst, width);
+#endif
+	return 0;
+}
+
+template <class S, class D>
+static void present_row(const S *src, D *dst, int width, bool double_pixels)
+{
+	int x;
+
+	if (tables.identity)
+	{
+		if (!double_pixels)
+		{
+			memcpy(dst, src, width*sizeof(D));
+			return;
+		}
+
+		for (x= double_row_simd(reinterpret_cast<const D *>(src), dst, width); x<width; ++x)
+		{
+			dst[2*x]= dst[2*x+1]= static_cast<D>(src[x]);
+		}
+		return;
+	}
+
+	if (double_pixels)
+	{
+		for (x= 0; x<width; ++x)
+		{
+			dst[2*x]= dst[2*x+1]= convert_pixel<S, D>(src[x]);
+		}
+	}
+	else
+	{
+		for (x= 0; x<width; ++x)
+		{
+			dst[x]= convert_pixel<S, D>(src[x]);
+		}
+	}
+}
+
+struct present_job
+{
+	const SDL_Surface *src;
+	SDL_Surface *dst;
+	int left, top;
+	int width, height; /* in source pixels */
+	bool double_pixels, every_other_line, clear_skipped_lines;
+	uint32 black_pixel;
+};
+
+template <class S, class D>
+static void present_rows(const present_job &job, int first_row, int last_row)
+{
+	int scale= job.double_pixels ? 2 : 1;
+
+	for (int y= first_row; y<last_row; ++y)
+	{
+		const S *src= reinterpret_cast<const S *>(static_cast<const uint8 *>(job.src->pixels) + y*job.src->pitch);
+		D *dst= reinterpret_cast<D *>(static_cast<uint8 *>(job.dst->pixels) + (job.top + scale*y)*job.dst->pitch) + job.left;
+
+		present_row(src, dst, job.width, job.double_pixels);
+
+		if (job.double_pixels)
+		{
+			D *dst2= reinterpret_cast<D *>(reinterpret_cast<uint8 *>(dst) + job.dst->pitch);
+
+			if (!job.every_other_line)
+			{
+				memcpy(dst2, dst, 2*job.width*sizeof(D));
+			}
+			else if (job.clear_skipped_lines)
+			{
+				/* overlay map needs us to clear all the scanlines, so we have to put black in
+					the "skipped" lines */
+				for (int x= 0; x<2*job.width; ++x)
+				{
+					dst2[x]= static_cast<D>(job.black_pixel);
+				}
+			}
+		}
+	}
+}
+
+static void present_band(const present_job &job, int first_row, int last_row)
+{
+	if (job.src->format->BytesPerPixel==2)
+	{
+		if (job.dst->format->BytesPerPixel==2) present_rows<pixel16, pixel16>(job, first_row, last_row);
+		else present_rows<pixel16, pixel32>(job, first_row, last_row);
+	}
+	else
+	{
+		if (job.dst->format->BytesPerPixel==2) present_rows<pixel32, pixel16>(job, first_row, last_row);
+		else present_rows<pixel32, pixel32>(job, first_row, last_row);
+	}
+}
+
+/* ---------- code */
+
+bool present_world_pixels(SDL_Surface *src, SDL_Surface *dst, const SDL_Rect &destination,
+	bool double_pixels, bool every_other_line, bool clear_skipped_lines, uint32 black_pixel,
+	const uint16 *gamma_r, const uint16 *gamma_g, const uint16 *gamma_b, int thread_count)
+{
+	present_job job;
+
+	if (!format_is_supported(src->format) || !format_is_supported(dst->format)) return false;
+
+	job.src= src;
+	job.dst= dst;
+	job.left= destination.x;
+	job.top= destination.y;
+	job.width= double_pixels ? MIN(destination.w/2, src->w) : src->w;
+	job.height= double_pixels ? MIN(destination.h/2, src->h) : src->h;
+	job.double_pixels= double_pixels;
+	job.every_other_line= double_pixels && every_other_line;
+	job.clear_skipped_lines= clear_skipped_lines;
+	job.black_pixel= black_pixel;
+
+	int scale= double_pixels ? 2 : 1;
+	if (job.left<0 || job.top<0 || job.left+scale*job.width>dst->w || job.top+scale*job.height>dst->h) return false;
+	if (job.width<=0 || job.height<=0) return true;
+
+	update_tables(src->format, dst->format, gamma_r, gamma_g, gamma_b);
+
+	static std::unique_ptr<WorkerPool> pool;
+	static int pool_size= 0;
+
+	/* several bands per thread so an unlucky thread doesn't hold up the rest; a band is at
+		least 16 rows so there's enough work to be worth handing out */
+	int band_height= job.height;
+	if (thread_count>1)
+	{
+		if (pool_size!=thread_count)
+		{
+			pool.reset();
+			pool.reset(new WorkerPool(thread_count));
+			pool_size= thread_count;
+		}
+		band_height= MAX((job.height+4*pool->thread_count()-1)/(4*pool->thread_count()), 16);
+	}
+
+	int band_count= (job.height+band_height-1)/band_height;
+	if (band_count<2)
+	{
+		present_band(job, 0, job.height);
+	}
+	else
+	{
+		pool->run(band_count, [&job, band_height](int index, int) {
+			int first_row= index*band_height;
+			present_band(job, first_row, MIN(first_row+band_height, job.height));
+		});
+	}
+
+	return true;
+}
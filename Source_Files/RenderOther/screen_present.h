@@ -0,0 +1,47 @@
+#ifndef __SCREEN_PRESENT_H
+#define __SCREEN_PRESENT_H
+
+/*
+SCREEN_PRESENT.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+Oct 16, 2026:
+	The software renderer's present stage: gamma correction, pixel doubling and conversion
+	to the screen's pixel format in a single pass over the world view, in bands of rows
+	spread across threads.
+*/
+
+#include "cseries.h"
+
+#include <SDL2/SDL_surface.h>
+
+/* copies src (16 or 32 bits per pixel) into dst with its top left corner at destination's.
+	if double_pixels, each source pixel becomes a 2x2 block and destination.w/2 by
+	destination.h/2 source pixels are copied; with every_other_line, the second row of each
+	block is left alone, or filled with black_pixel if clear_skipped_lines.  otherwise the whole
+	of src is copied.  the gamma tables are indexed by 8-bit channel values, as
+	current_gamma_r[] and friends are, or NULL for none.
+
+	the result is exactly what gamma correcting into a surface of src's format, converting that
+	to dst's format and doubling used to produce.  returns false, having done nothing, for 8-bit
+	or alpha formats or if the pixels don't fit in dst; the caller locks dst if it must */
+bool present_world_pixels(SDL_Surface *src, SDL_Surface *dst, const SDL_Rect &destination,
+	bool double_pixels, bool every_other_line, bool clear_skipped_lines, uint32 black_pixel,
+	const uint16 *gamma_r, const uint16 *gamma_g, const uint16 *gamma_b, int thread_count);
+
+#endif
@@ -21,8 +21,14 @@ SOUND.C
 */
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
 
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
 #include "SoundManager.h"
 #include "ReplacementSounds.h"
 #include "sound_definitions.h"
@@ -31,6 +37,7 @@ SOUND.C
 #include "OpenALManager.h"
 #include "shell_options.h"
 #include "Movie.h"
+#include "ScopedMutex.h"
 
 #undef SLOT_IS_USED
 #undef SLOT_IS_FREE
@@ -42,61 +49,84 @@ SOUND.C
 #define MARK_SLOT_AS_FREE(o) ((o)->flags&=(uint16)~0x8000)
 #define MARK_SLOT_AS_USED(o) ((o)->flags|=(uint16)0x8000)
 
+// Loaded sounds, indexed by sound index and threaded on a least-recently-used list, so
+// that finding, touching and evicting a sound are all constant time
 class SoundMemoryManager {
 public:
-	SoundMemoryManager(std::size_t max_size) : m_size(0), m_max_size(max_size) { }
+	SoundMemoryManager(std::size_t max_size) : m_size(0), m_max_size(max_size), m_newest(NONE), m_oldest(NONE), m_count(0), m_stats() { }
 
 	void SetMaxSize(std::size_t max_size) { m_max_size = max_size; }
+	std::size_t GetMaxSize() const { return m_max_size; }
+	std::size_t GetSize() const { return m_size; }
+	int GetCount() const { return m_count; }
 
 	void Add(std::shared_ptr<SoundData> data, short index, short slot);
-	std::shared_ptr<SoundData> Get(short index, short slot) { return m_entries[index].data[slot]; }
-	void Update(short index);
+	std::shared_ptr<SoundData> Get(short index, short slot) { return IsLoaded(index) ? m_entries[index].data[slot] : nullptr; }
+	void Update(short index); // sound must be loaded
 	std::function<void (short)> SoundReleased;
 
-	bool IsLoaded(short index) {
-		return m_entries.count(index);
+	bool IsLoaded(short index) const {
+		return index >= 0 && index < static_cast<short>(m_entries.size()) && m_entries[index].loaded;
 	}
 
-	void Clear() { m_entries.clear(); m_size = 0; }
+	void Clear();
 	void Release(short index); // sound must be loaded
 
+	SoundManager::CacheStats& Stats() { return m_stats; }
+
 private:
 	struct Entry {
-		Entry() : data(5), last_played(0) { }
+		Entry() : data(MAXIMUM_PERMUTATIONS_PER_SOUND), size(0), loaded(false), newer(NONE), older(NONE) { }
 		std::vector<std::shared_ptr<SoundData> > data;
-		uint32 last_played;
-
-		std::size_t size() {
-			std::size_t n = 0;
-			for (std::vector<std::shared_ptr<SoundData> >::iterator it = data.begin(); it != data.end(); ++it) 
-			{
-				if (it->get()) 
-				{
-					n += (*it)->size();
-				}
-			}
-			
-			return n;
-		}
+		std::size_t size; // bytes allocated for data
+		bool loaded;
+		short newer, older;
 	};
 
-	void ReleaseOldestSound();
-	std::map<short, Entry> m_entries;
+	void Link(short index); // as the newest
+	void Unlink(short index);
+
+	std::vector<Entry> m_entries;
 	std::size_t m_size;
 	std::size_t m_max_size;
+	short m_newest, m_oldest;
+	int m_count;
+	SoundManager::CacheStats m_stats;
 };
 
 void SoundMemoryManager::Add(std::shared_ptr<SoundData> data, short index, short slot)
 {
-	m_entries[index].data[slot] = data;
-	m_entries[index].last_played = machine_tick_count();
+	assert(index >= 0);
+	if (index >= static_cast<short>(m_entries.size()))
+	{
+		m_entries.resize(index + 1);
+	}
 
-	m_size += data->size();
+	Entry& entry = m_entries[index];
+	if (entry.loaded)
+	{
+		Unlink(index);
+	}
+	else
+	{
+		entry.loaded = true;
+		++m_count;
+	}
+	Link(index);
 
-	while (m_size > m_max_size)
+	if (entry.data[slot])
 	{
-		std::cerr << "Size is too big (" << m_size << ">" << m_max_size << ")" << std::endl;
-		ReleaseOldestSound();
+		entry.size -= entry.data[slot]->capacity();
+		m_size -= entry.data[slot]->capacity();
+	}
+	entry.data[slot] = data;
+	entry.size += data->capacity();
+	m_size += data->capacity();
+
+	while (m_size > m_max_size && m_oldest != NONE)
+	{
+		++m_stats.evictions;
+		Release(m_oldest);
 	}
 }
 
@@ -106,37 +136,268 @@ void SoundMemoryManager::Release(short index)
 	{
 		SoundReleased(index);
 	}
-	m_size -= m_entries[index].size();
-	m_entries.erase(index);
+
+	Entry& entry = m_entries[index];
+	assert(entry.loaded);
+
+	Unlink(index);
+	m_size -= entry.size;
+	--m_count;
+
+	// players still holding a sound keep it alive until they finish
+	for (auto& data : entry.data)
+	{
+		data.reset();
+	}
+	entry.size = 0;
+	entry.loaded = false;
+}
+
+void SoundMemoryManager::Clear()
+{
+	m_entries.clear();
+	m_size = 0;
+	m_newest = m_oldest = NONE;
+	m_count = 0;
 }
 
-void SoundMemoryManager::ReleaseOldestSound()
+void SoundMemoryManager::Update(short index)
 {
-	if (!m_entries.size())
+	assert(IsLoaded(index));
+	if (index != m_newest)
 	{
-		return;
+		Unlink(index);
+		Link(index);
 	}
-	
-	std::map<short, Entry>::iterator oldest_sound = m_entries.begin();
-	std::map<short, Entry>::iterator it = oldest_sound;
-	++it;
-	for (; it != m_entries.end(); ++it)
+}
+
+void SoundMemoryManager::Link(short index)
+{
+	Entry& entry = m_entries[index];
+	entry.older = m_newest;
+	entry.newer = NONE;
+
+	if (m_newest != NONE) m_entries[m_newest].newer = index;
+	else m_oldest = index;
+	m_newest = index;
+}
+
+void SoundMemoryManager::Unlink(short index)
+{
+	Entry& entry = m_entries[index];
+
+	if (entry.newer != NONE) m_entries[entry.newer].older = entry.older;
+	else m_newest = entry.older;
+	if (entry.older != NONE) m_entries[entry.older].newer = entry.newer;
+	else m_oldest = entry.newer;
+
+	entry.newer = entry.older = NONE;
+}
+
+// A sound's permutations, read on whichever thread gets to it; replacement sounds carry
+// their own copy of the options, since reading one fills in its header
+struct SoundLoadJob
+{
+	short index = NONE;
+	SoundDefinition* definition = nullptr;
+	int slots = 0;
+	uint32 generation = 0;
+
+	std::shared_ptr<SoundData> data[MAXIMUM_PERMUTATIONS_PER_SOUND];
+	std::unique_ptr<SoundOptions> replacements[MAXIMUM_PERMUTATIONS_PER_SOUND];
+};
+
+// Reads queued sounds on a background thread. Only the game thread touches the
+// SoundMemoryManager, so finished jobs wait here until it collects them
+class SoundLoader {
+public:
+	SoundLoader(std::function<bool (SoundLoadJob&)> read);
+
+	// starts the thread the first time; false if it can't be started
+	bool Queue(SoundLoadJob&& job);
+
+	// queued or being read, and not yet collected
+	bool IsPending(short index) const { return m_pending.count(index) > 0; }
+	bool HasPending() const { return !m_pending.empty(); }
+
+	// if the sound hasn't been started, hands it back to be read by the caller and returns
+	// true; otherwise waits for it to finish
+	bool Finish(short index, SoundLoadJob& job);
+	std::vector<SoundLoadJob> TakeFinished();
+
+	// drops every pending job; jobs being read are discarded when they finish
+	void Cancel();
+	// drops the one sound's job, waiting for it if it's being read
+	void Cancel(short index);
+	void Stop();
+
+	uint32 Generation() const { return m_generation; }
+
+	// held while reading the sound file, and while replacing it
+	SDL_mutex* FileMutex() { return m_file_mutex; }
+
+private:
+	static int Run(void *);
+
+	std::function<bool (SoundLoadJob&)> m_read;
+
+	SDL_Thread* m_thread;
+	SDL_mutex* m_mutex;
+	SDL_cond* m_wake;
+	SDL_cond* m_done;
+	SDL_mutex* m_file_mutex;
+
+	// guarded by m_mutex
+	std::deque<SoundLoadJob> m_queued;
+	std::vector<SoundLoadJob> m_finished;
+	short m_in_flight;
+	bool m_quit;
+
+	std::atomic<uint32> m_generation;
+	std::set<short> m_pending; // game thread only
+};
+
+SoundLoader::SoundLoader(std::function<bool (SoundLoadJob&)> read) : m_read(read), m_thread(nullptr), m_in_flight(NONE), m_quit(false), m_generation(0)
+{
+	m_mutex = SDL_CreateMutex();
+	m_wake = SDL_CreateCond();
+	m_done = SDL_CreateCond();
+	m_file_mutex = SDL_CreateMutex();
+}
+
+bool SoundLoader::Queue(SoundLoadJob&& job)
+{
+	if (!m_thread)
 	{
-		if (it->second.last_played < oldest_sound->second.last_played)
+		if (m_quit) return false;
+		m_thread = SDL_CreateThread(Run, "SoundLoader_thread", this);
+		if (!m_thread) return false;
+	}
+
+	m_pending.insert(job.index);
+
+	ScopedMutex lock(m_mutex);
+	m_queued.push_back(std::move(job));
+	SDL_CondSignal(m_wake);
+	return true;
+}
+
+bool SoundLoader::Finish(short index, SoundLoadJob& job)
+{
+	ScopedMutex lock(m_mutex);
+	for (auto it = m_queued.begin(); it != m_queued.end(); ++it)
+	{
+		if (it->index == index)
 		{
-			oldest_sound = it;
+			job = std::move(*it);
+			m_queued.erase(it);
+			m_pending.erase(index);
+			return true;
 		}
 	}
 
-	std::cerr << "Dropping sound " << oldest_sound->first << std::endl;
-	Release(oldest_sound->first);
+	while (m_in_flight == index)
+	{
+		SDL_CondWait(m_done, m_mutex);
+	}
+	return false;
 }
 
-void SoundMemoryManager::Update(short index)
+std::vector<SoundLoadJob> SoundLoader::TakeFinished()
 {
-	m_entries[index].last_played = machine_tick_count();
+	std::vector<SoundLoadJob> jobs;
+	{
+		ScopedMutex lock(m_mutex);
+		jobs.swap(m_finished);
+	}
+
+	// anything from before the last Cancel() may have been queued again since
+	auto stale = std::remove_if(jobs.begin(), jobs.end(), [this](const SoundLoadJob& job) { return job.generation != m_generation; });
+	jobs.erase(stale, jobs.end());
+
+	for (auto& job : jobs)
+	{
+		m_pending.erase(job.index);
+	}
+
+	return jobs;
+}
+
+void SoundLoader::Cancel()
+{
+	{
+		ScopedMutex lock(m_mutex);
+		m_queued.clear();
+		m_finished.clear();
+		++m_generation;
+	}
+
+	m_pending.clear();
+}
+
+void SoundLoader::Cancel(short index)
+{
+	{
+		ScopedMutex lock(m_mutex);
+		auto queued = std::remove_if(m_queued.begin(), m_queued.end(), [index](const SoundLoadJob& job) { return job.index == index; });
+		m_queued.erase(queued, m_queued.end());
+
+		while (m_in_flight == index)
+		{
+			SDL_CondWait(m_done, m_mutex);
+		}
+
+		auto finished = std::remove_if(m_finished.begin(), m_finished.end(), [index](const SoundLoadJob& job) { return job.index == index; });
+		m_finished.erase(finished, m_finished.end());
+	}
+
+	m_pending.erase(index);
+}
+
+void SoundLoader::Stop()
+{
+	Cancel();
+
+	SDL_LockMutex(m_mutex);
+	m_quit = true;
+	SDL_CondSignal(m_wake);
+	SDL_UnlockMutex(m_mutex);
+
+	if (m_thread)
+	{
+		SDL_WaitThread(m_thread, NULL);
+		m_thread = nullptr;
+	}
 }
 
+int SoundLoader::Run(void *p)
+{
+	SoundLoader *loader = static_cast<SoundLoader *>(p);
+	SDL_SetThreadPriority(SDL_THREAD_PRIORITY_LOW);
+
+	SDL_LockMutex(loader->m_mutex);
+	for (;;)
+	{
+		while (!loader->m_quit && loader->m_queued.empty())
+			SDL_CondWait(loader->m_wake, loader->m_mutex);
+		if (loader->m_quit) break;
+
+		SoundLoadJob job = std::move(loader->m_queued.front());
+		loader->m_queued.pop_front();
+		loader->m_in_flight = job.index;
+		SDL_UnlockMutex(loader->m_mutex);
+
+		bool read = loader->m_read(job);
+
+		SDL_LockMutex(loader->m_mutex);
+		loader->m_in_flight = NONE;
+		if (read) loader->m_finished.push_back(std::move(job));
+		SDL_CondBroadcast(loader->m_done);
+	}
+	SDL_UnlockMutex(loader->m_mutex);
+
+	return 0;
+}
 
 static void Shutdown()
 {
@@ -187,6 +448,7 @@ void SoundManager::SetParameters(const Parameters& parameters)
 
 void SoundManager::Shutdown()
 {
+	instance()->loader->Stop();
 	instance()->SetStatus(false);
 	instance()->CloseSoundFile();
 }
@@ -194,6 +456,8 @@ void SoundManager::Shutdown()
 bool SoundManager::OpenSoundFile(FileSpecifier& File)
 {
 	UnloadAllSounds();
+
+	ScopedMutex lock(loader->FileMutex());
 	sound_file.reset(new M2SoundFile);
 	if (!sound_file->Open(File))
 	{
@@ -216,6 +480,9 @@ bool SoundManager::OpenSoundFile(FileSpecifier& File)
 void SoundManager::CloseSoundFile()
 {
 	StopAllSounds();
+	loader->Cancel();
+
+	ScopedMutex lock(loader->FileMutex());
 	sound_file->Close();
 }
 
@@ -263,57 +530,183 @@ void SoundManager::TestVolume(float db, short sound_index)
 	}	
 }
 
-bool SoundManager::LoadSound(short sound_index)
+SoundDefinition* SoundManager::GetLoadableSoundDefinition(short sound_index)
 {
-	if (!active) return false;
+	if (!active) return nullptr;
 
 	SoundDefinition *definition = GetSoundDefinition(sound_index);
-	if (!definition) return false;
-
-	// Load all the external-file sounds for each index;
-	// fill the slots appropriately.
-	int NumSlots= (parameters.flags & _more_sounds_flag) ? definition->permutations : 1;
+	if (!definition) return nullptr;
 
 	if (definition->sound_code == NONE) 
 	{
-		return false;
+		return nullptr;
 	}
 
 	if (!(parameters.flags & _ambient_sound_flag) && (definition->flags & _sound_is_ambient))
 	{
-		return false;
+		return nullptr;
 	}
-			
-	if (sounds->IsLoaded(sound_index))
+
+	return definition;
+}
+
+void SoundManager::PrepareSoundLoad(short sound_index, SoundDefinition* definition, SoundLoadJob& job)
+{
+	// Load all the external-file sounds for each index;
+	// fill the slots appropriately.
+	job.index = sound_index;
+	job.definition = definition;
+	job.slots = (parameters.flags & _more_sounds_flag) ? definition->permutations : 1;
+	job.generation = loader->Generation();
+
+	for (int i = 0; i < job.slots; ++i)
 	{
-		sounds->Update(sound_index);
-	} 
-	else
+		SoundOptions *SndOpts = SoundReplacements::instance()->GetSoundOptions(sound_index, i);
+		if (SndOpts)
+		{
+			job.replacements[i].reset(new SoundOptions(*SndOpts));
+		}
+	}
+}
+
+// called on the loader thread too
+bool SoundManager::ReadSound(SoundLoadJob& job)
+{
 	{
-		for (int i = 0; i < NumSlots; ++i)
+		ScopedMutex lock(loader->FileMutex());
+
+		// the definition went away with the sound file it came from
+		if (job.generation != loader->Generation()) return false;
+
+		for (int i = 0; i < job.slots; ++i)
 		{
-			auto p = sound_file->GetSoundData(definition, i);
+			job.data[i] = sound_file->GetSoundData(job.definition, i);
+		}
+	}
 
-			SoundOptions *SndOpts = SoundReplacements::instance()->GetSoundOptions(sound_index, i);
-			if (SndOpts)
+	for (int i = 0; i < job.slots; ++i)
+	{
+		if (job.replacements[i])
+		{
+			auto x = job.replacements[i]->Sound.LoadExternal(job.replacements[i]->File);
+			if (x.get()) 
 			{
-				auto x = SndOpts->Sound.LoadExternal(SndOpts->File);
-				if (x.get()) 
-				{
-					p = x;
-				}
+				job.data[i] = x;
 			}
+		}
+	}
+
+	return true;
+}
 
-			if (p.get())
+void SoundManager::AddLoadedSound(SoundLoadJob& job)
+{
+	for (int i = 0; i < job.slots; ++i)
+	{
+		if (job.replacements[i])
+		{
+			SoundOptions *SndOpts = SoundReplacements::instance()->GetSoundOptions(job.index, i);
+			if (SndOpts)
 			{
-				sounds->Add(p, sound_index, i);
+				SndOpts->Sound = job.replacements[i]->Sound;
 			}
 		}
+
+		if (job.data[i].get())
+		{
+			sounds->Add(job.data[i], job.index, i);
+		}
+	}
+}
+
+void SoundManager::AddPrefetchedSounds()
+{
+	if (!loader->HasPending()) return;
+
+	for (auto& job : loader->TakeFinished())
+	{
+		++sounds->Stats().prefetches;
+		AddLoadedSound(job);
+	}
+}
+
+bool SoundManager::LoadSound(short sound_index)
+{
+	SoundDefinition *definition = GetLoadableSoundDefinition(sound_index);
+	if (!definition) return false;
+
+	if (loader->IsPending(sound_index))
+	{
+		// wanted before the loader finished it; read it here if it hasn't
+		// been started, which is no slower than not having prefetched it
+		++sounds->Stats().misses;
+
+		SoundLoadJob job;
+		if (loader->Finish(sound_index, job))
+		{
+			if (ReadSound(job)) AddLoadedSound(job);
+		}
+
+		AddPrefetchedSounds();
+	}
+	else if (sounds->IsLoaded(sound_index))
+	{
+		sounds->Update(sound_index);
+		++sounds->Stats().hits;
+	} 
+	else
+	{
+		++sounds->Stats().misses;
+
+		SoundLoadJob job;
+		PrepareSoundLoad(sound_index, definition, job);
+		if (ReadSound(job)) AddLoadedSound(job);
 	}
 
 	return sounds->IsLoaded(sound_index);
 }
 
+void SoundManager::PrefetchSound(short sound_index)
+{
+	SoundDefinition *definition = GetLoadableSoundDefinition(sound_index);
+	if (!definition || loader->IsPending(sound_index)) return;
+
+	if (sounds->IsLoaded(sound_index))
+	{
+		sounds->Update(sound_index);
+		return;
+	}
+
+	SoundLoadJob job;
+	PrepareSoundLoad(sound_index, definition, job);
+	if (!loader->Queue(std::move(job)))
+	{
+		LoadSound(sound_index);
+	}
+}
+
+void SoundManager::PrefetchSounds(short *sounds, short count)
+{
+	for (short i = 0; i < count; i++)
+	{
+		PrefetchSound(sounds[i]);
+	}
+}
+
+SoundManager::CacheStats SoundManager::GetCacheStats() const
+{
+	CacheStats stats = sounds->Stats();
+	stats.bytes_resident = sounds->GetSize();
+	stats.bytes_limit = sounds->GetMaxSize();
+	stats.sounds_resident = sounds->GetCount();
+	return stats;
+}
+
+void SoundManager::ResetCacheStats()
+{
+	sounds->Stats() = CacheStats();
+}
+
 void SoundManager::LoadSounds(short *sounds, short count)
 {
 	for (short i = 0; i < count; i++)
@@ -334,6 +727,11 @@ void SoundManager::StopSound(short identifier, short sound_index)
 void SoundManager::UnloadSound(short sound_index)
 {
 	StopSound(NONE, sound_index);
+	if (loader->IsPending(sound_index))
+	{
+		loader->Cancel(sound_index);
+	}
+
 	if (sounds->IsLoaded(sound_index))
 	{
 		sounds->Release(sound_index);
@@ -342,6 +740,7 @@ void SoundManager::UnloadSound(short sound_index)
 
 void SoundManager::UnloadAllSounds()
 {
+	loader->Cancel();
 	if (active)
 	{
 		StopAllSounds();
@@ -505,6 +904,7 @@ void SoundManager::UpdateListener() {
 
 void SoundManager::Idle()
 {
+	AddPrefetchedSounds();
 	UpdateListener();
 	CauseAmbientSoundSourceUpdate();
 	ManagePlayers();
@@ -735,7 +1135,8 @@ bool SoundManager::Parameters::Verify()
 	return true;
 }
 
-SoundManager::SoundManager() : active(false), initialized(false), sounds(new SoundMemoryManager(10 << 20)) 
+SoundManager::SoundManager() : active(false), initialized(false), sounds(new SoundMemoryManager(10 << 20)),
+	loader(new SoundLoader([this](SoundLoadJob& job) { return ReadSound(job); }))
 { 
 	
 }
@@ -854,6 +1255,7 @@ std::shared_ptr<SoundPlayer> SoundManager::BufferSound(SoundParameters parameter
 	}
 	else
 	{
+		ScopedMutex lock(loader->FileMutex());
 		header = sound_file->GetSoundHeader(definition, permutation);
 	}
 
@@ -32,6 +32,8 @@
 struct ambient_sound_data;
 
 class SoundMemoryManager;
+class SoundLoader;
+struct SoundLoadJob;
 
 class SoundManager
 {
@@ -65,6 +67,11 @@ public:
 	bool LoadSound(short sound);
 	void LoadSounds(short *sounds, short count);
 
+	// reads sounds on a background thread, so they are in memory before they are
+	// first played; LoadSound() finishes one at once if it is wanted sooner
+	void PrefetchSound(short sound);
+	void PrefetchSounds(short *sounds, short count);
+
 	void UnloadSound(short sound);
 	void UnloadAllSounds();
 
@@ -124,6 +131,21 @@ public:
 	bool IsActive() { return active; }
 	bool IsInitialized() { return initialized; }
 
+	// how well loaded sounds are being reused
+	struct CacheStats
+	{
+		uint32 hits = 0; // LoadSound() found the sound in memory
+		uint32 misses = 0; // LoadSound() had to read it, or wait for it
+		uint32 prefetches = 0; // sounds read in the background
+		uint32 evictions = 0; // sounds dropped to stay under the memory limit
+		std::size_t bytes_resident = 0;
+		std::size_t bytes_limit = 0;
+		int sounds_resident = 0;
+	};
+
+	CacheStats GetCacheStats() const;
+	void ResetCacheStats();
+
 private:
 	SoundManager();
 	void SetStatus(bool active);
@@ -149,6 +171,13 @@ private:
 	
 	std::unique_ptr<SoundFile> sound_file;
 	SoundMemoryManager* sounds;
+	SoundLoader* loader;
+
+	SoundDefinition* GetLoadableSoundDefinition(short sound_index);
+	void PrepareSoundLoad(short sound_index, SoundDefinition* definition, SoundLoadJob& job);
+	bool ReadSound(SoundLoadJob& job);
+	void AddLoadedSound(SoundLoadJob& job);
+	void AddPrefetchedSounds();
 
 	// buffer sizes
 	static const int MINIMUM_SOUND_BUFFER_SIZE = 300*KILO;
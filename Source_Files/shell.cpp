@@ -112,6 +112,7 @@
 #include "Movie.h"
 #include "HTTP.h"
 #include "WadImageCache.h"
+#include "ReplacementTextureCache.h"
 
 #ifdef __WIN32__
 #define WIN32_LEAN_AND_MEAN
@@ -427,6 +428,7 @@ void initialize_application(void)
 	screenshots_dir.CreateDirectory();
 	
 	WadImageCache::instance()->initialize_cache();
+	ReplacementTextureCache::instance()->initialize_cache();
 
 #ifndef HAVE_OPENGL
 	graphics_preferences->screen_mode.acceleration = _no_acceleration;
@@ -488,6 +490,7 @@ void initialize_application(void)
 void shutdown_application(void)
 {
 	WadImageCache::instance()->save_cache();
+	ReplacementTextureCache::instance()->save_cache();
 
 	shutdown_dialogs();
         
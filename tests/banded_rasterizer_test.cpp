@@ -0,0 +1,218 @@
+#include "cseries.h"
+#include "world.h"
+#include "render.h"
+#include "scottish_textures.h"
+#include "Rasterizer_SW.h"
+#include "preferences.h"
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+
+static const int SCREEN_WIDTH = 640;
+static const int SCREEN_HEIGHT = 480;
+
+// a texture with random texels; shapes are column-ordered RLE with a random first and last row per column
+class RandomBitmap {
+public:
+	RandomBitmap(int width, int height, int16 flags, std::mt19937& random) {
+		bool rle = flags & _COLUMN_ORDER_BIT;
+		int lines = rle ? width : height;
+		int line_length = rle ? height + 4 : width;
+
+		header.resize(sizeof(bitmap_definition) + lines * sizeof(pixel8 *));
+		pixels.resize(lines * line_length);
+
+		bitmap_definition *bitmap = get();
+		bitmap->width = width;
+		bitmap->height = height;
+		bitmap->bytes_per_row = rle ? NONE : width;
+		bitmap->flags = flags;
+		bitmap->bit_depth = 8;
+
+		for (int i = 0; i < lines; i++) {
+			pixel8 *line = pixels.data() + i * line_length;
+			for (int j = 0; j < line_length; j++) line[j] = (flags & _TRANSPARENT_BIT) && random() % 4 == 0 ? 0 : random() % 255 + 1;
+
+			if (rle) {
+				int first = random() % (height / 4), last = height - random() % (height / 4);
+				line[0] = first >> 8, line[1] = first, line[2] = last >> 8, line[3] = last;
+			}
+			bitmap->row_addresses[i] = line;
+		}
+	}
+
+	bitmap_definition *get() { return reinterpret_cast<bitmap_definition *>(header.data()); }
+
+private:
+	std::vector<byte> header;
+	std::vector<pixel8> pixels;
+};
+
+struct RandomFrame {
+	std::vector<polygon_definition> polygons;
+	std::vector<bool> horizontal;
+	std::vector<rectangle_definition> rectangles;
+	std::vector<bool> is_rectangle;
+};
+
+static RandomFrame random_frame(std::mt19937& random, bitmap_definition *textures[3], bitmap_definition *shape, void *shading_tables) {
+
+	RandomFrame frame;
+	int count = 1 + random() % 30;
+	for (int k = 0; k < count; k++) {
+		if (random() % 4 == 0) {
+			rectangle_definition rectangle;
+			rectangle.flags = 0;
+			rectangle.texture = shape;
+			rectangle.x0 = static_cast<int16>(random() % (SCREEN_WIDTH + 200)) - 100;
+			rectangle.x1 = rectangle.x0 + 1 + random() % 300;
+			rectangle.y0 = static_cast<int16>(random() % SCREEN_HEIGHT) - 50;
+			rectangle.y1 = rectangle.y0 + 1 + random() % 300;
+			rectangle.clip_left = static_cast<int16>(random() % SCREEN_WIDTH) - 50;
+			rectangle.clip_right = rectangle.clip_left + random() % SCREEN_WIDTH;
+			rectangle.clip_top = 0;
+			rectangle.clip_bottom = SCREEN_HEIGHT;
+			rectangle.depth = random() % 5000;
+			rectangle.ambient_shade = random() % FIXED_ONE;
+			rectangle.shading_tables = shading_tables;
+			rectangle.transfer_mode = _textured_transfer;
+			rectangle.transfer_data = 0;
+			rectangle.flip_vertical = false;
+			rectangle.flip_horizontal = random() & 1;
+			rectangle.xc = (rectangle.x0 + rectangle.x1) / 2;
+			rectangle.Opacity = 1;
+			frame.rectangles.push_back(rectangle);
+			frame.is_rectangle.push_back(true);
+			continue;
+		}
+
+		// a convex quad with slanted top and bottom edges, clockwise
+		polygon_definition polygon = {};
+		polygon.texture = textures[random() % 3];
+		polygon.ambient_shade = random() % FIXED_ONE;
+		polygon.shading_tables = shading_tables;
+		polygon.transfer_mode = _textured_transfer;
+		polygon.origin = { static_cast<int32>(random() % 4000) - 2000, static_cast<int32>(random() % 4000) - 2000, static_cast<int32>(random() % 2000) - 1000 };
+		polygon.vector = { static_cast<int16>(static_cast<int>(random() % 2048) - 1024), static_cast<int16>(static_cast<int>(random() % 2048) - 1024), static_cast<int16>(random() % 1024 + 1) };
+
+		int x0 = random() % SCREEN_WIDTH, x1 = x0 + random() % (SCREEN_WIDTH - x0 + 1);
+		int y0 = random() % SCREEN_HEIGHT, y1 = y0 + random() % (SCREEN_HEIGHT - y0 + 1);
+		int slant = random() % 20;
+		polygon.vertex_count = 4;
+		polygon.vertices[0] = { static_cast<int16>(x0), static_cast<int16>(y0) };
+		polygon.vertices[1] = { static_cast<int16>(x1), static_cast<int16>(std::min(SCREEN_HEIGHT, y0 + slant)) };
+		polygon.vertices[2] = { static_cast<int16>(x1), static_cast<int16>(y1) };
+		polygon.vertices[3] = { static_cast<int16>(x0), static_cast<int16>(std::max(y0, y1 - slant)) };
+		frame.polygons.push_back(polygon);
+		frame.horizontal.push_back(random() & 1);
+		frame.is_rectangle.push_back(false);
+	}
+
+	return frame;
+}
+
+template <typename T>
+static void render_frame(Rasterizer_SW_Class& rasterizer, RandomFrame frame, std::vector<T>& pixels) {
+
+	std::fill(pixels.begin(), pixels.end(), 0);
+	for (int y = 0; y < SCREEN_HEIGHT; y++) rasterizer.screen->row_addresses[y] = reinterpret_cast<pixel8 *>(&pixels[y * SCREEN_WIDTH]);
+
+	// the rasterizer may clip what it's handed, so it gets a copy
+	rasterizer.Begin();
+	size_t polygon = 0, rectangle = 0;
+	for (bool is_rectangle : frame.is_rectangle) {
+		if (is_rectangle) {
+			rasterizer.texture_rectangle(frame.rectangles[rectangle++]);
+		} else if (frame.horizontal[polygon]) {
+			rasterizer.texture_horizontal_polygon(frame.polygons[polygon++]);
+		} else {
+			rasterizer.texture_vertical_polygon(frame.polygons[polygon++]);
+		}
+	}
+	rasterizer.End();
+}
+
+template <typename T>
+static void check_banded_frames(short depth) {
+
+	std::mt19937 random(depth);
+
+	const short old_bit_depth = bit_depth;
+	const short old_shading_tables = number_of_shading_tables, old_fractional_bits = shading_table_fractional_bits;
+	bit_depth = depth;
+	number_of_shading_tables = 32;
+	shading_table_fractional_bits = 5;
+
+	std::vector<T> shading_tables(256 * number_of_shading_tables);
+	for (T& entry : shading_tables) entry = static_cast<T>(random());
+
+	RandomBitmap floor(128, 128, 0, random), wall(256, 256, 0, random), grate(128, 128, _TRANSPARENT_BIT, random);
+	RandomBitmap shape(64, 96, _COLUMN_ORDER_BIT, random);
+	bitmap_definition *textures[3] = { floor.get(), wall.get(), grate.get() };
+
+	std::vector<byte> screen_header(sizeof(bitmap_definition) + SCREEN_HEIGHT * sizeof(pixel8 *));
+	bitmap_definition *screen = reinterpret_cast<bitmap_definition *>(screen_header.data());
+	screen->width = SCREEN_WIDTH;
+	screen->height = SCREEN_HEIGHT;
+	screen->bytes_per_row = SCREEN_WIDTH * sizeof(T);
+
+	view_data view = {};
+	view.half_screen_width = SCREEN_WIDTH / 2;
+	view.half_screen_height = SCREEN_HEIGHT / 2;
+	view.world_to_screen_x = view.world_to_screen_y = SCREEN_WIDTH / 2;
+	view.maximum_depth_intensity = FIXED_ONE;
+	view.standard_screen_width = SCREEN_WIDTH;
+	view.screen_width = SCREEN_WIDTH;
+	view.screen_height = SCREEN_HEIGHT;
+	view.half_cone = NUMBER_OF_ANGLES / 8;
+
+	Rasterizer_SW_Class rasterizer;
+	rasterizer.screen = screen;
+	rasterizer.SetView(view);
+
+	std::vector<T> serial(SCREEN_WIDTH * SCREEN_HEIGHT), banded(SCREEN_WIDTH * SCREEN_HEIGHT);
+	for (int i = 0; i < 300; i++) {
+		view.yaw = random() % NUMBER_OF_ANGLES;
+		view.dtanpitch = static_cast<int>(random() % 200) - 100;
+		RandomFrame frame = random_frame(random, textures, shape.get(), shading_tables.data());
+
+		graphics_preferences->software_rendering_threads = 1;
+		render_frame(rasterizer, frame, serial);
+
+		int threads = 2 + i % 7;
+		graphics_preferences->software_rendering_threads = threads;
+		render_frame(rasterizer, frame, banded);
+
+		INFO(depth << "-bit frame " << i << " on " << threads << " threads");
+		REQUIRE(banded == serial);
+	}
+
+	bit_depth = old_bit_depth;
+	number_of_shading_tables = old_shading_tables;
+	shading_table_fractional_bits = old_fractional_bits;
+}
+
+TEST_CASE("Banded software rasterizer matches one thread", "[Render]") {
+
+	build_trig_tables();
+	allocate_texture_tables();
+
+	// the rasterizer reads only the thread count and alpha blending mode
+	std::unique_ptr<graphics_preferences_data> test_preferences;
+	graphics_preferences_data *old_preferences = graphics_preferences;
+	if (!graphics_preferences) {
+		test_preferences.reset(new graphics_preferences_data());
+		graphics_preferences = test_preferences.get();
+	}
+	const int16 old_threads = graphics_preferences->software_rendering_threads;
+	const int16 old_alpha_blending = graphics_preferences->software_alpha_blending;
+	graphics_preferences->software_alpha_blending = _sw_alpha_off;
+
+	check_banded_frames<pixel16>(16);
+	check_banded_frames<pixel32>(32);
+
+	graphics_preferences->software_rendering_threads = old_threads;
+	graphics_preferences->software_alpha_blending = old_alpha_blending;
+	graphics_preferences = old_preferences;
+}
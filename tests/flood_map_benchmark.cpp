@@ -0,0 +1,72 @@
+#include "shell.h"
+#include "map.h"
+#include "flood_map.h"
+#include "shell_options.h"
+#include "interface.h"
+#include "replays.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+
+extern ShellOptions shell_options;
+
+struct FloodThroughput {
+	uint64_t nodes = 0;
+	double seconds = 0;
+};
+
+// floods outward from every polygon of the current level, counting expanded nodes
+static FloodThroughput flood_every_polygon(short flood_mode) {
+
+	FloodThroughput result;
+	auto start = std::chrono::steady_clock::now();
+
+	for (short polygon_index = 0; polygon_index < dynamic_world->polygon_count; polygon_index++) {
+
+		if (POLYGON_IS_DETACHED(get_polygon_data(polygon_index))) continue;
+
+		auto flood_polygon_index = flood_map(polygon_index, INT32_MAX, nullptr, flood_mode, nullptr);
+		while (flood_polygon_index != NONE) {
+			result.nodes++;
+			flood_polygon_index = flood_map(NONE, INT32_MAX, nullptr, flood_mode, nullptr);
+		}
+	}
+
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+// hidden by default: run with "[Benchmark]" to print nodes/sec for each mode on the replay levels
+TEST_CASE("Flood map throughput", "[.][Benchmark]") {
+
+	REQUIRE(!shell_options.directory.empty());
+	REQUIRE(!shell_options.replay_directory.empty());
+
+	const auto replays = get_replays(shell_options.replay_directory);
+
+	initialize_application();
+
+	FloodThroughput best_first, breadth_first;
+
+	for (const auto& replay : replays) {
+		INFO(replay.first);
+		REQUIRE(handle_open_document(replay.first));
+
+		auto level_best_first = flood_every_polygon(_best_first);
+		auto level_breadth_first = flood_every_polygon(_breadth_first);
+
+		best_first.nodes += level_best_first.nodes;
+		best_first.seconds += level_best_first.seconds;
+		breadth_first.nodes += level_breadth_first.nodes;
+		breadth_first.seconds += level_breadth_first.seconds;
+
+		// flooding must not disturb the simulation; the film still has to replay to its seed
+		set_replay_speed(INT16_MAX);
+		main_event_loop();
+		CHECK(get_random_seed() == replay.second);
+	}
+
+	shutdown_application();
+
+	WARN("best first: " << best_first.nodes << " nodes, " << best_first.nodes / best_first.seconds << " nodes/sec");
+	WARN("breadth first: " << breadth_first.nodes << " nodes, " << breadth_first.nodes / breadth_first.seconds << " nodes/sec");
+}
@@ -0,0 +1,100 @@
+#include "cseries.h"
+#include "screen_present.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+
+// the old chain, a pixel at a time: gamma correct within the source format, then convert and double
+static void present_reference(SDL_Surface *src, SDL_Surface *dst, bool double_pixels, const uint16 *gamma) {
+
+	int scale = double_pixels ? 2 : 1;
+	for (int y = 0; y < src->h; y++) {
+		for (int x = 0; x < src->w; x++) {
+			const uint8 *s = static_cast<const uint8 *>(src->pixels) + y * src->pitch + x * src->format->BytesPerPixel;
+			uint32 pixel = src->format->BytesPerPixel == 2 ? *reinterpret_cast<const uint16 *>(s) : *reinterpret_cast<const uint32 *>(s);
+
+			if (gamma) {
+				const SDL_PixelFormat *f = src->format;
+				uint32 r = gamma[static_cast<uint8>(((pixel & f->Rmask) >> f->Rshift) << f->Rloss)] >> 8;
+				uint32 g = gamma[static_cast<uint8>(((pixel & f->Gmask) >> f->Gshift) << f->Gloss)] >> 8;
+				uint32 b = gamma[static_cast<uint8>(((pixel & f->Bmask) >> f->Bshift) << f->Bloss)] >> 8;
+				pixel = ((r >> f->Rloss) << f->Rshift) | ((g >> f->Gloss) << f->Gshift) | ((b >> f->Bloss) << f->Bshift);
+			}
+
+			uint8 r, g, b;
+			SDL_GetRGB(pixel, src->format, &r, &g, &b);
+			pixel = SDL_MapRGB(dst->format, r, g, b);
+
+			for (int dy = 0; dy < scale; dy++) {
+				for (int dx = 0; dx < scale; dx++) {
+					uint8 *d = static_cast<uint8 *>(dst->pixels) + (scale * y + dy) * dst->pitch + (scale * x + dx) * dst->format->BytesPerPixel;
+					if (dst->format->BytesPerPixel == 2) *reinterpret_cast<uint16 *>(d) = static_cast<uint16>(pixel);
+					else *reinterpret_cast<uint32 *>(d) = pixel;
+				}
+			}
+		}
+	}
+}
+
+static bool same_pixels(SDL_Surface *a, SDL_Surface *b) {
+	for (int y = 0; y < a->h; y++) {
+		if (memcmp(static_cast<uint8 *>(a->pixels) + y * a->pitch, static_cast<uint8 *>(b->pixels) + y * b->pitch, a->w * a->format->BytesPerPixel))
+			return false;
+	}
+	return true;
+}
+
+// hidden by default: run with "[Benchmark]" to time the software renderer's present stage at 1440p
+TEST_CASE("Present throughput", "[.][Benchmark][Present]") {
+
+	const Uint32 formats[] = { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB555, SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XBGR8888 };
+
+	uint16 gamma[256];
+	for (int i = 0; i < 256; i++) gamma[i] = static_cast<uint16>(std::min(65535, i * 300));
+
+	std::mt19937 random(1);
+
+	for (Uint32 src_format : formats) {
+		for (Uint32 dst_format : formats) {
+			for (bool double_pixels : { false, true }) {
+				for (bool use_gamma : { false, true }) {
+					int scale = double_pixels ? 2 : 1;
+					SDL_Surface *src = SDL_CreateRGBSurfaceWithFormat(0, 2560 / scale, 1440 / scale, SDL_BITSPERPIXEL(src_format), src_format);
+					SDL_Surface *fused = SDL_CreateRGBSurfaceWithFormat(0, 2560, 1440, SDL_BITSPERPIXEL(dst_format), dst_format);
+					SDL_Surface *reference = SDL_CreateRGBSurfaceWithFormat(0, 2560, 1440, SDL_BITSPERPIXEL(dst_format), dst_format);
+					REQUIRE(src);
+					REQUIRE(fused);
+					REQUIRE(reference);
+
+					for (int y = 0; y < src->h; y++) {
+						uint8 *row = static_cast<uint8 *>(src->pixels) + y * src->pitch;
+						for (int i = 0; i < src->w * src->format->BytesPerPixel; i++) row[i] = static_cast<uint8>(random());
+					}
+
+					INFO(SDL_GetPixelFormatName(src_format) << " to " << SDL_GetPixelFormatName(dst_format) << (double_pixels ? ", doubled" : "") << (use_gamma ? ", gamma" : ""));
+
+					const uint16 *g = use_gamma ? gamma : nullptr;
+					SDL_Rect destination = { 0, 0, 2560, 1440 };
+
+					auto start = std::chrono::steady_clock::now();
+					present_reference(src, reference, double_pixels, g);
+					double reference_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+					start = std::chrono::steady_clock::now();
+					REQUIRE(present_world_pixels(src, fused, destination, double_pixels, false, false, 0, g, g, g, 4));
+					double fused_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+					CHECK(same_pixels(fused, reference));
+
+					WARN(SDL_GetPixelFormatName(src_format) << " to " << SDL_GetPixelFormatName(dst_format) << (double_pixels ? ", doubled" : "") << (use_gamma ? ", gamma" : "")
+						 << ": " << fused_seconds * 1000 << " ms, per pixel reference " << reference_seconds * 1000 << " ms");
+
+					SDL_FreeSurface(src);
+					SDL_FreeSurface(fused);
+					SDL_FreeSurface(reference);
+				}
+			}
+		}
+	}
+}
@@ -3,51 +3,14 @@
 #include "FileHandler.h"
 #include "shell_options.h"
 #include "interface.h"
+#include "game_state_hash.h"
+#include "replays.h"
 #include <catch2/catch_test_macros.hpp>
 
 extern ShellOptions shell_options;
 
-using Replay = std::pair<std::string, uint16_t>; //replay file path and seed
-
-static uint16_t get_seed_from_filename(const std::string& file_name) {
-	auto position = file_name.find_last_of('.');
-	auto name_without_ext = file_name.substr(0, position);
-	auto seed_position = name_without_ext.find_last_of('.');
-	if (seed_position == string::npos) throw std::exception();
-	return stoi(name_without_ext.substr(seed_position + 1));
-}
-
 #ifndef REPLAY_SET_SEED_FILENAME //enable and run this to set the correct file name with seed on new replay files
 
-static std::vector<Replay> get_replays(std::string& directory_path) {
-
-	FileSpecifier directory = directory_path;
-
-	std::vector<dir_entry> entries;
-	directory.ReadDirectory(entries);
-
-	std::vector<Replay> results;
-	for (std::vector<dir_entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
-
-		FileSpecifier entry = directory + it->name;
-		std::string entry_path = entry.GetPath();
-
-		if (entry.IsDir()) {
-			auto sub_replays = get_replays(entry_path);
-			results.insert(results.end(), sub_replays.begin(), sub_replays.end());
-		}
-		else
-		{
-			if (entry.GetType() != _typecode_film) continue;
-
-			auto seed = get_seed_from_filename(it->name);
-			results.push_back({ entry_path, seed });
-		}
-	}
-
-	return results;
-}
-
 TEST_CASE("Film replay", "[Replay]") {
 
 	REQUIRE(!shell_options.directory.empty());
@@ -64,6 +27,13 @@ TEST_CASE("Film replay", "[Replay]") {
 		main_event_loop();
 		auto seed = get_random_seed();
 		CHECK(seed == replay.second);
+
+		// films recorded with game state hashes say where they went wrong
+		game_state_hash expected, actual;
+		if (get_replay_game_state_divergence(expected, actual)) {
+			short section = compare_game_state_hashes(expected, actual);
+			FAIL_CHECK("out of sync by level " << actual.level << " tick " << actual.tick << ": " << get_game_state_hash_section_name(section) << " differ");
+		}
 	}
 
 	shutdown_application();
@@ -71,7 +41,7 @@ TEST_CASE("Film replay", "[Replay]") {
 
 #else
 
-static std::vector<std::string> get_replays(std::string& directory_path) {
+static std::vector<std::string> get_unseeded_replays(std::string& directory_path) {
 
 	FileSpecifier directory = directory_path;
 
@@ -85,7 +55,7 @@ static std::vector<std::string> get_replays(std::string& directory_path) {
 		std::string entry_path = entry.GetPath();
 
 		if (entry.IsDir()) {
-			auto sub_replays = get_replays(entry_path);
+			auto sub_replays = get_unseeded_replays(entry_path);
 			results.insert(results.end(), sub_replays.begin(), sub_replays.end());
 		}
 		else
@@ -109,7 +79,7 @@ TEST_CASE("Film replay set seed", "[Replay]") {
 	REQUIRE(!shell_options.directory.empty());
 	REQUIRE(!shell_options.replay_directory.empty());
 
-	const auto replays = get_replays(shell_options.replay_directory);
+	const auto replays = get_unseeded_replays(shell_options.replay_directory);
 
 	initialize_application();
 
@@ -0,0 +1,54 @@
+#ifndef TESTS_REPLAYS_H
+#define TESTS_REPLAYS_H
+
+#include "FileHandler.h"
+#include <string>
+#include <vector>
+
+using Replay = std::pair<std::string, uint16_t>; //replay file path and seed
+
+inline uint16_t get_seed_from_filename(const std::string& file_name) {
+	auto position = file_name.find_last_of('.');
+	auto name_without_ext = file_name.substr(0, position);
+	auto seed_position = name_without_ext.find_last_of('.');
+	if (seed_position == string::npos) throw std::exception();
+	return stoi(name_without_ext.substr(seed_position + 1));
+}
+
+inline std::vector<Replay> get_replays(std::string& directory_path) {
+
+	FileSpecifier directory = directory_path;
+
+	// a single film, so that films can be split across processes
+	if (!directory.IsDir()) {
+		std::string parent_path, file_name;
+		directory.SplitPath(parent_path, file_name);
+		return { { directory_path, get_seed_from_filename(file_name) } };
+	}
+
+	std::vector<dir_entry> entries;
+	directory.ReadDirectory(entries);
+
+	std::vector<Replay> results;
+	for (std::vector<dir_entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+
+		FileSpecifier entry = directory + it->name;
+		std::string entry_path = entry.GetPath();
+
+		if (entry.IsDir()) {
+			auto sub_replays = get_replays(entry_path);
+			results.insert(results.end(), sub_replays.begin(), sub_replays.end());
+		}
+		else
+		{
+			if (entry.GetType() != _typecode_film) continue;
+
+			auto seed = get_seed_from_filename(it->name);
+			results.push_back({ entry_path, seed });
+		}
+	}
+
+	return results;
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "shell.h"
+#include "map.h"
+#include "world.h"
+#include "shell_options.h"
+#include "interface.h"
+#include "TickProfiler.h"
+#include "replays.h"
+#include <catch2/catch_test_macros.hpp>
+#include <SDL2/SDL_hints.h>
+#include <chrono>
+#include <sstream>
+
+extern ShellOptions shell_options;
+
+struct SimulationThroughput {
+	uint64_t ticks = 0;
+	double seconds = 0;
+	uint64_t subsystem_microseconds[NUMBER_OF_WORLD_PROFILE_SECTIONS] = {};
+
+	void add(const SimulationThroughput& other) {
+		ticks += other.ticks;
+		seconds += other.seconds;
+		for (int i = 0; i < NUMBER_OF_WORLD_PROFILE_SECTIONS; i++) {
+			subsystem_microseconds[i] += other.subsystem_microseconds[i];
+		}
+	}
+
+	std::string report() const {
+		std::ostringstream s;
+		s << ticks << " ticks, " << ticks / seconds << " ticks/sec";
+		for (short i = 0; i < NUMBER_OF_WORLD_PROFILE_SECTIONS; i++) {
+			if (subsystem_microseconds[i] == 0) continue;
+			s << "\n  " << get_profile_section_name(i) << ": " << subsystem_microseconds[i] << " us, " << double(subsystem_microseconds[i]) / ticks << " us/tick";
+		}
+		return s.str();
+	}
+};
+
+// runs the film straight through the simulation; nothing is rendered and no interface is updated
+static SimulationThroughput simulate_replay() {
+
+	SimulationThroughput result;
+	reset_tick_profiler();
+
+	auto start = std::chrono::steady_clock::now();
+	while (get_game_state() == _game_in_progress && update_world_from_replay()) {
+		result.ticks++;
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for (short i = 0; i < NUMBER_OF_WORLD_PROFILE_SECTIONS; i++) {
+		result.subsystem_microseconds[i] = get_profile_section_microseconds(i);
+	}
+
+	return result;
+}
+
+// hidden by default: run with "[Simulation]" to print ticks/sec per film and per subsystem;
+// the replay directory may also be a single film, so tools/simulation_benchmark.sh can run films in parallel processes
+TEST_CASE("Simulation throughput", "[.][Benchmark][Simulation]") {
+
+	REQUIRE(!shell_options.directory.empty());
+	REQUIRE(!shell_options.replay_directory.empty());
+
+	const auto replays = get_replays(shell_options.replay_directory);
+
+	// nothing is drawn or played, so don't insist on a display or a sound card
+#ifdef SDL_HINT_VIDEODRIVER
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+#endif
+	shell_options.nogl = true;
+	shell_options.nosound = true;
+
+	initialize_application();
+	set_tick_profiler_enabled(true);
+
+	SimulationThroughput total;
+
+	for (const auto& replay : replays) {
+		INFO(replay.first);
+		REQUIRE(handle_open_document(replay.first));
+
+		auto film = simulate_replay();
+		total.add(film);
+
+		CHECK(get_random_seed() == replay.second);
+
+		// hand the finished film back to the interface to tear the game down
+		if (get_game_state() == _game_in_progress) {
+			set_game_state(_switch_demo);
+		}
+		main_event_loop();
+
+		WARN(replay.first << ": " << film.report());
+	}
+
+	set_tick_profiler_enabled(false);
+	shutdown_application();
+
+	WARN("total: " << total.report());
+}
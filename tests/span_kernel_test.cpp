@@ -0,0 +1,122 @@
+#include "cseries.h"
+#include "low_level_textures_simd.h"
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+// the scalar loops of low_level_textures.h for opaque pixels, which the kernels must match exactly
+template <typename T>
+static void horizontal_span_reference(T *write, const pixel8 *texture, const T *shading_table,
+	uint32 source_x, uint32 source_y, uint32 source_dx, uint32 source_dy, int count, int texbits) {
+
+	for (int i = 0; i < count; i++) {
+		write[i] = shading_table[texture[((source_y >> (32 - 2 * texbits)) & (((1 << texbits) - 1) << texbits)) + (source_x >> (32 - texbits))]];
+		source_x += source_dx, source_y += source_dy;
+	}
+}
+
+template <typename T>
+static void vertical_columns_x4_reference(T *write, int bytes_per_row, int count, int downshift,
+	pixel8 * const read[4], T * const shading_table[4], uint32 texture_y[4], const uint32 texture_dy[4]) {
+
+	for (; count > 0; --count) {
+		for (int column = 0; column < 4; column++) {
+			write[column] = shading_table[column][read[column][texture_y[column] >> downshift]];
+			texture_y[column] += texture_dy[column];
+		}
+		write = reinterpret_cast<T *>(reinterpret_cast<byte *>(write) + bytes_per_row);
+	}
+}
+
+template <typename T>
+static std::vector<T> random_shading_table(std::mt19937& random) {
+	std::vector<T> table(256);
+	for (T& entry : table) entry = static_cast<T>(random());
+	return table;
+}
+
+template <typename T>
+static void check_horizontal_spans(std::mt19937& random) {
+
+	std::vector<T> shading_table = random_shading_table<T>(random);
+
+	for (int texbits = 7; texbits <= 10; texbits++) {
+		std::vector<pixel8> texture(1 << (2 * texbits));
+		for (pixel8& texel : texture) texel = static_cast<pixel8>(random());
+
+		for (int trial = 0; trial < 200; trial++) {
+			int count = random() % 300;
+			uint32 source_x = random(), source_y = random(), source_dx = random(), source_dy = random();
+
+			// a guard pixel past the span catches stores that run over
+			std::vector<T> kernel(count + 1, 0), reference(count + 1, 0);
+			int done = texture_horizontal_span_simd(kernel.data(), texture.data(), shading_table.data(), source_x, source_y, source_dx, source_dy, count, texbits);
+			REQUIRE(done >= 0);
+			REQUIRE(done <= count);
+
+			// the caller finishes what the kernel leaves
+			horizontal_span_reference(kernel.data() + done, texture.data(), shading_table.data(), source_x + done * source_dx, source_y + done * source_dy, source_dx, source_dy, count - done, texbits);
+			horizontal_span_reference(reference.data(), texture.data(), shading_table.data(), source_x, source_y, source_dx, source_dy, count, texbits);
+
+			INFO("texbits " << texbits << ", " << count << " pixels");
+			REQUIRE(kernel == reference);
+		}
+	}
+}
+
+template <typename T>
+static void check_vertical_columns(std::mt19937& random) {
+
+	const int columns = 7; // more than four, so that stores outside the four show up
+	const int rows = 300;
+	const int bytes_per_row = columns * sizeof(T);
+
+	std::vector<T> shading_tables[4];
+	for (auto& table : shading_tables) table = random_shading_table<T>(random);
+	T * const shading_table[4] = { shading_tables[0].data(), shading_tables[1].data(), shading_tables[2].data(), shading_tables[3].data() };
+
+	for (int bits = 7; bits <= 10; bits++) {
+		std::vector<pixel8> textures[4];
+		for (auto& texture : textures) {
+			texture.resize(1 << bits);
+			for (pixel8& texel : texture) texel = static_cast<pixel8>(random());
+		}
+		pixel8 * const read[4] = { textures[0].data(), textures[1].data(), textures[2].data(), textures[3].data() };
+
+		for (int trial = 0; trial < 200; trial++) {
+			int count = random() % rows;
+			uint32 texture_y[4], texture_dy[4];
+			for (int column = 0; column < 4; column++) texture_y[column] = random(), texture_dy[column] = random();
+			uint32 kernel_y[4] = { texture_y[0], texture_y[1], texture_y[2], texture_y[3] };
+
+			std::vector<T> kernel(rows * columns, 0), reference(rows * columns, 0);
+			if (!texture_vertical_columns_x4_simd(kernel.data() + 1, bytes_per_row, count, 32 - bits, read, shading_table, kernel_y, texture_dy))
+				vertical_columns_x4_reference(kernel.data() + 1, bytes_per_row, count, 32 - bits, read, shading_table, kernel_y, texture_dy);
+			vertical_columns_x4_reference(reference.data() + 1, bytes_per_row, count, 32 - bits, read, shading_table, texture_y, texture_dy);
+
+			INFO(bits << " bits, " << count << " rows");
+			REQUIRE(kernel == reference);
+			for (int column = 0; column < 4; column++) REQUIRE(kernel_y[column] == texture_y[column]);
+		}
+	}
+}
+
+TEST_CASE("Span kernels match the scalar loops", "[Render]") {
+
+	const char *names[NUMBER_OF_SPAN_KERNELS] = { "scalar", "SSE2", "AVX2", "NEON" };
+	const short original = get_span_kernel();
+
+	for (short span_kernel = _span_kernel_scalar; span_kernel < NUMBER_OF_SPAN_KERNELS; span_kernel++) {
+		if (!set_span_kernel(span_kernel)) continue; // this CPU can't run it
+
+		INFO(names[span_kernel] << " kernels");
+		std::mt19937 random(span_kernel + 1);
+
+		check_horizontal_spans<pixel16>(random);
+		check_horizontal_spans<pixel32>(random);
+		check_vertical_columns<pixel16>(random);
+		check_vertical_columns<pixel32>(random);
+	}
+
+	set_span_kernel(original);
+}
@@ -0,0 +1,124 @@
+#include "shell.h"
+#include "map.h"
+#include "world.h"
+#include "shell_options.h"
+#include "interface.h"
+#include "world_snapshot.h"
+#include "replays.h"
+#include <catch2/catch_test_macros.hpp>
+#include <SDL2/SDL_hints.h>
+#include <chrono>
+#include <sstream>
+
+extern ShellOptions shell_options;
+
+// ticks between measurements, and rollbacks per measurement
+static const int SNAPSHOT_INTERVAL = 30;
+static const int SNAPSHOT_ROLLBACKS = 16;
+
+struct SnapshotCost {
+	uint64_t takes = 0;
+	uint64_t restores = 0;
+	double take_seconds = 0;
+	double restore_seconds = 0;
+	uint64_t copied_bytes = 0;
+	size_t largest_snapshot = 0;
+
+	void add(const SnapshotCost& other) {
+		takes += other.takes;
+		restores += other.restores;
+		take_seconds += other.take_seconds;
+		restore_seconds += other.restore_seconds;
+		copied_bytes += other.copied_bytes;
+		largest_snapshot = std::max(largest_snapshot, other.largest_snapshot);
+	}
+
+	std::string report() const {
+		std::ostringstream s;
+		s << largest_snapshot / 1024 << " KB snapshot, "
+		  << take_seconds * 1e6 / takes << " us/take, "
+		  << restore_seconds * 1e6 / restores << " us/restore, "
+		  << copied_bytes / (takes + restores) << " bytes copied on average";
+		return s.str();
+	}
+};
+
+template <typename F>
+static double seconds_taken(F f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// every so often, snapshots two consecutive ticks and flips the world between them; it
+// always ends up on the later one, so the film carries on as if nothing happened
+static SnapshotCost measure_replay() {
+
+	SnapshotCost cost;
+	WorldSnapshot before, after;
+
+	int ticks = 0;
+	while (get_game_state() == _game_in_progress && update_world_from_replay()) {
+		if (++ticks % SNAPSHOT_INTERVAL) continue;
+
+		cost.take_seconds += seconds_taken([&] { before.Take(); });
+		cost.copied_bytes += before.CopiedBytes();
+		if (!update_world_from_replay()) break;
+		cost.take_seconds += seconds_taken([&] { after.Take(); });
+		cost.copied_bytes += after.CopiedBytes();
+		cost.takes += 2;
+
+		for (int i = 0; i < SNAPSHOT_ROLLBACKS; i++) {
+			cost.restore_seconds += seconds_taken([&] { REQUIRE(before.Restore()); });
+			cost.copied_bytes += before.CopiedBytes();
+			cost.restore_seconds += seconds_taken([&] { REQUIRE(after.Restore()); });
+			cost.copied_bytes += after.CopiedBytes();
+			cost.restores += 2;
+		}
+
+		cost.largest_snapshot = std::max(cost.largest_snapshot, after.Size());
+	}
+
+	return cost;
+}
+
+// hidden by default: run with "[Snapshot]" to print the cost of taking and restoring world
+// snapshots on each film's levels; films must still finish in sync
+TEST_CASE("World snapshot cost", "[.][Benchmark][Snapshot]") {
+
+	REQUIRE(!shell_options.directory.empty());
+	REQUIRE(!shell_options.replay_directory.empty());
+
+	const auto replays = get_replays(shell_options.replay_directory);
+
+#ifdef SDL_HINT_VIDEODRIVER
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+#endif
+	shell_options.nogl = true;
+	shell_options.nosound = true;
+
+	initialize_application();
+
+	SnapshotCost total;
+
+	for (const auto& replay : replays) {
+		INFO(replay.first);
+		REQUIRE(handle_open_document(replay.first));
+
+		auto film = measure_replay();
+		total.add(film);
+
+		CHECK(get_random_seed() == replay.second);
+
+		if (get_game_state() == _game_in_progress) {
+			set_game_state(_switch_demo);
+		}
+		main_event_loop();
+
+		if (film.takes) WARN(replay.first << ": " << film.report());
+	}
+
+	shutdown_application();
+
+	if (total.takes) WARN("total: " << total.report());
+}
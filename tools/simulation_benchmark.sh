@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# Replays every film under a replay directory without a display or sound card,
+# one test process per film, and prints the simulation throughput of each.
+
+TESTS="$1"
+SCENARIO="$2"
+REPLAYS="$3"
+JOBS="${4:-$(getconf _NPROCESSORS_ONLN)}"
+
+if [[ ! -x "$TESTS" || ! -d "$SCENARIO" || ! -d "$REPLAYS" ]]; then
+  echo "Usage: $0 <tests-binary> <scenario-directory> <replay-directory> [jobs]"
+  exit 1
+fi
+
+export SDL_VIDEODRIVER=dummy
+export SDL_AUDIODRIVER=dummy
+
+find "$REPLAYS" -name '*.filA' -print0 | \
+  xargs -0 -P "$JOBS" -I {} \
+  sh -c 'out=$("$0" "$1" --replay-directory "$2" "[Simulation]" 2>&1); status=$?; printf "%s\n" "$out"; exit $status' \
+  "$TESTS" "$SCENARIO" {}